@@ -3,7 +3,10 @@
 //
 
 #include "ReseauGTFS.h"
-#include <sys/time.h>
+#include "parallele.h"
+#include "itineraire.h"
+#include <cmath>
+#include <set>
 
 using namespace std;
 
@@ -20,12 +23,12 @@ long tempsExecution(const timeval &tv1, const timeval &tv2)
 
 size_t ReseauGTFS::getNbArcsOrigineVersStations() const
 {
-    return m_nbArcsOrigineVersStations;
+    return m_requete.arcs.depuisOrigine.size();
 }
 
 size_t ReseauGTFS::getNbArcsStationsVersDestination() const
 {
-    return m_nbArcsStationsVersDestination;
+    return m_requete.arcs.versDestination.size();
 }
 
 size_t ReseauGTFS::getNbArcs() const
@@ -33,178 +36,991 @@ size_t ReseauGTFS::getNbArcs() const
     return m_leGraphe.getNbArcs();
 }
 
+//! \brief retourne une estimation du nombre d'octets occupés par le graphe et les correspondances arrêt-sommet
+//! \brief les objets Arret eux-mêmes appartiennent à DonneesGTFS et ne sont pas comptés
+size_t ReseauGTFS::getTailleMemoire() const
+{
+    return m_leGraphe.getTailleMemoire()
+           + m_arretDuSommet.capacity() * sizeof(Arret::Ptr)
+           + m_sommetDeArret.bucket_count() * sizeof(void *)
+           + m_sommetDeArret.size() * (sizeof(Arret::Ptr) + sizeof(size_t) + sizeof(void *))
+           + m_ligneDuSommet.capacity() * sizeof(uint32_t)
+           + m_sommetsLibres.capacity() * sizeof(size_t)
+           + (m_hierarchie ? m_hierarchie->getTailleMemoire() : 0)
+           + (m_grapheCompact ? m_grapheCompact->getTailleMemoire() : 0)
+           + getTailleMemoireReperes()
+           + (m_grapheTranspose ? m_grapheTranspose->getTailleMemoire() : 0);
+}
+
 double ReseauGTFS::getDistMaxMarche() const
 {
     return distanceMaxMarche;
 }
 
+//! \brief renumérote les sommets du graphe par station, puis par heure d'arrivée à la station
+//! \brief Les sommets sont d'abord numérotés dans l'ordre des voyages; les arcs d'attente et de transfert relient
+//! \brief alors des sommets éloignés en mémoire. Après la renumérotation, les arrêts d'une même station sont contigus.
+//! \post m_leGraphe, m_arretDuSommet, m_sommetDeArret et m_ligneDuSommet utilisent les nouveaux numéros, de même que la requête courante
+//! \post les sommets libérés par avancerFenetre() sont placés à la fin, puis retirés du graphe
+//! \post les requêtes obtenues de preparerRequete() avant l'appel ne sont plus valides
+//! \post la hiérarchie de contraction, le graphe compact, les repères ALT et le graphe transposé, s'ils existent, sont reconstruits
+void ReseauGTFS::renumeroterSommets()
+{
+    vector<size_t> ordre(m_arretDuSommet.size());
+    vector<string> stationDuSommet(m_arretDuSommet.size());
+    for (size_t i = 0; i < ordre.size(); ++i)
+    {
+        ordre[i] = i;
+        if (m_arretDuSommet[i]) stationDuSommet[i] = m_arretDuSommet[i]->getStationId();
+    }
+    stable_sort(ordre.begin(), ordre.end(), [&](size_t a, size_t b)
+    {
+        if (!m_arretDuSommet[a] || !m_arretDuSommet[b]) return m_arretDuSommet[a] && !m_arretDuSommet[b];
+        if (stationDuSommet[a] != stationDuSommet[b]) return stationDuSommet[a] < stationDuSommet[b];
+        return m_arretDuSommet[a]->getHeureArrivee() < m_arretDuSommet[b]->getHeureArrivee();
+    });
+
+    vector<size_t> nouveauNumero(ordre.size());
+    vector<Arret::Ptr> arretDuSommet(ordre.size());
+    vector<uint32_t> ligneDuSommet(ordre.size());
+    for (size_t i = 0; i < ordre.size(); ++i)
+    {
+        nouveauNumero[ordre[i]] = i;
+        arretDuSommet[i] = m_arretDuSommet[ordre[i]];
+        ligneDuSommet[i] = m_ligneDuSommet[ordre[i]];
+        if (arretDuSommet[i]) m_sommetDeArret[arretDuSommet[i]] = i;
+    }
+    m_leGraphe.renumeroter(nouveauNumero);
+    m_arretDuSommet.swap(arretDuSommet);
+    m_ligneDuSommet.swap(ligneDuSommet);
+
+    const size_t nbSommets = m_arretDuSommet.size() - m_sommetsLibres.size();
+    m_leGraphe.resize(nbSommets);
+    m_arretDuSommet.resize(nbSommets);
+    m_ligneDuSommet.resize(nbSommets);
+    m_sommetsLibres.clear();
+
+    ++m_generation;
+    if (m_origine_dest_ajoute)
+    {
+        for (auto &arc : m_requete.arcs.depuisOrigine) arc.first = nouveauNumero[arc.first];
+        for (auto &arc : m_requete.arcs.versDestination) arc.first = nouveauNumero[arc.first];
+    }
+    if (m_hierarchie) construireHierarchieContraction();
+    if (m_grapheCompact) compacterGraphe(m_grapheCompact->getEncodage());
+    if (m_reperes) reconstruireReperes(0);
+    if (m_grapheTranspose) construireGrapheTranspose();
+}
+
+//! \brief enlève les arcs d'attente et de transfert (ou autres) rendus inutiles par un chemin d'au plus deux arcs aussi court
+//! \brief Chaque arrêt est relié au premier départ de chaque ligne; le départ suivant d'une même ligne est souvent
+//! \brief déjà atteint en passant par un arrêt intermédiaire. Voir Graphe::elaguerArcsDomines().
+//! \brief Aucun sommet n'est enlevé: chacun peut recevoir un arc du point origine ou mener au point destination.
+//! \return le nombre d'arcs enlevés
+//! \post les temps de trajet de toutes les requêtes sont inchangés; à temps égal, l'itinéraire affiché peut différer
+//! \post la hiérarchie de contraction, le graphe compact, les repères ALT et le graphe transposé, s'ils existent, sont reconstruits
+size_t ReseauGTFS::elaguerArcsDomines()
+{
+    size_t nbEnleves = m_leGraphe.elaguerArcsDomines();
+    ++m_generation;
+    if (m_hierarchie) construireHierarchieContraction();
+    if (m_grapheCompact) compacterGraphe(m_grapheCompact->getEncodage());
+    if (m_reperes) reconstruireReperes(0);
+    if (m_grapheTranspose) construireGrapheTranspose();
+    return nbEnleves;
+}
+
+//! \brief déplace la fenêtre du réseau de p_secondes sans reconstruire le graphe
+//! \brief Les arrêts partant avant le nouveau début sont enlevés avec leurs arcs; leurs sommets sont réutilisés par
+//! \brief les arrêts arrivant entre l'ancienne et la nouvelle fin. Seuls les arcs touchant ces arrêts sont examinés:
+//! \brief - un arc vers un arrêt enlevé ne peut venir que d'un arrêt enlevé ou d'un arrêt arrivé avant le nouveau début
+//! \brief   mais pas encore reparti (autobus immobilisé); les arcs de ces derniers sont recalculés
+//! \brief - un arrêt ajouté arrive après tous les arrêts déjà présents; il reçoit l'arc de l'arrêt précédent de son
+//! \brief   voyage, et un arc d'attente ou de transfert de chaque arrêt pour lequel il est le premier départ de sa ligne
+//! \param[in] p_gtfs: l'objet DonneesGTFS ayant servi à construire le réseau
+//! \param[in] p_secondes: le déplacement du début et de la fin de la fenêtre
+//! \post le graphe a les mêmes arcs qu'un réseau construit pour la nouvelle fenêtre, à la numérotation des sommets près
+//! \post les requêtes obtenues de preparerRequete() avant l'appel ne sont plus valides; la requête courante est enlevée
+//! \post la hiérarchie de contraction, le graphe compact, les repères ALT et le graphe transposé, s'ils existent, sont reconstruits
+//! \throws logic_error si la nouvelle fenêtre dépasse l'intervalle de temps de p_gtfs
+void ReseauGTFS::avancerFenetre(const DonneesGTFS &p_gtfs, unsigned int p_secondes)
+{
+    const Heure nouveauDebut = m_debutFenetre.add_secondes(p_secondes);
+    const Heure nouvelleFin = m_finFenetre.add_secondes(p_secondes);
+    if (nouvelleFin > p_gtfs.getTempsFin())
+        throw logic_error("ReseauGTFS::avancerFenetre(): la nouvelle fenêtre dépasse l'intervalle de temps du GTFS");
+    if (p_secondes == 0) return;
+    if (m_origine_dest_ajoute) enleverArcsOrigineDestination();
+    ++m_generation;
+
+    //arrêts sortants (départ avant le nouveau début) et arrêts immobilisés (arrivée avant le nouveau début)
+    vector<size_t> aRecalculer;
+    set<const string *> stationsModifiees;
+    for (const auto &station : p_gtfs.getStations())
+    {
+        auto finSortants = station.second.getArrets().lower_bound(nouveauDebut);
+        for (auto arret = premierArretDansFenetre(station.second); arret != finSortants; ++arret)
+        {
+            if (!dansFenetre(*arret->second)) continue;
+            const size_t sommet = m_sommetDeArret.at(arret->second);
+            if (arret->second->getHeureDepart() < nouveauDebut)
+            {
+                enleverSommet(sommet);
+                stationsModifiees.insert(&station.first);
+            }
+            else
+                aRecalculer.push_back(sommet);
+        }
+    }
+    const Heure ancienneFin = m_finFenetre;
+    m_debutFenetre = nouveauDebut;
+    m_finFenetre = nouvelleFin;
+
+    //arrêts entrants, par station et par heure d'arrivée, et dernière arrivée de chaque ligne parmi les arrêts restants
+    struct Entrants
+    {
+        const string *stationId;
+        vector<size_t> sommets;
+        unordered_map<uint32_t, Heure> derniereArriveeDeLigne;
+    };
+    vector<Entrants> entrants;
+    for (const auto &station : p_gtfs.getStations())
+    {
+        auto &arrets = station.second.getArrets();
+        auto debutEntrants = arrets.lower_bound(ancienneFin);
+        auto finEntrants = arrets.lower_bound(nouvelleFin);
+        Entrants e{&station.first, {}, {}};
+        for (auto arret = debutEntrants; arret != finEntrants; ++arret)
+            if (dansFenetre(*arret->second)) e.sommets.push_back(ajouterSommet(p_gtfs, arret->second));
+        if (e.sommets.empty()) continue;
+        for (auto arret = premierArretDansFenetre(station.second); arret != arrets.end() && arret->first < ancienneFin; ++arret)
+        {
+            if (!dansFenetre(*arret->second)) continue;
+            auto res = e.derniereArriveeDeLigne.insert({m_ligneDuSommet[m_sommetDeArret.at(arret->second)], arret->first});
+            if (res.first->second < arret->first) res.first->second = arret->first;
+        }
+        stationsModifiees.insert(&station.first);
+        entrants.push_back(std::move(e));
+    }
+
+    //arcs de voyage vers les arrêts entrants
+    for (const auto &e : entrants)
+        for (size_t sommet : e.sommets)
+        {
+            const Arret::Ptr &arret = m_arretDuSommet[sommet];
+            const auto &arretsDuVoyage = p_gtfs.getVoyages().at(arret->getVoyageId()).getArrets();
+            auto position = arretsDuVoyage.find(arret);
+            if (position == arretsDuVoyage.begin()) continue;
+            auto precedent = m_sommetDeArret.find(*--position);
+            if (precedent != m_sommetDeArret.end())
+                m_leGraphe.ajouterArc(precedent->second, sommet, arret->getHeureArrivee() - (*position)->getHeureArrivee());
+        }
+
+    //arcs d'attente et de transfert vers les arrêts entrants: (station de départ, délai) de chaque station d'arrivée
+    unordered_map<string, vector<pair<const string *, unsigned int> > > reglesVers;
+    for (const auto &transfert : m_transferts)
+        reglesVers[get<1>(transfert)].push_back({&get<0>(transfert), get<2>(transfert)});
+    vector<unsigned int> ligneDejaUtilisee(m_nbNumerosDeLigne, 0); //voir ajouterArcsTransferts()
+    unsigned int epoque = 0;
+    for (const auto &e : entrants)
+    {
+        vector<pair<const string *, unsigned int> > regles;
+        auto it = reglesVers.find(*e.stationId);
+        if (it != reglesVers.end()) regles = it->second;
+        if (p_gtfs.getStationsDeTransfert().find(*e.stationId) == p_gtfs.getStationsDeTransfert().end())
+            regles.push_back({e.stationId, delaisMinArcsAttente});
+        const Heure derniereEntree = m_arretDuSommet[e.sommets.back()]->getHeureArrivee();
+
+        for (const auto &regle : regles)
+        {
+            const Station &stationOrigine = p_gtfs.getStations().at(*regle.first);
+            auto finOrigines = stationOrigine.getArrets().upper_bound(derniereEntree);
+            for (auto arretOrigine = premierArretDansFenetre(stationOrigine); arretOrigine != finOrigines; ++arretOrigine)
+            {
+                if (!dansFenetre(*arretOrigine->second)) continue;
+                const Heure premierDepart = arretOrigine->first.add_secondes(regle.second);
+                if (derniereEntree < premierDepart) continue;
+                const size_t sommetOrigine = m_sommetDeArret.at(arretOrigine->second);
+                ++epoque;
+                ligneDejaUtilisee[m_ligneDuSommet[sommetOrigine]] = epoque;
+                for (size_t sommetDestination : e.sommets)
+                {
+                    const Heure &arrivee = m_arretDuSommet[sommetDestination]->getHeureArrivee();
+                    if (arrivee < premierDepart) continue;
+                    const uint32_t ligne = m_ligneDuSommet[sommetDestination];
+                    if (ligneDejaUtilisee[ligne] == epoque) continue;
+                    ligneDejaUtilisee[ligne] = epoque;
+                    auto derniere = e.derniereArriveeDeLigne.find(ligne);
+                    if (derniere != e.derniereArriveeDeLigne.end() && derniere->second >= premierDepart)
+                        continue; //un arrêt restant de la même ligne est un départ plus hâtif
+                    m_leGraphe.ajouterArc(sommetOrigine, sommetDestination, arrivee - arretOrigine->first);
+                }
+            }
+        }
+    }
+
+    for (size_t sommet : aRecalculer)
+        recalculerArcsCorrespondance(p_gtfs, sommet);
+    for (const string *stationId : stationsModifiees)
+        m_nbLignesDeStation[*stationId] = compterLignes(p_gtfs.getStations().at(*stationId));
+
+    if (m_hierarchie) construireHierarchieContraction();
+    if (m_grapheCompact) compacterGraphe(m_grapheCompact->getEncodage());
+    if (m_reperes) reconstruireReperes(0);
+    if (m_grapheTranspose) construireGrapheTranspose();
+}
+
+//! \brief remplace les arcs sortant d'un sommet par ceux que construirait le réseau pour la fenêtre courante
+//! \brief (arc de voyage vers l'arrêt suivant, puis arcs de transfert et d'attente vers le premier départ de chaque ligne)
+void ReseauGTFS::recalculerArcsCorrespondance(const DonneesGTFS &p_gtfs, size_t p_sommet)
+{
+    for (const auto &arc : m_leGraphe.getArcs(p_sommet))
+        m_leGraphe.enleverArc(p_sommet, arc.first);
+
+    const Arret::Ptr &arret = m_arretDuSommet[p_sommet];
+    const auto &arretsDuVoyage = p_gtfs.getVoyages().at(arret->getVoyageId()).getArrets();
+    auto suivant = arretsDuVoyage.find(arret);
+    if (++suivant != arretsDuVoyage.end() && dansFenetre(**suivant))
+        m_leGraphe.ajouterArc(p_sommet, m_sommetDeArret.at(*suivant), (*suivant)->getHeureArrivee() - arret->getHeureArrivee());
+
+    vector<pair<string, unsigned int> > regles;
+    for (const auto &transfert : m_transferts)
+        if (get<0>(transfert) == arret->getStationId()) regles.push_back({get<1>(transfert), get<2>(transfert)});
+    if (p_gtfs.getStationsDeTransfert().find(arret->getStationId()) == p_gtfs.getStationsDeTransfert().end())
+        regles.push_back({arret->getStationId(), delaisMinArcsAttente});
+
+    vector<bool> ligneDejaUtilisee(m_nbNumerosDeLigne, false);
+    for (const auto &regle : regles)
+    {
+        fill(ligneDejaUtilisee.begin(), ligneDejaUtilisee.end(), false);
+        ligneDejaUtilisee[m_ligneDuSommet[p_sommet]] = true;
+        const auto &arrets = p_gtfs.getStations().at(regle.first).getArrets();
+        for (auto destination = arrets.lower_bound(arret->getHeureArrivee().add_secondes(regle.second));
+             destination != arrets.end() && destination->first < m_finFenetre; ++destination)
+        {
+            if (!dansFenetre(*destination->second)) continue;
+            const size_t sommetDestination = m_sommetDeArret.at(destination->second);
+            if (ligneDejaUtilisee[m_ligneDuSommet[sommetDestination]]) continue;
+            ligneDejaUtilisee[m_ligneDuSommet[sommetDestination]] = true;
+            m_leGraphe.ajouterArc(p_sommet, sommetDestination, destination->first - arret->getHeureArrivee());
+        }
+    }
+}
+
+//! \brief retourne le numéro de la version du graphe, incrémenté par chaque méthode qui modifie ses arcs ou ses sommets
+//! \brief un résultat mémorisé pour une génération (voir CacheItineraires) n'est plus valide pour une autre
+unsigned long ReseauGTFS::getGeneration() const
+{
+    return m_generation;
+}
+
+Heure ReseauGTFS::getDebutFenetre() const
+{
+    return m_debutFenetre;
+}
+
+Heure ReseauGTFS::getFinFenetre() const
+{
+    return m_finFenetre;
+}
+
+//! \brief écrit le réseau construit dans un fichier binaire versionné, que ReseauProjete ouvre sans reconstruire le graphe
+//! \brief Le fichier contient le graphe, la correspondance sommet-arrêt et les tables de stations, de voyages et de
+//! \brief numéros de ligne qu'utilise l'affichage de l'itinéraire; la hiérarchie de contraction n'y est pas écrite
+//! \param[in] p_gtfs: l'objet DonneesGTFS ayant servi à construire le réseau
+//! \param[in] p_nomFichier: le fichier à créer (ou à remplacer)
+//! \throws logic_error si le réseau est trop grand pour des indices de 32 bits ou si le fichier ne peut être écrit
+//! \throws logic_error si la fenêtre du réseau n'est pas l'intervalle de temps de p_gtfs (voir avancerFenetre())
+void ReseauGTFS::ecrireBinaire(const DonneesGTFS &p_gtfs, const std::string &p_nomFichier) const
+{
+    if (!(m_debutFenetre == p_gtfs.getTempsDebut()) || !(m_finFenetre == p_gtfs.getTempsFin()))
+        throw logic_error("ReseauGTFS::ecrireBinaire(): la fenêtre du réseau doit être l'intervalle de temps du GTFS");
+    const size_t n = m_arretDuSommet.size();
+    if (n >= numeric_limits<uint32_t>::max() || m_leGraphe.getNbArcs() >= numeric_limits<uint32_t>::max())
+        throw logic_error("ReseauGTFS::ecrireBinaire(): le réseau est trop grand pour le format du fichier");
+
+    ReseauProjete::Tables tables;
+    tables.tempsDebut = static_cast<uint32_t>(p_gtfs.getTempsDebut() - Heure(0, 0, 0));
+    tables.tempsFin = static_cast<uint32_t>(p_gtfs.getTempsFin() - Heure(0, 0, 0));
+    auto ajouterChaine = [&tables](const string &p_chaine)
+    {
+        const uint32_t position = static_cast<uint32_t>(tables.chaines.size());
+        tables.chaines.insert(tables.chaines.end(), p_chaine.begin(), p_chaine.end());
+        tables.chaines.push_back('\0');
+        return position;
+    };
+
+    tables.debutArcs.push_back(0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (const auto &arc : m_leGraphe.getArcs(i))
+            tables.arcs.push_back({static_cast<uint32_t>(arc.first), arc.second});
+        tables.debutArcs.push_back(static_cast<uint32_t>(tables.arcs.size()));
+    }
+
+    unordered_map<string, uint32_t> indiceDeStation;
+    for (const auto &station : p_gtfs.getStations())
+    {
+        indiceDeStation[station.first] = static_cast<uint32_t>(tables.stations.size());
+        tables.stations.push_back({station.second.getCoords().getLatitude(), station.second.getCoords().getLongitude(),
+                                   ajouterChaine(station.first), ajouterChaine(station.second.getNom()),
+                                   static_cast<uint32_t>(tables.sommetsDesStations.size()),
+                                   static_cast<uint32_t>(m_nbLignesDeStation.at(station.first))});
+        for (const auto &arret : station.second.getArrets())
+            tables.sommetsDesStations.push_back(static_cast<uint32_t>(m_sommetDeArret.at(arret.second)));
+    }
+
+    unordered_map<string, uint32_t> indiceDeVoyage;
+    for (const auto &voyage : p_gtfs.getVoyages())
+    {
+        indiceDeVoyage[voyage.first] = static_cast<uint32_t>(tables.voyages.size());
+        tables.voyages.push_back({ajouterChaine(voyage.second.getDestination()), 0});
+    }
+
+    tables.numerosDeLigne.assign(m_nbNumerosDeLigne, numeric_limits<uint32_t>::max());
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Arret::Ptr &arret = m_arretDuSommet[i];
+        const uint32_t voyage = indiceDeVoyage.at(arret->getVoyageId());
+        tables.stationDuSommet.push_back(indiceDeStation.at(arret->getStationId()));
+        tables.voyageDuSommet.push_back(voyage);
+        tables.heureDuSommet.push_back(static_cast<uint32_t>(arret->getHeureArrivee() - Heure(0, 0, 0)));
+        tables.voyages[voyage].numeroDeLigne = m_ligneDuSommet[i];
+        if (tables.numerosDeLigne[m_ligneDuSommet[i]] == numeric_limits<uint32_t>::max())
+            tables.numerosDeLigne[m_ligneDuSommet[i]] = ajouterChaine(
+                    p_gtfs.getLignes().at(p_gtfs.getVoyages().at(arret->getVoyageId()).getLigne()).getNumero());
+    }
+
+    ReseauProjete::ecrire(p_nomFichier, tables);
+}
+
+//! \brief construit la hiérarchie de contraction du graphe; les requêtes de itineraire() l'utilisent ensuite
+//! \post m_hierarchie donne les mêmes temps de trajet que m_leGraphe, qui n'est pas modifié
+void ReseauGTFS::construireHierarchieContraction()
+{
+    //les heures des arrêts guident la recherche arrière: chaque arc dure exactement l'écart de ses heures
+    vector<unsigned int> heures;
+    heures.reserve(m_arretDuSommet.size());
+    //un sommet libéré par avancerFenetre() n'a aucun arc: son heure n'est jamais consultée
+    for (const auto &arret : m_arretDuSommet)
+        heures.push_back(arret ? static_cast<unsigned int>(arret->getHeureArrivee() - Heure(0, 0, 0)) : 0);
+    m_hierarchie.reset(new HierarchieContraction(m_leGraphe, heures));
+}
+
+//! \brief retourne le nombre de raccourcis de la hiérarchie de contraction (0 si elle n'a pas été construite)
+size_t ReseauGTFS::getNbRaccourcis() const
+{
+    return m_hierarchie ? m_hierarchie->getNbRaccourcis() : 0;
+}
+
+//! \brief construit une copie compacte du graphe; les recherches de itineraire() et itinerairesEnLot() l'utilisent
+//! \brief ensuite (sauf si la hiérarchie de contraction existe, itineraire() lui donnant priorité)
+//! \param[in] p_encodage: l'encodage des arcs (voir GrapheCompact)
+//! \post m_grapheCompact donne les mêmes temps de trajet que m_leGraphe, qui n'est pas modifié
+void ReseauGTFS::compacterGraphe(GrapheCompact::Encodage p_encodage)
+{
+    m_grapheCompact.reset(new GrapheCompact(m_leGraphe, p_encodage));
+}
+
+//! \brief libère le graphe compact; les recherches utilisent à nouveau les listes d'adjacence
+void ReseauGTFS::abandonnerGrapheCompact()
+{
+    m_grapheCompact.reset();
+}
+
+//! \brief choisit des repères ALT et précalcule leurs distances; les requêtes de itineraire() sont ensuite guidées (A*)
+//! \brief par les bornes qu'ils donnent (sauf si la hiérarchie de contraction existe, itineraire() lui donnant priorité)
+//! \brief Les repères sont des stations terminus de voyages, choisies une à une le plus loin possible des précédentes
+//! \brief (la première le plus loin du centre des terminus): les bornes sont meilleures pour les trajets qui s'éloignent
+//! \brief du centre, vers le repère, ou qui en reviennent. Les distances sont celles entre stations (voir ReperesALT).
+//! \param[in] p_nbReperes: le nombre de repères (au plus le nombre de stations terminus)
+//! \param[in] p_nbFils: le nombre de fils d'exécution (0 pour utiliser thread::hardware_concurrency())
+//! \post m_reperes donne les mêmes temps de trajet que m_leGraphe, qui n'est pas modifié
+void ReseauGTFS::construireReperes(const DonneesGTFS &p_gtfs, size_t p_nbReperes, unsigned int p_nbFils)
+{
+    set<string> terminus;
+    for (const auto &voyage : p_gtfs.getVoyages())
+    {
+        if (voyage.second.getArrets().empty()) continue;
+        const Arret::Ptr &dernier = *voyage.second.getArrets().rbegin();
+        if (m_sommetDeArret.count(dernier)) terminus.insert(dernier->getStationId());
+    }
+    vector<Coordonnees> coords;
+    vector<string> ids(terminus.begin(), terminus.end());
+    double latitude = 0;
+    double longitude = 0;
+    for (const string &id : ids)
+    {
+        coords.push_back(p_gtfs.getStations().at(id).getCoords());
+        latitude += coords.back().getLatitude() / ids.size();
+        longitude += coords.back().getLongitude() / ids.size();
+    }
+
+    //distance de chaque terminus au plus proche repère choisi (au centre, avant le premier choix)
+    vector<double> distanceAuxReperes;
+    for (const Coordonnees &c : coords)
+    {
+        double d = c - Coordonnees(latitude, longitude);
+        distanceAuxReperes.push_back(std::isnan(d) ? 0 : d);
+    }
+    m_stationsReperes.clear();
+    while (m_stationsReperes.size() < min(p_nbReperes, ids.size()))
+    {
+        size_t choix = max_element(distanceAuxReperes.begin(), distanceAuxReperes.end()) - distanceAuxReperes.begin();
+        m_stationsReperes.push_back(ids[choix]);
+        for (size_t i = 0; i < coords.size(); ++i)
+        {
+            double d = coords[i] - coords[choix];
+            distanceAuxReperes[i] = min(distanceAuxReperes[i], std::isnan(d) ? 0 : d);
+        }
+    }
+    reconstruireReperes(p_nbFils);
+}
+
+//! \brief calcule les repères des stations de m_stationsReperes pour le graphe courant (après une modification du graphe)
+void ReseauGTFS::reconstruireReperes(unsigned int p_nbFils)
+{
+    unordered_map<string, uint32_t> classeDeStation;
+    vector<uint32_t> classeDuSommet;
+    classeDuSommet.reserve(m_arretDuSommet.size());
+    for (const auto &arret : m_arretDuSommet)
+    {
+        if (!arret)
+        {
+            classeDuSommet.push_back(ReperesALT::aucune);
+            continue;
+        }
+        auto insertion = classeDeStation.insert({arret->getStationId(), (uint32_t) classeDeStation.size()});
+        classeDuSommet.push_back(insertion.first->second);
+    }
+    vector<uint32_t> reperes;
+    for (const string &id : m_stationsReperes)
+    {
+        auto it = classeDeStation.find(id);
+        if (it != classeDeStation.end()) reperes.push_back(it->second); //une station sortie de la fenêtre est ignorée
+    }
+    m_reperes.reset(new ReperesALT(m_leGraphe, classeDuSommet, reperes, p_nbFils));
+}
+
+//! \brief libère les repères ALT; les recherches ne sont plus guidées
+void ReseauGTFS::abandonnerReperes()
+{
+    m_reperes.reset();
+    m_stationsReperes.clear();
+}
+
+//! \brief retourne le nombre d'octets des repères ALT (0 s'ils n'ont pas été construits)
+size_t ReseauGTFS::getTailleMemoireReperes() const
+{
+    return m_reperes ? m_reperes->getTailleMemoire() : 0;
+}
+
+//! \brief retourne le nombre de sommets solutionnés par la recherche d'une requête, pour comparer les recherches
+//! \brief La recherche est celle de itineraire(), sans la hiérarchie de contraction (qui ne les compte pas)
+size_t ReseauGTFS::getNbSommetsSolutionnes(const Requete &p_requete) const
+{
+    vector<size_t> chemin;
+    if (m_reperes)
+    {
+        ReperesALT::EtatRecherche etat;
+        m_reperes->plusCourtChemin(m_leGraphe, p_requete.arcs, chemin, etat);
+        return etat.nbSommetsSolutionnes;
+    }
+    Graphe::EtatRecherche etat;
+    if (m_grapheCompact) m_grapheCompact->plusCourtChemin(p_requete.arcs, chemin, etat);
+    else m_leGraphe.plusCourtChemin(p_requete.arcs, chemin, etat);
+    return etat.nbSommetsSolutionnes;
+}
+
+//! \brief retourne le nombre d'octets du graphe parcouru par les recherches: le graphe compact s'il existe, sinon les listes d'adjacence
+size_t ReseauGTFS::getTailleMemoireGraphe() const
+{
+    return m_grapheCompact ? m_grapheCompact->getTailleMemoire() : m_leGraphe.getTailleMemoire();
+}
+
+//! \brief retourne le graphe espace-temps, sans les arcs d'aucune requête (voir Requete)
+//! \brief sert par exemple à en faire une copie GrapheGenerique d'autres types d'indices, de poids ou de stockage
+const Graphe &ReseauGTFS::getGraphe() const
+{
+    return m_leGraphe;
+}
+
 //! \brief construit le réseau GTFS à partir des données GTFS
 //! \param[in] Un objet DonneesGTFS
+//! \param[in] p_nbFils: le nombre de fils d'exécution générant les arcs de transfert et d'attente (0 pour utiliser
+//! \param[in] thread::hardware_concurrency()); le graphe obtenu est le même quel que soit ce nombre
+//! \param[in] p_transfertsAPied: des transferts à ajouter à ceux de p_gtfs, par exemple ceux de genererTransfertsAPied()
+//! \post la fenêtre du réseau est l'intervalle [p_gtfs.getTempsDebut(), p_gtfs.getTempsFin()): tous les arrêts sont inclus
+ReseauGTFS::ReseauGTFS(const DonneesGTFS &p_gtfs, unsigned int p_nbFils, const Transferts &p_transfertsAPied)
+        : ReseauGTFS(p_gtfs, p_gtfs.getTempsDebut(), p_gtfs.getTempsFin(), p_nbFils, p_transfertsAPied)
+{
+}
+
+//! \brief construit le réseau GTFS des seuls arrêts d'une fenêtre de temps, qu'avancerFenetre() pourra déplacer
+//! \brief p_gtfs sert alors de réservoir: il est lu une seule fois, pour une fenêtre plus longue (typiquement la journée)
+//! \param[in] p_gtfs: un objet DonneesGTFS, qui doit survivre au réseau
+//! \param[in] p_debutFenetre: seuls les arrêts partant à partir de cette heure sont inclus
+//! \param[in] p_finFenetre: seuls les arrêts arrivant avant cette heure sont inclus
+//! \param[in] p_nbFils: le nombre de fils d'exécution générant les arcs de transfert et d'attente (0 pour utiliser
+//! \param[in] thread::hardware_concurrency()); le graphe obtenu est le même quel que soit ce nombre
+//! \param[in] p_transfertsAPied: des transferts à ajouter à ceux de p_gtfs, par exemple ceux de genererTransfertsAPied()
 //! \post constuit un réseau GTFS représenté par un graphe orienté pondéré avec poids non négatifs
 //! \post initialise la variable m_origine_dest_ajoute à false car les points origine et destination ne font pas parti du graphe
 //! \post insère les données requises dans m_arretDuSommet et m_sommetDeArret et construit le graphe m_leGraphe
-ReseauGTFS::ReseauGTFS(const DonneesGTFS &p_gtfs)
-        : m_leGraphe(p_gtfs.getNbArrets()), m_origine_dest_ajoute(false)
+//! \post m_ligneDuSommet donne le numéro de ligne de chaque sommet sous forme d'entier
+//! \post m_nbLignesDeStation contient le nombre de numéros de ligne distincts de chaque station
+//! \post m_indexStations référence les stations de p_gtfs, qui doit survivre au réseau
+//! \post le graphe est identique à celui construit à partir de données GTFS chargées pour l'intervalle de la fenêtre
+//! \throws logic_error si la fenêtre n'est pas incluse dans [p_gtfs.getTempsDebut(), p_gtfs.getTempsFin()]
+ReseauGTFS::ReseauGTFS(const DonneesGTFS &p_gtfs, const Heure &p_debutFenetre, const Heure &p_finFenetre,
+                       unsigned int p_nbFils, const Transferts &p_transfertsAPied)
+        : m_leGraphe(0), m_nbNumerosDeLigne(0), m_origine_dest_ajoute(false),
+          m_indexStations(p_gtfs.getStations(), distanceMaxMarche / 2),
+          m_debutFenetre(p_debutFenetre), m_finFenetre(p_finFenetre), m_dureeMaxArret(0),
+          m_transferts(p_gtfs.getTransferts()), m_generation(0)
 {
-    //Le graphe possède p_gtfs.getNbArrets() sommets, mais il n'a pas encore d'arcs
+    if (p_debutFenetre < p_gtfs.getTempsDebut() || p_finFenetre > p_gtfs.getTempsFin() || p_finFenetre < p_debutFenetre)
+        throw logic_error("ReseauGTFS: la fenêtre doit être incluse dans l'intervalle de temps du GTFS");
+    m_transferts.insert(m_transferts.end(), p_transfertsAPied.begin(), p_transfertsAPied.end());
+    for (const auto &voyage : p_gtfs.getVoyages())
+        for (const auto &arret : voyage.second.getArrets())
+            m_dureeMaxArret = max(m_dureeMaxArret,
+                                  static_cast<unsigned int>(arret->getHeureDepart() - arret->getHeureArrivee()));
+
+    //Le graphe reçoit un sommet par arrêt de la fenêtre; les arcs d'attente, de transfert et du point origine ne mènent
+    //qu'à un arrêt par numéro de ligne: on compare des entiers (m_ligneDuSommet) plutôt que des chaînes
     ajouterArcsVoyages(p_gtfs);
-    ajouterArcsTransferts(p_gtfs);
-    ajouterArcsAttente(p_gtfs);
+
+    ajouterArcsTransferts(p_gtfs, m_transferts, p_nbFils);
+    ajouterArcsAttente(p_gtfs, p_nbFils);
+
+    //une requête cesse de chercher des départs à une station dès qu'elle en a trouvé un par ligne
+    for (const auto &station : p_gtfs.getStations())
+        m_nbLignesDeStation[station.first] = compterLignes(station.second);
+
+    m_arretOrigine = make_shared<Arret>(stationIdOrigine, Heure(), Heure(), 0, "origine");
+    m_arretDestination = make_shared<Arret>(stationIdDestination, Heure(), Heure(), 0, "destination");
 }
 
+//! \brief indique si un arrêt appartient à la fenêtre du réseau, donc s'il a un sommet
+bool ReseauGTFS::dansFenetre(const Arret &p_arret) const
+{
+    return p_arret.getHeureDepart() >= m_debutFenetre && p_arret.getHeureArrivee() < m_finFenetre;
+}
 
+//! \brief retourne le premier arrêt d'une station (par heure d'arrivée) pouvant appartenir à la fenêtre
+//! \brief un arrêt de la fenêtre arrive au plus m_dureeMaxArret secondes avant m_debutFenetre; les arrêts suivants
+//! \brief arrivant avant m_finFenetre doivent tout de même être vérifiés avec dansFenetre()
+std::multimap<Heure, Arret::Ptr>::const_iterator ReseauGTFS::premierArretDansFenetre(const Station &p_station) const
+{
+    const int debut = (m_debutFenetre - Heure(0, 0, 0)) - static_cast<int>(m_dureeMaxArret);
+    return p_station.getArrets().lower_bound(Heure(0, 0, 0).add_secondes(debut > 0 ? debut : 0));
+}
 
-//! \brief Trouve le plus court chemin menant du point d'origine au point destination préalablement choisis
-//! \brief Permet également d'affichier l'itinéraire du voyage et retourne le temps d'exécution de l'algorithme de plus court chemin utilisé
+//! \brief associe un sommet sans arcs à un arrêt, en réutilisant au besoin un sommet libéré par enleverSommet()
+//! \return le sommet de l'arrêt
+size_t ReseauGTFS::ajouterSommet(const DonneesGTFS &p_gtfs, const Arret::Ptr &p_arret)
+{
+    const string numero = p_gtfs.getLignes().at(p_gtfs.getVoyages().at(p_arret->getVoyageId()).getLigne()).getNumero();
+    const uint32_t ligne = m_entierDuNumero.insert({numero, static_cast<uint32_t>(m_entierDuNumero.size())}).first->second;
+    m_nbNumerosDeLigne = m_entierDuNumero.size();
+
+    size_t sommet;
+    if (m_sommetsLibres.empty())
+    {
+        sommet = m_arretDuSommet.size();
+        m_arretDuSommet.push_back(p_arret);
+        m_ligneDuSommet.push_back(ligne);
+        m_leGraphe.resize(m_arretDuSommet.size());
+    }
+    else
+    {
+        sommet = m_sommetsLibres.back();
+        m_sommetsLibres.pop_back();
+        m_arretDuSommet[sommet] = p_arret;
+        m_ligneDuSommet[sommet] = ligne;
+    }
+    m_sommetDeArret.insert({p_arret, sommet});
+    return sommet;
+}
+
+//! \brief enlève les arcs sortant d'un sommet et le libère; les arcs qui y entrent doivent déjà avoir été enlevés
+void ReseauGTFS::enleverSommet(size_t p_sommet)
+{
+    for (const auto &arc : m_leGraphe.getArcs(p_sommet))
+        m_leGraphe.enleverArc(p_sommet, arc.first);
+    m_sommetDeArret.erase(m_arretDuSommet[p_sommet]);
+    m_arretDuSommet[p_sommet] = nullptr;
+    m_sommetsLibres.push_back(p_sommet);
+}
+
+//! \brief retourne le nombre de numéros de ligne distincts parmi les arrêts d'une station qui sont dans la fenêtre
+size_t ReseauGTFS::compterLignes(const Station &p_station) const
+{
+    vector<bool> ligneVue(m_nbNumerosDeLigne, false);
+    size_t nbLignes = 0;
+    auto finArrets = p_station.getArrets().lower_bound(m_finFenetre);
+    for (auto arret = premierArretDansFenetre(p_station); arret != finArrets; ++arret)
+    {
+        if (!dansFenetre(*arret->second)) continue;
+        const uint32_t ligne = m_ligneDuSommet[m_sommetDeArret.at(arret->second)];
+        if (!ligneVue[ligne]) ++nbLignes;
+        ligneVue[ligne] = true;
+    }
+    return nbLignes;
+}
+
+//! \brief retourne l'arrêt associé à un sommet du graphe ou à un sommet virtuel d'une requête
+//! \throws out_of_range si p_sommet n'est ni un sommet du graphe ni un sommet virtuel
+const Arret::Ptr &ReseauGTFS::arretDuSommet(size_t p_sommet) const
+{
+    if (p_sommet == m_arretDuSommet.size()) return m_arretOrigine;
+    if (p_sommet == m_arretDuSommet.size() + 1) return m_arretDestination;
+    return m_arretDuSommet.at(p_sommet);
+}
+
+//! \brief Trouve le plus court chemin de la requête courante (voir ajouterArcsOrigineDestination())
 //! \param[in] p_afficherItineraire: true si on désire afficher l'itinéraire et false autrement
 //! \param[out] p_tempsExecution: le temps d'exécution de l'algorithme de plus court chemin utilisé
 //! \returns le temps du trajet en secondes (= numeric_limits<unsigned_int>::max() si la destination n'est pas atteignable)
-//! \throws logic_error si un problème survient durant l'exécution de la méthode
+//! \throws logic_error si aucun point origine et destination n'a été ajouté
 unsigned int ReseauGTFS::itineraire(const DonneesGTFS &p_gtfs, bool p_afficherItineraire, long &p_tempsExecution) const
 {
     if (!m_origine_dest_ajoute)
         throw logic_error(
                 "ReseauGTFS::afficherItineraire(): il faut ajouter un point origine et un point destination avant d'obtenir un itinéraire");
+    return itineraire(p_gtfs, m_requete, p_afficherItineraire, p_tempsExecution);
+}
 
+
+//! \brief Trouve le plus court chemin menant du point d'origine au point destination préalablement choisis
+//! \brief Permet également d'affichier l'itinéraire du voyage et retourne le temps d'exécution de l'algorithme de plus court chemin utilisé
+//! \brief Cette méthode ne modifie pas le réseau et peut être appelée simultanément par plusieurs fils d'exécution
+//! \brief La hiérarchie de contraction est utilisée si construireHierarchieContraction() a été appelée, sinon le graphe
+//! \brief compact si compacterGraphe() a été appelée
+//! \param[in] p_requete: la requête obtenue de preparerRequete()
+//! \param[in] p_afficherItineraire: true si on désire afficher l'itinéraire et false autrement
+//! \param[out] p_tempsExecution: le temps d'exécution de l'algorithme de plus court chemin utilisé
+//! \returns le temps du trajet en secondes (= numeric_limits<unsigned_int>::max() si la destination n'est pas atteignable)
+//! \throws logic_error si un problème survient durant l'exécution de la méthode
+unsigned int ReseauGTFS::itineraire(const DonneesGTFS &p_gtfs, const Requete &p_requete, bool p_afficherItineraire,
+                                    long &p_tempsExecution) const
+{
     vector<size_t> chemin;
 
     timeval tv1;
     timeval tv2;
     if (gettimeofday(&tv1, 0) != 0)
         throw logic_error("ReseauGTFS::afficherItineraire(): gettimeofday() a échoué pour tv1");
-    unsigned int tempsDuTrajet = m_leGraphe.plusCourtChemin(m_sommetOrigine, m_sommetDestination, chemin);
+    unsigned int tempsDuTrajet = plusCourtChemin(p_requete, chemin);
     if (gettimeofday(&tv2, 0) != 0)
         throw logic_error("ReseauGTFS::afficherItineraire(): gettimeofday() a échoué pour tv2");
     p_tempsExecution = tempsExecution(tv1, tv2);
 
-    if (tempsDuTrajet == numeric_limits<unsigned int>::max())
-    {
-        if (p_afficherItineraire)
-            cout << "La destination n'est pas atteignable de l'orignine avec cette distance maximale de marche" << endl;
-        return tempsDuTrajet;
-    }
+    return afficherChemin(p_gtfs, p_requete, chemin, tempsDuTrajet, p_afficherItineraire);
+}
 
-    if (tempsDuTrajet == 0)
-    {
-        if (p_afficherItineraire) cout << "Vous êtes déjà situé à la destination demandée" << endl;
-        return tempsDuTrajet;
-    }
+//! \brief Trouve le plus court chemin d'une requête et retourne les arrêts visités plutôt que de les afficher
+//! \brief Comme itineraire(p_gtfs, p_requete, false, p_tempsExecution), qui peut être appelée par plusieurs fils d'exécution
+//! \param[in] p_requete: la requête obtenue de preparerRequete()
+//! \param[out] p_arrets: les arrêts du trajet, sans les points origine et destination (vide si inatteignable)
+//! \param[out] p_tempsExecution: le temps d'exécution de l'algorithme de plus court chemin utilisé
+//! \returns le temps du trajet en secondes (= numeric_limits<unsigned_int>::max() si la destination n'est pas atteignable)
+//! \throws logic_error si un problème survient durant l'exécution de la méthode
+unsigned int ReseauGTFS::itineraire(const DonneesGTFS &p_gtfs, const Requete &p_requete, vector<Arret::Ptr> &p_arrets,
+                                    long &p_tempsExecution) const
+{
+    vector<size_t> chemin;
+
+    timeval tv1;
+    timeval tv2;
+    if (gettimeofday(&tv1, 0) != 0)
+        throw logic_error("ReseauGTFS::itineraire(): gettimeofday() a échoué pour tv1");
+    unsigned int tempsDuTrajet = plusCourtChemin(p_requete, chemin);
+    if (gettimeofday(&tv2, 0) != 0)
+        throw logic_error("ReseauGTFS::itineraire(): gettimeofday() a échoué pour tv2");
+    p_tempsExecution = tempsExecution(tv1, tv2);
+
+    tempsDuTrajet = afficherChemin(p_gtfs, p_requete, chemin, tempsDuTrajet, false);
+    p_arrets.clear();
+    if (tempsDuTrajet != numeric_limits<unsigned int>::max())
+        for (size_t k = 1; k + 1 < chemin.size(); ++k) //on exclut les sommets virtuels origine et destination
+            p_arrets.push_back(m_arretDuSommet[chemin[k]]);
+    return tempsDuTrajet;
+}
+
+//! \brief plus court chemin d'une requête avec la hiérarchie de contraction, sinon les repères ALT, sinon le graphe
+//! \brief compact, sinon m_leGraphe
+unsigned int ReseauGTFS::plusCourtChemin(const Requete &p_requete, vector<size_t> &p_chemin) const
+{
+    EtatsRecherche etats;
+    return plusCourtChemin(p_requete, p_chemin, etats);
+}
+
+//! \brief même recherche, avec les tableaux de travail du fil d'exécution appelant (voir itinerairesEnLot())
+unsigned int ReseauGTFS::plusCourtChemin(const Requete &p_requete, vector<size_t> &p_chemin,
+                                         EtatsRecherche &p_etats) const
+{
+    if (m_hierarchie)
+        return m_hierarchie->plusCourtChemin(p_requete.arcs, p_chemin, p_etats.hierarchie);
+    if (m_reperes)
+        return m_reperes->plusCourtChemin(m_leGraphe, p_requete.arcs, p_chemin, p_etats.reperes);
+    if (m_grapheCompact)
+        return m_grapheCompact->plusCourtChemin(p_requete.arcs, p_chemin, p_etats.graphe);
+    return m_leGraphe.plusCourtChemin(p_requete.arcs, p_chemin, p_etats.graphe);
+}
+
+//! \brief construit le graphe transposé, nécessaire à departLePlusTardif()
+void ReseauGTFS::construireGrapheTranspose()
+{
+    m_grapheTranspose.reset(new Graphe(m_leGraphe.transpose()));
+}
 
-    //un chemin non trivial a été trouvé
-    if (chemin.size() <= 2)
-        throw logic_error("ReseauGTFS::afficherItineraire(): un chemin non trivial doit contenir au moins 3 sommets");
+//! \brief Trouve l'heure de départ la plus tardive du point origine permettant d'arriver au point destination à temps
+//! \brief La recherche part du point destination sur le graphe transposé: un arc relie la destination à chaque arrêt
+//! \brief d'une station à distance de marche d'où l'on arrive à pied au plus tard à p_arriveeLimite, avec pour poids
+//! \brief p_arriveeLimite - (heure de l'arrêt). La distance d'un arrêt est donc p_arriveeLimite moins son heure, et
+//! \brief l'origine est atteinte par l'arrêt d'une station proche dont l'heure moins la marche est la plus tardive.
+//! \brief L'itinéraire affiché est le chemin trouvé; il arrive au plus tard à p_arriveeLimite, mais pas forcément au plus tôt.
+//! \param[in] p_gtfs: un objet DonneesGTFS
+//! \param[in] p_pointOrigine: les coordonnées GPS du point origine
+//! \param[in] p_pointDestination: les coordonnées GPS du point destination
+//! \param[in] p_arriveeLimite: l'heure limite d'arrivée au point destination
+//! \param[out] p_heureDepart: l'heure de départ la plus tardive, dans la fenêtre (inchangée si aucun itinéraire n'arrive à temps)
+//! \param[in] p_afficherItineraire: true si on désire afficher l'itinéraire et false autrement
+//! \param[out] p_tempsExecution: le temps d'exécution de la recherche sur le graphe transposé
+//! \returns la durée du trajet, de p_heureDepart à l'arrivée (= numeric_limits<unsigned int>::max() si aucun itinéraire n'arrive à temps)
+//! \throws logic_error si le graphe transposé n'a pas été construit (voir construireGrapheTranspose())
+//! \throws logic_error si p_arriveeLimite n'appartient pas à la fenêtre [getDebutFenetre(), getFinFenetre()]
+unsigned int ReseauGTFS::departLePlusTardif(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                                            const Coordonnees &p_pointDestination, const Heure &p_arriveeLimite,
+                                            Heure &p_heureDepart, bool p_afficherItineraire, long &p_tempsExecution) const
+{
+    if (!m_grapheTranspose)
+        throw logic_error("ReseauGTFS::departLePlusTardif(): le graphe transposé n'a pas été construit");
+    if (p_arriveeLimite < m_debutFenetre || p_arriveeLimite > m_finFenetre)
+        throw logic_error("ReseauGTFS::departLePlusTardif(): l'heure d'arrivée est hors de l'intervalle du réseau");
+    const Heure minuit(0, 0, 0);
+    const unsigned int limite = static_cast<unsigned int>(p_arriveeLimite - minuit);
+    const unsigned int debut = static_cast<unsigned int>(m_debutFenetre - minuit);
+    const size_t nbSommets = m_leGraphe.getNbSommets();
 
-    if (m_arretDuSommet[chemin[0]]->getStationId() != stationIdOrigine)
+    //dans le graphe transposé, l'origine virtuelle est le point destination et la destination virtuelle le point origine
+    Graphe::ArcsVirtuels arcs;
+    for (const auto &voisin : m_indexStations.dansRayon(p_pointDestination, distanceMaxMarche, true))
     {
-        cout << "m_arretDuSommet[chemin[0]]->getStationId() = " << m_arretDuSommet[chemin[0]]->getStationId() << endl;
-        cout << "chemin[0] = " << chemin[0] << " m_sommetOrigine = " << m_sommetOrigine << endl;
-        for (const auto & i : chemin)
+        const unsigned int marche = static_cast<unsigned int>(voisin.distance / vitesseDeMarche * 3600);
+        const auto &arrets = voisin.station->second.getArrets();
+        for (auto it = premierArretDansFenetre(voisin.station->second);
+             it != arrets.end() && it->first < m_finFenetre && unsigned(it->first - minuit) + marche <= limite; ++it)
         {
-            cout << "chemin[" << i << "] = " << chemin[i] << endl;
+            if (!dansFenetre(*it->second)) continue;
+            arcs.depuisOrigine.push_back({m_sommetDeArret.at(it->second), limite - unsigned(it->first - minuit)});
         }
-        throw logic_error("ReseauGTFS::afficherItineraire(): le premier noeud du chemin doit être le point origine");
     }
-    if (m_arretDuSommet[chemin[chemin.size() - 1]]->getStationId() != stationIdDestination)
-        throw logic_error(
-                "ReseauGTFS::afficherItineraire(): le dernier noeud du chemin doit être le point destination");
-
-
-    if (p_afficherItineraire)
+    for (const auto &voisin : m_indexStations.dansRayon(p_pointOrigine, distanceMaxMarche, true))
     {
-        std::cout << std::endl;
-        std::cout << "=====================" << std::endl;
-        std::cout << "     ITINÉRAIRE      " << std::endl;
-        std::cout << "=====================" << std::endl;
-        std::cout << std::endl;
+        const unsigned int marche = static_cast<unsigned int>(voisin.distance / vitesseDeMarche * 3600);
+        const auto &arrets = voisin.station->second.getArrets();
+        for (auto it = premierArretDansFenetre(voisin.station->second);
+             it != arrets.end() && it->first < m_finFenetre && unsigned(it->first - minuit) <= limite; ++it)
+        {
+            //comme pour preparerRequete(), on part du point origine à l'intérieur de la fenêtre
+            if (dansFenetre(*it->second) && unsigned(it->first - minuit) >= debut + marche)
+                arcs.versDestination.push_back({m_sommetDeArret.at(it->second), marche});
+        }
     }
 
-    if (p_afficherItineraire) cout << "Heure de départ du point d'origine: "  << p_gtfs.getTempsDebut() << endl;
-    Arret::Ptr ptr_a = m_arretDuSommet.at(chemin[0]);
-    Arret::Ptr ptr_b = m_arretDuSommet.at(chemin[1]);
-    if (p_afficherItineraire)
-        cout << "Rendez vous à la station " << p_gtfs.getStations().at(ptr_b->getStationId()) << endl;
+    vector<size_t> chemin;
+    timeval tv1;
+    timeval tv2;
+    if (gettimeofday(&tv1, 0) != 0)
+        throw logic_error("ReseauGTFS::departLePlusTardif(): gettimeofday() a échoué pour tv1");
+    const unsigned int distance = m_grapheTranspose->plusCourtChemin(arcs, chemin);
+    if (gettimeofday(&tv2, 0) != 0)
+        throw logic_error("ReseauGTFS::departLePlusTardif(): gettimeofday() a échoué pour tv2");
+    p_tempsExecution = tempsExecution(tv1, tv2);
+
+    if (distance == numeric_limits<unsigned int>::max())
+        return afficherChemin(p_gtfs, Requete(), chemin, distance, p_afficherItineraire);
+
+    //le chemin à rebours, remis dans le sens du trajet, avec les sommets virtuels du graphe (origine, destination)
+    reverse(chemin.begin(), chemin.end());
+    chemin.front() = nbSommets;
+    chemin.back() = nbSommets + 1;
+    Requete requete;
+    requete.heureDepart = minuit.add_secondes(limite - distance);
+    const Arret::Ptr &dernierArret = m_arretDuSommet[chemin[chemin.size() - 2]];
+    double distanceMarche = p_pointDestination - p_gtfs.getStations().at(dernierArret->getStationId()).getCoords();
+    if (std::isnan(distanceMarche)) distanceMarche = 0; //point confondu avec la station
+    const unsigned int arrivee = unsigned(dernierArret->getHeureArrivee() - minuit)
+                                 + static_cast<unsigned int>(distanceMarche / vitesseDeMarche * 3600);
+    p_heureDepart = requete.heureDepart;
+    return afficherChemin(p_gtfs, requete, chemin, arrivee - (limite - distance), p_afficherItineraire);
+}
 
-    unsigned int sommet = 1;
+//! \brief Trouve jusqu'à p_k itinéraires différents du point origine au point destination d'une requête (méthode des pénalités)
+//! \brief Après chaque itinéraire, chaque arrêt desservi par l'une de ses courses (même numéro de ligne, même station,
+//! \brief à toute heure) coûte p_penaliteParArret de plus; la recherche suivante préfère donc d'autres lignes ou d'autres
+//! \brief stations. Un itinéraire dont la suite de courses (ligne, station de montée, station de descente) est déjà
+//! \brief connue n'est pas retenu. Les recherches partagent leur état et sont bornées: elles abandonnent dès que le
+//! \brief coût pénalisé dépasse p_etirementMax fois la durée du meilleur itinéraire.
+//! \param[in] p_requete: la requête obtenue de preparerRequete()
+//! \param[in] p_k: le nombre maximal d'itinéraires
+//! \param[in] p_afficherItineraires: true pour afficher chaque itinéraire retenu
+//! \param[out] p_tempsExecution: le temps d'exécution de toutes les recherches, en microsecondes
+//! \param[in] p_penaliteParArret: la pénalité, en secondes, de chaque arrêt déjà desservi
+//! \param[in] p_etirementMax: le coût maximal d'une recherche, relatif à la durée du meilleur itinéraire
+//! \return la durée de chaque itinéraire retenu, le premier étant le plus rapide (vide si la destination est inatteignable)
+//! \throws logic_error si un chemin est incohérent ou si gettimeofday() échoue
+std::vector<unsigned int> ReseauGTFS::itinerairesAlternatifs(const DonneesGTFS &p_gtfs, const Requete &p_requete,
+                                                             size_t p_k, bool p_afficherItineraires,
+                                                             long &p_tempsExecution, unsigned int p_penaliteParArret,
+                                                             double p_etirementMax) const
+{
+    vector<unsigned int> durees;
+    vector<vector<tuple<uint32_t, string, string> > > coursesConnues;
+    vector<unsigned int> penaliteDeSommet(m_arretDuSommet.size(), 0);
+    Graphe::EtatRecherche etat;
+    vector<size_t> chemin;
+    unsigned int coutMax = numeric_limits<unsigned int>::max();
+    //sommets de chaque ligne d'une station, regroupés à la première pénalité de la station puis réutilisés
+    unordered_map<string, unordered_map<uint32_t, vector<size_t> > > sommetsParLigneDeStation;
+    p_tempsExecution = 0;
 
-    while (sommet < chemin.size() - 1)
+    //au plus 2 * p_k recherches: certaines redonnent une suite de courses déjà connue
+    for (size_t recherche = 0; recherche < 2 * p_k && durees.size() < p_k; ++recherche)
     {
-        ptr_a = ptr_b;
-        ++sommet;
-        ptr_b = m_arretDuSommet.at(chemin[sommet]);
-        while (ptr_b->getStationId() == ptr_a->getStationId())
-        {
-            ptr_a = ptr_b;
-            ++sommet;
-            ptr_b = m_arretDuSommet.at(chemin[sommet]);
-        }
-        //on a changé de station
-        if (ptr_b->getStationId() == stationIdDestination) //cas où on est arrivé à la destination
+        timeval tv1;
+        timeval tv2;
+        if (gettimeofday(&tv1, 0) != 0)
+            throw logic_error("ReseauGTFS::itinerairesAlternatifs(): gettimeofday() a échoué pour tv1");
+        unsigned int duree = m_leGraphe.plusCourtCheminPenalise(p_requete.arcs, penaliteDeSommet, coutMax, chemin, etat);
+        if (gettimeofday(&tv2, 0) != 0)
+            throw logic_error("ReseauGTFS::itinerairesAlternatifs(): gettimeofday() a échoué pour tv2");
+        p_tempsExecution += tempsExecution(tv1, tv2);
+        if (duree == numeric_limits<unsigned int>::max()) break;
+        if (durees.empty())
+            coutMax = static_cast<unsigned int>(min<double>(numeric_limits<unsigned int>::max() - 1,
+                                                            max(1.0, p_etirementMax * duree)));
+
+        //les courses du chemin: suites maximales d'arcs d'un même voyage
+        vector<tuple<uint32_t, string, string> > courses;
+        vector<pair<uint32_t, vector<string> > > stationsDesCourses;
+        for (size_t k = 1; k + 2 < chemin.size(); ++k)
         {
-            if (sommet != chemin.size() - 1)
-                throw logic_error(
-                        "ReseauGTFS::afficherItineraire(): incohérence de fin de chemin lors d'un changement de station");
-            break;
+            const Arret::Ptr &a = m_arretDuSommet[chemin[k]];
+            const Arret::Ptr &b = m_arretDuSommet[chemin[k + 1]];
+            if (a->getVoyageId() != b->getVoyageId()) continue;
+            const uint32_t ligne = m_ligneDuSommet[chemin[k]];
+            const bool suite = !courses.empty() && k > 1 &&
+                               m_arretDuSommet[chemin[k - 1]]->getVoyageId() == a->getVoyageId();
+            if (!suite)
+            {
+                courses.emplace_back(ligne, a->getStationId(), b->getStationId());
+                stationsDesCourses.push_back({ligne, {a->getStationId()}});
+            }
+            get<2>(courses.back()) = b->getStationId();
+            stationsDesCourses.back().second.push_back(b->getStationId());
         }
-        if (sommet == chemin.size() - 1)
-            throw logic_error("ReseauGTFS::afficherItineraire(): on ne devrait pas être arrivé à destination");
-        //on a changé de station mais sommet n'est pas le noeud destination
-        string voyage_id_a = ptr_a->getVoyageId();
-        string voyage_id_b = ptr_b->getVoyageId();
-        if (voyage_id_a != voyage_id_b) //on a changé de station à pieds
+
+        if (find(coursesConnues.begin(), coursesConnues.end(), courses) == coursesConnues.end())
         {
-            if (p_afficherItineraire)
-                cout << "De cette station, rendez-vous à pieds à la station " << p_gtfs.getStations().at(ptr_b->getStationId()) << endl;
+            coursesConnues.push_back(courses);
+            durees.push_back(duree);
+            if (p_afficherItineraires)
+                cout << endl << "Itinéraire " << durees.size() << " de " << p_k << ":" << endl;
+            afficherChemin(p_gtfs, p_requete, chemin, duree, p_afficherItineraires);
         }
-        else //on a changé de station avec un voyage
-        {
-            Heure heure = ptr_a->getHeureArrivee();
-            std::string ligne_id = p_gtfs.getVoyages().at(voyage_id_a).getLigne();
-            string ligne_numero = p_gtfs.getLignes().at(ligne_id).getNumero();
-            if (p_afficherItineraire)
-                cout << "De cette station, prenez l'autobus numéro " << ligne_numero << " à l'heure " << heure << " "
-                     << p_gtfs.getVoyages().at(voyage_id_a) << endl;
-            //maintenant allons à la dernière station de ce voyage
-            ptr_a = ptr_b;
-            ++sommet;
-            ptr_b = m_arretDuSommet.at(chemin[sommet]);
-            while (ptr_b->getVoyageId() == ptr_a->getVoyageId())
-            {
-                ptr_a = ptr_b;
-                ++sommet;
-                ptr_b = m_arretDuSommet.at(chemin[sommet]);
-            }
-            //on a changé de voyage
-            if (p_afficherItineraire)
-                cout << "et arrêtez-vous à la station " << p_gtfs.getStations().at(ptr_a->getStationId()) << " à l'heure "
-                     << ptr_a->getHeureArrivee() << endl;
-            if (ptr_b->getStationId() == stationIdDestination) //cas où on est arrivé à la destination
+        if (courses.empty()) break; //trajet à pied seulement: rien à pénaliser
+
+        for (const auto &course : stationsDesCourses)
+            for (const auto &stationId : course.second)
             {
-                if (sommet != chemin.size() - 1)
-                    throw logic_error(
-                            "ReseauGTFS::afficherItineraire(): incohérence de fin de chemin lors d'u changement de voyage");
-                break;
+                auto station = sommetsParLigneDeStation.insert({stationId, {}});
+                if (station.second)
+                    for (const auto &arret : p_gtfs.getStations().at(stationId).getArrets())
+                    {
+                        auto sommet = m_sommetDeArret.find(arret.second);
+                        if (sommet == m_sommetDeArret.end()) continue; //hors de la fenêtre du réseau
+                        station.first->second[m_ligneDuSommet[sommet->second]].push_back(sommet->second);
+                    }
+                auto sommets = station.first->second.find(course.first);
+                if (sommets == station.first->second.end()) continue;
+                for (size_t sommet : sommets->second)
+                    penaliteDeSommet[sommet] += p_penaliteParArret;
             }
-            if (ptr_a->getStationId() != ptr_b->getStationId()) //alors on s'est rendu à pieds à l'autre station
-                if (p_afficherItineraire)
-                    cout << "De cette station, rendez-vous à pieds à la station " << p_gtfs.getStations().at(ptr_b->getStationId()) << endl;
-        }
     }
+    return durees;
+}
 
-    if (p_afficherItineraire)
-    {
-        cout << "Déplacez-vous à pieds de cette station au point destination" << endl;
-        cout << "Heure d'arrivée à la destination: " << p_gtfs.getTempsDebut().add_secondes(tempsDuTrajet) << endl;
-    }
-    unsigned int h = tempsDuTrajet / 3600;
-    unsigned int reste_sec = tempsDuTrajet % 3600;
-    unsigned int m = reste_sec / 60;
-    unsigned int s = reste_sec % 60;
-    if (p_afficherItineraire)
+//! \brief vérifie le chemin d'une requête et, si demandé, affiche l'itinéraire correspondant (voir afficherItineraire())
+//! \param[in] p_chemin: le chemin du sommet origine virtuel au sommet destination virtuel
+//! \param[in] p_tempsDuTrajet: la longueur du chemin, en secondes (= numeric_limits<unsigned_int>::max() si aucun chemin)
+//! \param[in] p_afficherItineraire: true si on désire afficher l'itinéraire et false autrement
+//! \returns p_tempsDuTrajet
+//! \throws logic_error si le chemin est incohérent
+unsigned int ReseauGTFS::afficherChemin(const DonneesGTFS &p_gtfs, const Requete &p_requete,
+                                        const std::vector<size_t> &p_chemin, unsigned int p_tempsDuTrajet,
+                                        bool p_afficherItineraire) const
+{
+    //les sommets du chemin sont décrits par leurs arrêts, arrêts fantômes compris
+    struct Parcours
     {
-        cout << "Durée du trajet: " << h << " heures, " << m << " minutes, " << s << " secondes" << endl;
-    }
+        const ReseauGTFS &reseau;
+        const DonneesGTFS &gtfs;
 
-    return tempsDuTrajet;
+        bool estOrigine(size_t p_sommet) const
+        {
+            return reseau.arretDuSommet(p_sommet)->getStationId() == reseau.stationIdOrigine;
+        }
+        bool estDestination(size_t p_sommet) const
+        {
+            return reseau.arretDuSommet(p_sommet)->getStationId() == reseau.stationIdDestination;
+        }
+        std::string station(size_t p_sommet) const { return reseau.arretDuSommet(p_sommet)->getStationId(); }
+        std::string voyage(size_t p_sommet) const { return reseau.arretDuSommet(p_sommet)->getVoyageId(); }
+        Heure heureArrivee(size_t p_sommet) const { return reseau.arretDuSommet(p_sommet)->getHeureArrivee(); }
+        void afficherStation(size_t p_sommet) const { cout << gtfs.getStations().at(station(p_sommet)); }
+        void afficherCourse(size_t p_sommet) const
+        {
+            const Voyage &leVoyage = gtfs.getVoyages().at(voyage(p_sommet));
+            cout << gtfs.getLignes().at(leVoyage.getLigne()).getNumero() << " à l'heure " << heureArrivee(p_sommet)
+                 << " " << leVoyage;
+        }
+    };
+    return afficherItineraire(Parcours{*this, p_gtfs}, p_chemin, p_requete.heureDepart, p_tempsDuTrajet,
+                              p_afficherItineraire);
 }
 
 
+//! \brief Trouve toutes les stations atteignables à partir d'un point origine à l'intérieur d'un budget de temps
+//! \brief La recherche est bornée par p_budget: aucun sommet plus éloigné n'est solutionné
+//! \param[in] p_pointOrigine: les coordonnées GPS du point origine
+//! \param[in] p_heureDepart: l'heure de départ du point origine, dans l'intervalle de temps du GTFS
+//! \param[in] p_budget: le temps de trajet maximal, en secondes
+//! \return pour chaque station atteignable, l'heure la plus hâtive de l'un de ses arrêts atteignables
+//! \throws logic_error si p_heureDepart n'appartient pas à la fenêtre [getDebutFenetre(), getFinFenetre())
+std::map<std::string, Heure> ReseauGTFS::isochrone(const Coordonnees &p_pointOrigine,
+                                                   const Heure &p_heureDepart, unsigned int p_budget) const
+{
+    if (p_heureDepart < m_debutFenetre || p_heureDepart >= m_finFenetre)
+        throw logic_error("ReseauGTFS::isochrone(): l'heure de départ doit appartenir à la fenêtre du réseau");
+
+    Graphe::ArcsVirtuels arcs;
+    arcs.depuisOrigine = arcsDepuisOrigine(p_pointOrigine, p_heureDepart);
+    Graphe::EtatRecherche etat;
+    m_leGraphe.distancesDepuisOrigine(arcs, p_budget, etat);
+
+    std::map<std::string, Heure> stationsAtteintes;
+    for (size_t sommet : etat.sommetsModifies)
+    {
+        if (sommet >= m_arretDuSommet.size()) continue; //sommet virtuel
+        unsigned int temps = etat.distance[sommet];
+        if (temps > p_budget) continue;
+        Heure arrivee = p_heureDepart.add_secondes(temps);
+        auto res = stationsAtteintes.insert({m_arretDuSommet[sommet]->getStationId(), arrivee});
+        if (!res.second && arrivee < res.first->second) res.first->second = arrivee;
+    }
+    return stationsAtteintes;
+}
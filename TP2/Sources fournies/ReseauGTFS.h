@@ -7,42 +7,158 @@
 
 #include "DonneesGTFS.h"
 #include "graphe.h"
+#include "hierarchieContraction.h"
+#include "grapheCompact.h"
+#include "reperesALT.h"
+#include "ReseauProjete.h"
+#include "indexStations.h"
+#include "transfertsAPied.h"
+#include "parametresMarche.h"
+#include <memory>
 
 
 class ReseauGTFS
 {
 
 public:
-    explicit ReseauGTFS(const DonneesGTFS &);
+    //! \brief arcs du point origine et vers le point destination d'une requête, gardés hors du graphe
+    //! \brief une requête n'est jamais insérée dans m_leGraphe; un même ReseauGTFS peut donc servir plusieurs fils d'exécution
+    struct Requete
+    {
+        Graphe::ArcsVirtuels arcs;
+        Heure heureDepart; //heure de départ du point origine; les poids des arcs du point origine sont mesurés à partir de celle-ci
+    };
+
+    //! \brief résultats d'un lot de requêtes, dans l'ordre des paires (origine, destination) fournies
+    struct ResultatsLot
+    {
+        std::vector<unsigned int> tempsDuTrajet; //en secondes (= numeric_limits<unsigned int>::max() si inatteignable)
+        std::vector<std::vector<Arret::Ptr> > chemins; //arrêts visités par chaque trajet; vide si non demandé
+        std::vector<long> latences; //temps d'exécution de chaque requête, en microsecondes
+        long tempsTotal; //temps d'exécution du lot, en microsecondes
+        double requetesParSeconde;
+        long latenceP50; //percentiles des latences, en microsecondes
+        long latenceP90;
+        long latenceP99;
+    };
+
+    //! \brief matrice dense des temps de trajet (en secondes) de chaque point origine vers chaque point destination
+    struct MatriceTempsTrajet
+    {
+        size_t nbOrigines;
+        size_t nbDestinations;
+        std::vector<unsigned int> temps; //temps[i * nbDestinations + j] (= numeric_limits<unsigned int>::max() si inatteignable)
+        long tempsTotal; //temps d'exécution du calcul de la matrice, en microsecondes
+
+        unsigned int at(size_t i, size_t j) const;
+        void ecrireCSV(const std::string &) const;
+        void ecrireBinaire(const std::string &) const;
+    };
+
+    explicit ReseauGTFS(const DonneesGTFS &, unsigned int p_nbFils = 1, const Transferts & p_transfertsAPied = Transferts());
+    ReseauGTFS(const DonneesGTFS &, const Heure & p_debutFenetre, const Heure & p_finFenetre, unsigned int p_nbFils = 1,
+               const Transferts & p_transfertsAPied = Transferts());
+    ResultatsLot itinerairesEnLot(const DonneesGTFS &, const std::vector<std::pair<Coordonnees, Coordonnees> > &,
+                                  unsigned int p_nbFils = 0, bool p_garderChemins = false) const;
+    MatriceTempsTrajet matriceTempsTrajet(const std::vector<Coordonnees> &, const std::vector<Coordonnees> &,
+                                          const Heure & p_heureDepart,
+                                          unsigned int p_tempsMax = std::numeric_limits<unsigned int>::max(),
+                                          unsigned int p_nbFils = 0) const;
+    Requete preparerRequete(const Coordonnees &, const Coordonnees &) const;
+    Requete preparerRequete(const Coordonnees &, const Coordonnees &, const Heure &) const;
+    std::map<std::string, Heure> isochrone(const Coordonnees &, const Heure &,
+                                           unsigned int p_budget) const;
+    unsigned int itineraire(const DonneesGTFS &, const Requete &, bool, long &) const;
+    unsigned int itineraire(const DonneesGTFS &, const Requete &, std::vector<Arret::Ptr> &, long &) const;
+    std::vector<unsigned int> itinerairesAlternatifs(const DonneesGTFS &, const Requete &, size_t p_k, bool, long &,
+                                                     unsigned int p_penaliteParArret = 300,
+                                                     double p_etirementMax = 1.5) const;
     void ajouterArcsOrigineDestination(const DonneesGTFS &, const Coordonnees &, const Coordonnees &);
+    void ajouterArcsOrigineDestination(const DonneesGTFS &, const Coordonnees &, const Coordonnees &, const Heure &);
     void enleverArcsOrigineDestination();
     unsigned int itineraire(const DonneesGTFS &, bool, long &) const;
     size_t getNbArcsOrigineVersStations() const;
     size_t getNbArcsStationsVersDestination() const;
     size_t getNbArcs() const;
+    size_t getTailleMemoire() const;
     double getDistMaxMarche() const;
+    void renumeroterSommets();
+    size_t elaguerArcsDomines();
+    void ecrireBinaire(const DonneesGTFS &, const std::string &) const;
+    void construireHierarchieContraction();
+    size_t getNbRaccourcis() const;
+    void compacterGraphe(GrapheCompact::Encodage);
+    void abandonnerGrapheCompact();
+    size_t getTailleMemoireGraphe() const;
+    const Graphe &getGraphe() const;
+    void avancerFenetre(const DonneesGTFS &, unsigned int p_secondes);
+    Heure getDebutFenetre() const;
+    Heure getFinFenetre() const;
+    unsigned long getGeneration() const;
+    void construireReperes(const DonneesGTFS &, size_t p_nbReperes = 8, unsigned int p_nbFils = 0);
+    void abandonnerReperes();
+    size_t getTailleMemoireReperes() const;
+    size_t getNbSommetsSolutionnes(const Requete &) const;
+    void construireGrapheTranspose();
+    unsigned int departLePlusTardif(const DonneesGTFS &, const Coordonnees &, const Coordonnees &,
+                                    const Heure & p_arriveeLimite, Heure & p_heureDepart, bool, long &) const;
 
 private:
+    friend class RouteurMultiCriteres; //copie le graphe et les arrêts des sommets une seule fois, à la construction
+
     Graphe m_leGraphe;
+    std::unique_ptr<HierarchieContraction> m_hierarchie; //utilisée par itineraire() une fois construite; nullptr sinon
+    std::unique_ptr<GrapheCompact> m_grapheCompact; //copie compacte de m_leGraphe utilisée par les recherches; nullptr sinon
+    std::unique_ptr<ReperesALT> m_reperes; //repères ALT guidant les recherches sur m_leGraphe; nullptr sinon
+    std::vector<std::string> m_stationsReperes; //stations choisies comme repères par construireReperes()
+    std::unique_ptr<Graphe> m_grapheTranspose; //m_leGraphe aux arcs inversés, pour departLePlusTardif(); nullptr sinon
     std::vector<Arret::Ptr> m_arretDuSommet; //m_arretDuSommet[i] est le pointeur (shared_ptr) de l'arret (associé au sommet i du graphe
     std::unordered_map<Arret::Ptr,size_t> m_sommetDeArret; //m_sommetDeArret[a_ptr] est le sommet du graphe associé au pointeur de l'arret a_ptr
-    std::vector<size_t> m_sommetsVersDestination; //Chaque élément est un sommet possédant un arc vers la destination
+    Arret::Ptr m_arretOrigine; //l'arret fantôme associé au sommet origine virtuel (m_leGraphe.getNbSommets())
+    Arret::Ptr m_arretDestination; //l'arret fantôme associé au sommet destination virtuel (m_leGraphe.getNbSommets() + 1)
+    std::unordered_map<std::string, size_t> m_nbLignesDeStation; //nombre de numéros de ligne distincts desservant chaque station
+    std::vector<uint32_t> m_ligneDuSommet; //numéro de ligne du voyage de chaque sommet, sous forme d'un entier de [0, m_nbNumerosDeLigne)
+    size_t m_nbNumerosDeLigne;
+
+    //! \brief tableaux de travail des recherches d'un fil d'exécution, pour chaque recherche possible de plusCourtChemin()
+    struct EtatsRecherche
+    {
+        Graphe::EtatRecherche graphe; //m_leGraphe ou le graphe compact
+        ReperesALT::EtatRecherche reperes;
+        HierarchieContraction::EtatRecherche hierarchie;
+    };
 
     bool m_origine_dest_ajoute; //indique si on a ajouté le point origine, le point destination, et les arcs correspondants
-    size_t m_sommetOrigine; //le sommet du graphe qui représente le point d'origine
-    size_t m_sommetDestination; //le sommet du graphe qui représente le point destination
-    size_t m_nbArcsOrigineVersStations; //le nombre d'arcs du point origine vers des stations
-    size_t m_nbArcsStationsVersDestination; //le nombre d'arcs d'une station vers le point destination
-
-    const double vitesseDeMarche = 5.0; // vitesse moyenne de marche, en km/heure, d'un humain selon wikipedia */
-    const double distanceMaxMarche = 1.5; // distance maximale de marche permise, en km
-    const unsigned int delaisMinArcsAttente = 300; // le délais minimal pour les arcs d'attentes en secondes
+    Requete m_requete; //la requête courante de ajouterArcsOrigineDestination()
+
     const std::string stationIdOrigine = "origine"; //stationID donné pour l'arret fantôme de départ
     const std::string stationIdDestination = "destination"; //numéro de stationID donné pour les arrets fantômes de destination
+    IndexStations m_indexStations; //grille des stations, pour les arcs du point origine et vers le point destination
+
+    Heure m_debutFenetre; //le graphe contient les arrêts partant à partir de m_debutFenetre et arrivant avant m_finFenetre
+    Heure m_finFenetre;
+    unsigned int m_dureeMaxArret; //plus longue durée (départ - arrivée) d'un arrêt de DonneesGTFS, en secondes
+    Transferts m_transferts; //transferts de transfers.txt suivis des transferts à pied, conservés pour avancerFenetre()
+    std::unordered_map<std::string, uint32_t> m_entierDuNumero; //entier de chaque numéro de ligne (voir m_ligneDuSommet)
+    std::vector<size_t> m_sommetsLibres; //sommets des arrêts sortis de la fenêtre: sans arcs, m_arretDuSommet[i] == nullptr
+    unsigned long m_generation; //voir getGeneration()
 
     void ajouterArcsVoyages(const DonneesGTFS &); //ajout des arcs dus aux voyages
-    void ajouterArcsTransferts(const DonneesGTFS &); //ajout des arcs dus aux transferts
-    void ajouterArcsAttente(const DonneesGTFS & p_gtfs); //ajout des arcs d'attente
+    void ajouterArcsTransferts(const DonneesGTFS &, const Transferts &, unsigned int p_nbFils); //ajout des arcs dus aux transferts
+    void ajouterArcsAttente(const DonneesGTFS & p_gtfs, unsigned int p_nbFils); //ajout des arcs d'attente
+    const Arret::Ptr & arretDuSommet(size_t) const; //l'arret d'un sommet, incluant les sommets virtuels d'une requête
+    bool dansFenetre(const Arret &) const;
+    std::multimap<Heure, Arret::Ptr>::const_iterator premierArretDansFenetre(const Station &) const;
+    size_t ajouterSommet(const DonneesGTFS &, const Arret::Ptr &);
+    void enleverSommet(size_t);
+    size_t compterLignes(const Station &) const;
+    void recalculerArcsCorrespondance(const DonneesGTFS &, size_t);
+    void reconstruireReperes(unsigned int p_nbFils);
+    unsigned int plusCourtChemin(const Requete &, std::vector<size_t> &) const;
+    unsigned int plusCourtChemin(const Requete &, std::vector<size_t> &, EtatsRecherche &) const;
+    unsigned int afficherChemin(const DonneesGTFS &, const Requete &, const std::vector<size_t> &, unsigned int, bool) const;
+    std::vector<std::pair<size_t, unsigned int> > arcsDepuisOrigine(const Coordonnees &, const Heure &) const;
+    std::vector<std::pair<size_t, unsigned int> > arcsVersDestination(const Coordonnees &) const;
 
 };
 
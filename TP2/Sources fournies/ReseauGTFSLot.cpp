@@ -0,0 +1,206 @@
+//
+// Traitement en parallèle d'un lot de requêtes sur un même ReseauGTFS
+//
+
+#include "ReseauGTFS.h"
+#include "parallele.h"
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+//! \brief retourne le percentile p (0 < p <= 1) d'un vecteur trié, selon la méthode du rang le plus proche
+static long percentile(const vector<long> &p_valeursTriees, double p)
+{
+    if (p_valeursTriees.empty()) return 0;
+    size_t rang = static_cast<size_t>(ceil(p * p_valeursTriees.size()));
+    if (rang == 0) rang = 1;
+    return p_valeursTriees[rang - 1];
+}
+
+//! \brief Calcule l'itinéraire de chaque paire (origine, destination) en répartissant les requêtes entre plusieurs fils d'exécution
+//! \brief Chaque fil possède son propre état de recherche; le réseau n'est jamais modifié
+//! \brief Chaque requête est traitée par la même recherche que itineraire(): hiérarchie de contraction, sinon repères ALT,
+//! \brief sinon graphe compact, sinon m_leGraphe
+//! \param[in] p_gtfs: l'objet DonneesGTFS ayant servi à construire le réseau
+//! \param[in] p_paires: les paires (point origine, point destination) à traiter
+//! \param[in] p_nbFils: le nombre de fils d'exécution (0 pour utiliser thread::hardware_concurrency())
+//! \param[in] p_garderChemins: true si on désire obtenir les arrêts de chaque trajet
+//! \return les temps de trajet (et chemins) dans l'ordre de p_paires, le débit et les percentiles de latence
+//! \throws logic_error si une requête échoue; l'erreur du premier fil fautif est relancée
+ReseauGTFS::ResultatsLot ReseauGTFS::itinerairesEnLot(const DonneesGTFS &p_gtfs,
+                                                      const vector<pair<Coordonnees, Coordonnees> > &p_paires,
+                                                      unsigned int p_nbFils, bool p_garderChemins) const
+{
+    ResultatsLot resultats;
+    resultats.tempsDuTrajet.assign(p_paires.size(), numeric_limits<unsigned int>::max());
+    resultats.latences.assign(p_paires.size(), 0);
+    if (p_garderChemins) resultats.chemins.resize(p_paires.size());
+
+    timeval debut;
+    timeval fin;
+    if (gettimeofday(&debut, 0) != 0)
+        throw logic_error("ReseauGTFS::itinerairesEnLot(): gettimeofday() a échoué pour debut");
+
+    executerEnParalleleAvecEtat<EtatsRecherche>(p_paires.size(), p_nbFils, [&](size_t i, EtatsRecherche &etats)
+    {
+        timeval tv1;
+        timeval tv2;
+        vector<size_t> chemin;
+        if (gettimeofday(&tv1, 0) != 0)
+            throw logic_error("ReseauGTFS::itinerairesEnLot(): gettimeofday() a échoué pour tv1");
+        Requete requete = preparerRequete(p_paires[i].first, p_paires[i].second);
+        unsigned int temps = plusCourtChemin(requete, chemin, etats);
+        if (gettimeofday(&tv2, 0) != 0)
+            throw logic_error("ReseauGTFS::itinerairesEnLot(): gettimeofday() a échoué pour tv2");
+
+        resultats.tempsDuTrajet[i] = temps;
+        resultats.latences[i] = tempsExecution(tv1, tv2);
+        if (p_garderChemins && temps != numeric_limits<unsigned int>::max())
+        {
+            //on exclut les sommets virtuels origine et destination
+            for (size_t k = 1; k + 1 < chemin.size(); ++k)
+                resultats.chemins[i].push_back(m_arretDuSommet[chemin[k]]);
+        }
+    });
+
+    if (gettimeofday(&fin, 0) != 0)
+        throw logic_error("ReseauGTFS::itinerairesEnLot(): gettimeofday() a échoué pour fin");
+
+    resultats.tempsTotal = tempsExecution(debut, fin);
+    resultats.requetesParSeconde = resultats.tempsTotal > 0 ?
+                                   1e6 * p_paires.size() / resultats.tempsTotal : 0.0;
+    vector<long> latencesTriees(resultats.latences);
+    sort(latencesTriees.begin(), latencesTriees.end());
+    resultats.latenceP50 = percentile(latencesTriees, 0.50);
+    resultats.latenceP90 = percentile(latencesTriees, 0.90);
+    resultats.latenceP99 = percentile(latencesTriees, 0.99);
+
+    return resultats;
+}
+
+//! \brief Calcule les temps de trajet de chaque point origine vers chaque point destination
+//! \brief Une seule recherche de un-vers-tous est faite par origine; les temps de toutes les destinations y sont ensuite lus
+//! \brief Les origines sont réparties entre plusieurs fils d'exécution
+//! \param[in] p_origines: les points origines (lignes de la matrice)
+//! \param[in] p_destinations: les points destinations (colonnes de la matrice)
+//! \param[in] p_heureDepart: l'heure de départ de chaque point origine
+//! \param[in] p_tempsMax: la recherche de chaque origine s'arrête à ce temps de trajet; les destinations plus éloignées sont inatteignables
+//! \param[in] p_nbFils: le nombre de fils d'exécution (0 pour utiliser thread::hardware_concurrency())
+//! \return la matrice des temps de trajet
+//! \throws logic_error si p_heureDepart n'appartient pas à la fenêtre [getDebutFenetre(), getFinFenetre())
+ReseauGTFS::MatriceTempsTrajet ReseauGTFS::matriceTempsTrajet(const vector<Coordonnees> &p_origines,
+                                                              const vector<Coordonnees> &p_destinations,
+                                                              const Heure &p_heureDepart,
+                                                              unsigned int p_tempsMax, unsigned int p_nbFils) const
+{
+    if (p_heureDepart < m_debutFenetre || p_heureDepart >= m_finFenetre)
+        throw logic_error("ReseauGTFS::matriceTempsTrajet(): l'heure de départ est hors de l'intervalle du réseau");
+
+    MatriceTempsTrajet matrice;
+    matrice.nbOrigines = p_origines.size();
+    matrice.nbDestinations = p_destinations.size();
+    matrice.temps.assign(matrice.nbOrigines * matrice.nbDestinations, numeric_limits<unsigned int>::max());
+
+    timeval debut;
+    timeval fin;
+    if (gettimeofday(&debut, 0) != 0)
+        throw logic_error("ReseauGTFS::matriceTempsTrajet(): gettimeofday() a échoué pour debut");
+
+    //les arcs vers chaque destination ne dépendent pas de l'origine: on les calcule une seule fois
+    vector<vector<pair<size_t, unsigned int> > > arcsDesDestinations(p_destinations.size());
+    executerEnParallele(p_destinations.size(), p_nbFils, [&](size_t j)
+    {
+        arcsDesDestinations[j] = arcsVersDestination(p_destinations[j]);
+    });
+
+    executerEnParallele(p_origines.size(), p_nbFils, [&](size_t i, Graphe::EtatRecherche &etat)
+    {
+        Graphe::ArcsVirtuels arcs;
+        arcs.depuisOrigine = arcsDepuisOrigine(p_origines[i], p_heureDepart);
+        m_leGraphe.distancesDepuisOrigine(arcs, p_tempsMax, etat);
+
+        for (size_t j = 0; j < p_destinations.size(); ++j)
+        {
+            unsigned int meilleur = numeric_limits<unsigned int>::max();
+            for (const auto &arc : arcsDesDestinations[j])
+            {
+                unsigned int d = etat.distance[arc.first];
+                if (d == numeric_limits<unsigned int>::max() || d > p_tempsMax || arc.second > p_tempsMax - d)
+                    continue; //arrêt non atteint, ou destination hors de la borne (sans débordement de d + arc.second)
+                meilleur = min(meilleur, d + arc.second);
+            }
+            if (meilleur <= p_tempsMax)
+                matrice.temps[i * matrice.nbDestinations + j] = meilleur;
+        }
+    });
+
+    if (gettimeofday(&fin, 0) != 0)
+        throw logic_error("ReseauGTFS::matriceTempsTrajet(): gettimeofday() a échoué pour fin");
+    matrice.tempsTotal = tempsExecution(debut, fin);
+
+    return matrice;
+}
+
+//! \brief retourne le temps de trajet de l'origine i vers la destination j
+//! \throws out_of_range si i ou j est hors de la matrice
+unsigned int ReseauGTFS::MatriceTempsTrajet::at(size_t i, size_t j) const
+{
+    if (i >= nbOrigines || j >= nbDestinations)
+        throw out_of_range("MatriceTempsTrajet::at(): indice hors de la matrice");
+    return temps[i * nbDestinations + j];
+}
+
+//! \brief écrit la matrice en format CSV: une ligne par origine, une colonne par destination
+//! \brief la première ligne et la première colonne donnent les indices; une case vide indique une destination inatteignable
+//! \throws logic_error si le fichier ne peut pas être écrit
+void ReseauGTFS::MatriceTempsTrajet::ecrireCSV(const std::string &p_nomFichier) const
+{
+    ofstream fichier(p_nomFichier);
+    if (!fichier)
+        throw logic_error("MatriceTempsTrajet::ecrireCSV(): impossible d'ouvrir le fichier " + p_nomFichier);
+
+    fichier << "origine";
+    for (size_t j = 0; j < nbDestinations; ++j)
+        fichier << "," << j;
+    fichier << "\n";
+    for (size_t i = 0; i < nbOrigines; ++i)
+    {
+        fichier << i;
+        for (size_t j = 0; j < nbDestinations; ++j)
+        {
+            fichier << ",";
+            unsigned int t = temps[i * nbDestinations + j];
+            if (t != numeric_limits<unsigned int>::max()) fichier << t;
+        }
+        fichier << "\n";
+    }
+    if (!fichier)
+        throw logic_error("MatriceTempsTrajet::ecrireCSV(): erreur d'écriture dans le fichier " + p_nomFichier);
+}
+
+//! \brief écrit la matrice en format binaire (ordre des octets de la machine)
+//! \brief format: "MTT1", nbOrigines (uint64), nbDestinations (uint64), puis les temps (uint32) ligne par ligne
+//! \brief une destination inatteignable vaut 0xFFFFFFFF
+//! \throws logic_error si le fichier ne peut pas être écrit
+void ReseauGTFS::MatriceTempsTrajet::ecrireBinaire(const std::string &p_nomFichier) const
+{
+    ofstream fichier(p_nomFichier, ios::binary);
+    if (!fichier)
+        throw logic_error("MatriceTempsTrajet::ecrireBinaire(): impossible d'ouvrir le fichier " + p_nomFichier);
+
+    const uint64_t lignes = nbOrigines;
+    const uint64_t colonnes = nbDestinations;
+    fichier.write("MTT1", 4);
+    fichier.write(reinterpret_cast<const char *>(&lignes), sizeof(lignes));
+    fichier.write(reinterpret_cast<const char *>(&colonnes), sizeof(colonnes));
+    for (unsigned int t : temps)
+    {
+        const uint32_t valeur = t;
+        fichier.write(reinterpret_cast<const char *>(&valeur), sizeof(valeur));
+    }
+    if (!fichier)
+        throw logic_error("MatriceTempsTrajet::ecrireBinaire(): erreur d'écriture dans le fichier " + p_nomFichier);
+}
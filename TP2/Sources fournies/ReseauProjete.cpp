@@ -0,0 +1,368 @@
+//
+// Réseau de transport ouvert en mémoire projetée (mmap) à partir d'un fichier écrit par ReseauGTFS::ecrireBinaire()
+//
+
+#include "ReseauProjete.h"
+#include "parallele.h"
+#include "itineraire.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cmath>
+
+using namespace std;
+
+const uint32_t ReseauProjete::version;
+const uint32_t ReseauProjete::valeurBoutisme;
+const uint32_t ReseauProjete::aucun;
+
+//! \brief position, dans le fichier, du début de chaque section et de la fin du fichier
+//! \brief chaque section commence à un multiple de 8 octets
+static vector<size_t> disposition(const ReseauProjete::Entete &p_entete)
+{
+    const size_t tailles[] = {
+            (static_cast<size_t>(p_entete.nbSommets) + 1) * sizeof(uint32_t), //debutArcs
+            static_cast<size_t>(p_entete.nbArcs) * sizeof(ReseauProjete::Arc),
+            static_cast<size_t>(p_entete.nbSommets) * sizeof(uint32_t), //stationDuSommet
+            static_cast<size_t>(p_entete.nbSommets) * sizeof(uint32_t), //voyageDuSommet
+            static_cast<size_t>(p_entete.nbSommets) * sizeof(uint32_t), //heureDuSommet
+            static_cast<size_t>(p_entete.nbStations) * sizeof(ReseauProjete::Station),
+            static_cast<size_t>(p_entete.nbSommets) * sizeof(uint32_t), //sommetsDesStations
+            static_cast<size_t>(p_entete.nbVoyages) * sizeof(ReseauProjete::Voyage),
+            static_cast<size_t>(p_entete.nbNumerosDeLigne) * sizeof(uint32_t),
+            static_cast<size_t>(p_entete.tailleChaines)};
+    vector<size_t> debuts;
+    size_t position = (sizeof(ReseauProjete::Entete) + 7) / 8 * 8;
+    for (size_t taille : tailles)
+    {
+        debuts.push_back(position);
+        position = (position + taille + 7) / 8 * 8;
+    }
+    debuts.push_back(position);
+    return debuts;
+}
+
+//! \brief écrit les tables dans un fichier au format lu par le constructeur
+//! \param[in] p_nomFichier: le fichier à créer (ou à remplacer)
+//! \param[in] p_tables: le contenu du réseau
+//! \throws logic_error si les tables sont incohérentes ou si le fichier ne peut être écrit
+void ReseauProjete::ecrire(const std::string &p_nomFichier, const Tables &p_tables)
+{
+    const size_t n = p_tables.stationDuSommet.size();
+    if (p_tables.debutArcs.size() != n + 1 || p_tables.debutArcs.back() != p_tables.arcs.size() ||
+        p_tables.voyageDuSommet.size() != n || p_tables.heureDuSommet.size() != n ||
+        p_tables.sommetsDesStations.size() != n)
+        throw logic_error("ReseauProjete::ecrire(): les tables du réseau sont incohérentes");
+
+    Entete entete;
+    memset(&entete, 0, sizeof(entete));
+    strncpy(entete.magique, "RESGTFS", sizeof(entete.magique));
+    entete.version = version;
+    entete.boutisme = valeurBoutisme;
+    entete.nbSommets = static_cast<uint32_t>(n);
+    entete.nbArcs = static_cast<uint32_t>(p_tables.arcs.size());
+    entete.nbStations = static_cast<uint32_t>(p_tables.stations.size());
+    entete.nbVoyages = static_cast<uint32_t>(p_tables.voyages.size());
+    entete.nbNumerosDeLigne = static_cast<uint32_t>(p_tables.numerosDeLigne.size());
+    entete.tailleChaines = static_cast<uint32_t>(p_tables.chaines.size());
+    entete.tempsDebut = p_tables.tempsDebut;
+    entete.tempsFin = p_tables.tempsFin;
+    const vector<size_t> debuts = disposition(entete);
+    entete.tailleFichier = debuts.back();
+
+    ofstream fichier(p_nomFichier, ios::binary | ios::trunc);
+    if (!fichier)
+        throw logic_error("ReseauProjete::ecrire(): impossible d'ouvrir le fichier " + p_nomFichier);
+    const pair<const void *, size_t> sections[] = {
+            {p_tables.debutArcs.data(), p_tables.debutArcs.size() * sizeof(uint32_t)},
+            {p_tables.arcs.data(), p_tables.arcs.size() * sizeof(Arc)},
+            {p_tables.stationDuSommet.data(), n * sizeof(uint32_t)},
+            {p_tables.voyageDuSommet.data(), n * sizeof(uint32_t)},
+            {p_tables.heureDuSommet.data(), n * sizeof(uint32_t)},
+            {p_tables.stations.data(), p_tables.stations.size() * sizeof(Station)},
+            {p_tables.sommetsDesStations.data(), n * sizeof(uint32_t)},
+            {p_tables.voyages.data(), p_tables.voyages.size() * sizeof(Voyage)},
+            {p_tables.numerosDeLigne.data(), p_tables.numerosDeLigne.size() * sizeof(uint32_t)},
+            {p_tables.chaines.data(), p_tables.chaines.size()}};
+    const char zeros[8] = {};
+    fichier.write(reinterpret_cast<const char *>(&entete), sizeof(entete));
+    size_t position = sizeof(entete);
+    for (size_t i = 0; i < 10; ++i)
+    {
+        fichier.write(zeros, debuts[i] - position);
+        fichier.write(static_cast<const char *>(sections[i].first), sections[i].second);
+        position = debuts[i] + sections[i].second;
+    }
+    fichier.write(zeros, debuts.back() - position);
+    if (!fichier)
+        throw logic_error("ReseauProjete::ecrire(): erreur d'écriture dans le fichier " + p_nomFichier);
+}
+
+//! \brief projette en mémoire (en lecture seule) un fichier écrit par ReseauGTFS::ecrireBinaire()
+//! \brief les tables sont parcourues une fois pour être validées, puis les stations sont indexées
+//! \param[in] p_nomFichier: le fichier à ouvrir
+//! \throws logic_error si le fichier ne peut être projeté, n'est pas un réseau, est d'une autre version, a été écrit
+//! \throws logic_error par une machine de boutisme différent, est tronqué ou si ses tables sont incohérentes
+ReseauProjete::ReseauProjete(const std::string &p_nomFichier)
+        : m_adresse(MAP_FAILED), m_taille(0)
+{
+    int descripteur = open(p_nomFichier.c_str(), O_RDONLY);
+    if (descripteur < 0)
+        throw logic_error("ReseauProjete::ReseauProjete(): impossible d'ouvrir le fichier " + p_nomFichier);
+    struct stat etat;
+    if (fstat(descripteur, &etat) != 0 || static_cast<size_t>(etat.st_size) < sizeof(Entete))
+    {
+        close(descripteur);
+        throw logic_error("ReseauProjete::ReseauProjete(): le fichier " + p_nomFichier + " est trop court");
+    }
+    m_taille = static_cast<size_t>(etat.st_size);
+    m_adresse = mmap(nullptr, m_taille, PROT_READ, MAP_SHARED, descripteur, 0);
+    close(descripteur); //la projection reste valide
+    if (m_adresse == MAP_FAILED)
+        throw logic_error("ReseauProjete::ReseauProjete(): mmap() a échoué pour le fichier " + p_nomFichier);
+
+    m_entete = static_cast<const Entete *>(m_adresse);
+    string erreur;
+    if (strncmp(m_entete->magique, "RESGTFS", sizeof(m_entete->magique)) != 0)
+        erreur = "le fichier n'est pas un réseau";
+    else if (m_entete->boutisme != valeurBoutisme)
+        erreur = "le fichier a été écrit par une machine de boutisme différent";
+    else if (m_entete->version != version)
+        erreur = "version " + to_string(m_entete->version) + " du format, " + to_string(version) + " attendue";
+    else if (m_entete->tailleFichier != m_taille || disposition(*m_entete).back() != m_taille)
+        erreur = "le fichier est tronqué ou incohérent";
+    if (!erreur.empty())
+    {
+        munmap(m_adresse, m_taille);
+        throw logic_error("ReseauProjete::ReseauProjete(): " + p_nomFichier + ": " + erreur);
+    }
+
+    const vector<size_t> debuts = disposition(*m_entete);
+    const char *base = static_cast<const char *>(m_adresse);
+    m_debutArcs = reinterpret_cast<const uint32_t *>(base + debuts[0]);
+    m_arcs = reinterpret_cast<const Arc *>(base + debuts[1]);
+    m_stationDuSommet = reinterpret_cast<const uint32_t *>(base + debuts[2]);
+    m_voyageDuSommet = reinterpret_cast<const uint32_t *>(base + debuts[3]);
+    m_heureDuSommet = reinterpret_cast<const uint32_t *>(base + debuts[4]);
+    m_stations = reinterpret_cast<const Station *>(base + debuts[5]);
+    m_sommetsDesStations = reinterpret_cast<const uint32_t *>(base + debuts[6]);
+    m_voyages = reinterpret_cast<const Voyage *>(base + debuts[7]);
+    m_numerosDeLigne = reinterpret_cast<const uint32_t *>(base + debuts[8]);
+    m_chaines = base + debuts[9];
+
+    erreur = incoherence();
+    if (!erreur.empty())
+    {
+        munmap(m_adresse, m_taille);
+        throw logic_error("ReseauProjete::ReseauProjete(): " + p_nomFichier + ": " + erreur);
+    }
+
+    vector<Coordonnees> coordonnees;
+    coordonnees.reserve(m_entete->nbStations);
+    for (uint32_t s = 0; s < m_entete->nbStations; ++s)
+        coordonnees.push_back(Coordonnees(m_stations[s].latitude, m_stations[s].longitude));
+    m_indexStations.reset(new IndexStations(coordonnees, distanceMaxMarche / 2));
+}
+
+//! \brief vérifie que les tables projetées ne réfèrent qu'à des éléments existants, afin qu'aucune requête ne lise
+//! \brief hors de la projection
+//! \return la description de la première incohérence trouvée; une chaîne vide si les tables sont cohérentes
+std::string ReseauProjete::incoherence() const
+{
+    const Entete &entete = *m_entete;
+    const uint32_t n = entete.nbSommets;
+    if (entete.tempsDebut > entete.tempsFin)
+        return "l'intervalle des heures de départ est vide";
+    if (entete.tailleChaines > 0 && m_chaines[entete.tailleChaines - 1] != '\0')
+        return "la dernière chaîne n'est pas terminée";
+
+    //graphe (CSR)
+    if (m_debutArcs[0] != 0 || m_debutArcs[n] != entete.nbArcs)
+        return "les bornes des arcs ne couvrent pas la table des arcs";
+    for (uint32_t i = 0; i < n; ++i)
+        if (m_debutArcs[i] > m_debutArcs[i + 1])
+            return "les débuts des arcs du sommet " + to_string(i) + " ne sont pas croissants";
+    for (uint32_t k = 0; k < entete.nbArcs; ++k)
+        if (m_arcs[k].destination >= n)
+            return "l'arc " + to_string(k) + " mène à un sommet inexistant";
+
+    //correspondance sommet-arrêt
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (m_stationDuSommet[i] >= entete.nbStations) return "le sommet " + to_string(i) + " a une station inexistante";
+        if (m_voyageDuSommet[i] >= entete.nbVoyages) return "le sommet " + to_string(i) + " a un voyage inexistant";
+        if (m_sommetsDesStations[i] >= n) return "sommetsDesStations réfère à un sommet inexistant";
+    }
+
+    //stations, voyages et numéros de ligne
+    for (uint32_t s = 0; s < entete.nbStations; ++s)
+    {
+        const Station &station = m_stations[s];
+        if (station.id >= entete.tailleChaines || station.nom >= entete.tailleChaines)
+            return "la station " + to_string(s) + " réfère à une chaîne inexistante";
+        if (station.debutSommets > finSommets(s) || (s == 0 && station.debutSommets != 0))
+            return "les sommets de la station " + to_string(s) + " ne suivent pas ceux de la précédente";
+    }
+    for (uint32_t v = 0; v < entete.nbVoyages; ++v)
+        if (m_voyages[v].destination >= entete.tailleChaines || m_voyages[v].numeroDeLigne >= entete.nbNumerosDeLigne)
+            return "le voyage " + to_string(v) + " réfère à un élément inexistant";
+    for (uint32_t l = 0; l < entete.nbNumerosDeLigne; ++l)
+        if (m_numerosDeLigne[l] >= entete.tailleChaines)
+            return "le numéro de ligne " + to_string(l) + " réfère à une chaîne inexistante";
+    return "";
+}
+
+ReseauProjete::~ReseauProjete()
+{
+    munmap(m_adresse, m_taille);
+}
+
+size_t ReseauProjete::getNbSommets() const
+{
+    return m_entete->nbSommets;
+}
+
+size_t ReseauProjete::getNbArcs() const
+{
+    return m_entete->nbArcs;
+}
+
+size_t ReseauProjete::getTailleFichier() const
+{
+    return m_taille;
+}
+
+Heure ReseauProjete::getTempsDebut() const
+{
+    return heure(m_entete->tempsDebut);
+}
+
+Heure ReseauProjete::getTempsFin() const
+{
+    return heure(m_entete->tempsFin);
+}
+
+//! \brief retourne la chaîne rangée à une position donnée de la section des chaînes
+//! \throws logic_error si la position est hors de la section
+const char *ReseauProjete::chaine(uint32_t p_position) const
+{
+    if (p_position >= m_entete->tailleChaines)
+        throw logic_error("ReseauProjete::chaine(): position hors du fichier");
+    return m_chaines + p_position;
+}
+
+Heure ReseauProjete::heure(uint32_t p_secondes) const
+{
+    return Heure(0, 0, 0).add_secondes(p_secondes);
+}
+
+//! \brief retourne l'indice, dans m_sommetsDesStations, qui suit le dernier sommet d'une station
+uint32_t ReseauProjete::finSommets(uint32_t p_station) const
+{
+    return p_station + 1 < m_entete->nbStations ? m_stations[p_station + 1].debutSommets : m_entete->nbSommets;
+}
+
+//! \brief affiche une station comme le fait l'opérateur << de Station
+void ReseauProjete::afficherStation(uint32_t p_station) const
+{
+    const Station &station = m_stations[p_station];
+    cout << chaine(station.id) << " - " << chaine(station.nom) << " " << Coordonnees(station.latitude, station.longitude);
+}
+
+//! \brief Trouve le plus court chemin d'un point origine à un point destination, comme ReseauGTFS::itineraire()
+//! \brief Les arcs du point origine (premier départ de chaque ligne aux stations accessibles à pieds) et ceux vers le
+//! \brief point destination sont construits pour la requête; la recherche (Dijkstra) lit le graphe dans la projection
+//! \brief Cette méthode peut être appelée simultanément par plusieurs fils d'exécution
+//! \param[in] p_pointOrigine: les coordonnées GPS du point origine
+//! \param[in] p_pointDestination: les coordonnées GPS du point destination
+//! \param[in] p_heureDepart: l'heure de départ du point origine
+//! \param[in] p_afficherItineraire: true si on désire afficher l'itinéraire et false autrement
+//! \param[out] p_tempsExecution: le temps d'exécution de la requête, en microsecondes
+//! \returns le temps du trajet en secondes (= numeric_limits<unsigned_int>::max() si la destination n'est pas atteignable)
+//! \throws logic_error si p_heureDepart n'appartient pas à l'intervalle [getTempsDebut(), getTempsFin())
+unsigned int ReseauProjete::itineraire(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination,
+                                       const Heure &p_heureDepart, bool p_afficherItineraire,
+                                       long &p_tempsExecution) const
+{
+    if (p_heureDepart < getTempsDebut() || p_heureDepart >= getTempsFin())
+        throw logic_error("ReseauProjete::itineraire(): l'heure de départ est hors de l'intervalle du réseau");
+
+    timeval tv1;
+    timeval tv2;
+    if (gettimeofday(&tv1, 0) != 0)
+        throw logic_error("ReseauProjete::itineraire(): gettimeofday() a échoué pour tv1");
+
+    const uint32_t n = m_entete->nbSommets;
+    const unsigned int depart = static_cast<unsigned int>(p_heureDepart - Heure(0, 0, 0));
+
+    //arcs du point origine et vers le point destination; mêmes règles que ReseauGTFS
+    GrapheIndices32::ArcsVirtuels arcs;
+    vector<uint32_t> ligneDejaUtilisee(m_entete->nbNumerosDeLigne, 0);
+    uint32_t epoque = 0;
+    for (const auto &voisin : m_indexStations->dansRayon(p_pointOrigine, distanceMaxMarche, true))
+    {
+        const uint32_t s = voisin.indice;
+        const uint32_t *debut = m_sommetsDesStations + m_stations[s].debutSommets;
+        const uint32_t *fin = m_sommetsDesStations + finSommets(s);
+        ++epoque;
+        uint32_t nbLignesUtilisees = 0;
+        const unsigned int premiereHeure = static_cast<unsigned int>(
+                p_heureDepart.add_secondes(voisin.distance / vitesseDeMarche * 3600) - Heure(0, 0, 0));
+        const uint32_t *sommet = lower_bound(debut, fin, premiereHeure, [this](uint32_t p_sommet, unsigned int p_heure)
+        {
+            return m_heureDuSommet[p_sommet] < p_heure;
+        });
+        for (; sommet != fin && nbLignesUtilisees < m_stations[s].nbLignes; ++sommet)
+        {
+            const uint32_t ligne = m_voyages[m_voyageDuSommet[*sommet]].numeroDeLigne;
+            if (ligneDejaUtilisee[ligne] == epoque) continue;
+            ligneDejaUtilisee[ligne] = epoque;
+            ++nbLignesUtilisees;
+            arcs.depuisOrigine.push_back({*sommet, m_heureDuSommet[*sommet] - depart});
+        }
+    }
+    for (const auto &voisin : m_indexStations->dansRayon(p_pointDestination, distanceMaxMarche, true))
+    {
+        const unsigned int poids = static_cast<unsigned int>(voisin.distance / vitesseDeMarche * 3600);
+        for (uint32_t k = m_stations[voisin.indice].debutSommets; k < finSommets(voisin.indice); ++k)
+            arcs.versDestination.push_back({m_sommetsDesStations[k], poids});
+    }
+
+    GrapheIndices32::EtatRecherche etat;
+    vector<uint32_t> chemin;
+    dijkstraVirtuel(*this, n, arcs, numeric_limits<unsigned int>::max(), true, etat);
+    const unsigned int tempsDuTrajet = cheminDepuisOrigine(etat, n + 1, chemin);
+
+    if (gettimeofday(&tv2, 0) != 0)
+        throw logic_error("ReseauProjete::itineraire(): gettimeofday() a échoué pour tv2");
+    p_tempsExecution = tempsExecution(tv1, tv2);
+
+    //les sommets virtuels ont leur propre station et leur propre voyage, comme les arrêts fantômes de ReseauGTFS
+    struct Parcours
+    {
+        const ReseauProjete &reseau;
+        uint32_t n;
+
+        bool estOrigine(size_t p_sommet) const { return p_sommet == n; }
+        bool estDestination(size_t p_sommet) const { return p_sommet == n + 1; }
+        uint32_t station(size_t p_sommet) const
+        {
+            return p_sommet < n ? reseau.m_stationDuSommet[p_sommet] : aucun - static_cast<uint32_t>(p_sommet - n);
+        }
+        uint32_t voyage(size_t p_sommet) const
+        {
+            return p_sommet < n ? reseau.m_voyageDuSommet[p_sommet] : aucun - static_cast<uint32_t>(p_sommet - n);
+        }
+        Heure heureArrivee(size_t p_sommet) const { return reseau.heure(reseau.m_heureDuSommet[p_sommet]); }
+        void afficherStation(size_t p_sommet) const { reseau.afficherStation(station(p_sommet)); }
+        void afficherCourse(size_t p_sommet) const
+        {
+            const Voyage &leVoyage = reseau.m_voyages[voyage(p_sommet)];
+            cout << reseau.chaine(reseau.m_numerosDeLigne[leVoyage.numeroDeLigne]) << " à l'heure "
+                 << heureArrivee(p_sommet) << " Vers " << reseau.chaine(leVoyage.destination);
+        }
+    };
+    return afficherItineraire(Parcours{*this, n}, chemin, p_heureDepart, tempsDuTrajet, p_afficherItineraire);
+}
@@ -0,0 +1,134 @@
+//
+// Réseau de transport ouvert en mémoire projetée (mmap) à partir d'un fichier écrit par ReseauGTFS::ecrireBinaire()
+//
+
+#ifndef TP2_RESEAUPROJETE_H
+#define TP2_RESEAUPROJETE_H
+
+#include "DonneesGTFS.h"
+#include "graphe.h"
+#include "indexStations.h"
+#include "parametresMarche.h"
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+//! \brief Réseau déjà construit, lu directement dans un fichier binaire projeté en mémoire
+//! \brief Le fichier contient le graphe (format CSR), la correspondance sommet-arrêt ainsi que les tables de stations,
+//! \brief de voyages et de numéros de ligne nécessaires pour préparer une requête et afficher l'itinéraire: ni
+//! \brief DonneesGTFS ni ReseauGTFS ne sont requis. Les pages sont partagées entre les processus qui ouvrent le même
+//! \brief fichier; l'ouverture les parcourt une fois pour valider les tables (voir incoherence()).
+//! \brief Les règles des requêtes (marche, premier départ par ligne) sont celles de ReseauGTFS, et la recherche et
+//! \brief l'affichage de l'itinéraire sont les mêmes (voir dijkstraVirtuel() et afficherItineraire()).
+class ReseauProjete
+{
+
+public:
+    //! \brief entête du fichier; toutes les sections suivent dans l'ordre de Tables, chacune alignée sur 8 octets
+    struct Entete
+    {
+        char magique[8]; //"RESGTFS"
+        uint32_t version;
+        uint32_t boutisme; //valeurBoutisme, telle qu'écrite par la machine qui a produit le fichier
+        uint32_t nbSommets;
+        uint32_t nbArcs;
+        uint32_t nbStations;
+        uint32_t nbVoyages;
+        uint32_t nbNumerosDeLigne;
+        uint32_t tailleChaines;
+        uint32_t tempsDebut; //intervalle [tempsDebut, tempsFin) des heures de départ permises, en secondes depuis minuit
+        uint32_t tempsFin;
+        uint64_t tailleFichier;
+    };
+
+    struct Arc
+    {
+        uint32_t destination;
+        uint32_t poids;
+    };
+
+    struct Station
+    {
+        double latitude;
+        double longitude;
+        uint32_t id; //position de l'identifiant dans les chaînes
+        uint32_t nom; //position du nom dans les chaînes
+        uint32_t debutSommets; //indice du premier sommet de la station dans sommetsDesStations
+        uint32_t nbLignes; //nombre de numéros de ligne distincts desservant la station
+    };
+
+    struct Voyage
+    {
+        uint32_t destination; //position de la destination (affichée « Vers ... ») dans les chaînes
+        uint32_t numeroDeLigne; //indice dans numerosDeLigne
+    };
+
+    //! \brief contenu du fichier, tel que préparé par ReseauGTFS::ecrireBinaire()
+    struct Tables
+    {
+        uint32_t tempsDebut;
+        uint32_t tempsFin;
+        std::vector<uint32_t> debutArcs; //CSR: arcs du sommet i dans [debutArcs[i], debutArcs[i + 1])
+        std::vector<Arc> arcs;
+        std::vector<uint32_t> stationDuSommet;
+        std::vector<uint32_t> voyageDuSommet;
+        std::vector<uint32_t> heureDuSommet; //heure d'arrivée, en secondes depuis minuit
+        std::vector<Station> stations;
+        std::vector<uint32_t> sommetsDesStations; //les sommets de chaque station, par heure d'arrivée
+        std::vector<Voyage> voyages;
+        std::vector<uint32_t> numerosDeLigne; //position de chaque numéro de ligne dans les chaînes
+        std::vector<char> chaines; //chaînes terminées par '\0'
+    };
+
+    static const uint32_t version = 1;
+    static const uint32_t valeurBoutisme = 0x01020304;
+
+    static void ecrire(const std::string &, const Tables &);
+
+    explicit ReseauProjete(const std::string &);
+    ~ReseauProjete();
+    ReseauProjete(const ReseauProjete &) = delete;
+    ReseauProjete &operator=(const ReseauProjete &) = delete;
+
+    unsigned int itineraire(const Coordonnees &, const Coordonnees &, const Heure &, bool, long &) const;
+    size_t getNbSommets() const;
+    size_t getNbArcs() const;
+    size_t getTailleFichier() const;
+    Heure getTempsDebut() const;
+    Heure getTempsFin() const;
+
+    //! \brief appelle p_visiteur(destination, poids) pour chaque arc sortant de p_sommet (voir dijkstraVirtuel())
+    template<typename Visiteur>
+    void pourChaqueArc(size_t p_sommet, Visiteur p_visiteur) const
+    {
+        for (uint32_t k = m_debutArcs[p_sommet]; k < m_debutArcs[p_sommet + 1]; ++k)
+            p_visiteur(m_arcs[k].destination, m_arcs[k].poids);
+    }
+
+private:
+    static const uint32_t aucun = std::numeric_limits<uint32_t>::max();
+
+    void *m_adresse; //début de la projection
+    size_t m_taille;
+    const Entete *m_entete;
+    const uint32_t *m_debutArcs;
+    const Arc *m_arcs;
+    const uint32_t *m_stationDuSommet;
+    const uint32_t *m_voyageDuSommet;
+    const uint32_t *m_heureDuSommet;
+    const Station *m_stations;
+    const uint32_t *m_sommetsDesStations;
+    const Voyage *m_voyages;
+    const uint32_t *m_numerosDeLigne;
+    const char *m_chaines;
+    std::unique_ptr<IndexStations> m_indexStations; //grille des stations, pour les arcs du point origine et vers le point destination
+
+    std::string incoherence() const;
+    const char *chaine(uint32_t) const;
+    Heure heure(uint32_t) const;
+    void afficherStation(uint32_t) const;
+    uint32_t finSommets(uint32_t) const;
+};
+
+
+#endif //TP2_RESEAUPROJETE_H
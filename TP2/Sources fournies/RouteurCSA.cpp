@@ -0,0 +1,412 @@
+//
+// Routeur par balayage de connexions (Connection Scan Algorithm)
+//
+
+#include "RouteurCSA.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <functional>
+
+using namespace std;
+
+const uint32_t RouteurCSA::infini;
+
+//! \brief retourne une heure en secondes depuis minuit
+static uint32_t enSecondes(const Heure &p_heure)
+{
+    return static_cast<uint32_t>(p_heure - Heure(0, 0, 0));
+}
+
+//! \brief construit le tableau de connexions et les transferts à partir des données GTFS
+//! \param[in] p_gtfs: un objet DonneesGTFS dont tous les arrêts et transferts ont été ajoutés
+//! \post m_connexions contient une connexion par paire d'arrêts consécutifs de chaque voyage, triées par heure de départ
+//! \throws logic_error si un transfert ou un arrêt réfère à une station inconnue
+RouteurCSA::RouteurCSA(const DonneesGTFS &p_gtfs)
+{
+    unordered_map<string, uint32_t> indiceStation;
+    for (const auto &station : p_gtfs.getStations())
+    {
+        indiceStation.insert({station.first, static_cast<uint32_t>(m_stationIds.size())});
+        m_stationIds.push_back(station.first);
+        m_coordonnees.push_back(station.second.getCoords());
+        m_attentePermise.push_back(p_gtfs.getStationsDeTransfert().find(station.first) ==
+                                   p_gtfs.getStationsDeTransfert().end());
+    }
+
+    //transferts regroupés par station de départ (format CSR)
+    m_debutTransferts.assign(m_stationIds.size() + 1, 0);
+    vector<tuple<uint32_t, uint32_t, uint32_t> > transferts;
+    for (const auto &transfert : p_gtfs.getTransferts())
+    {
+        auto de = indiceStation.find(get<0>(transfert));
+        auto vers = indiceStation.find(get<1>(transfert));
+        if (de == indiceStation.end() || vers == indiceStation.end())
+            throw logic_error("RouteurCSA::RouteurCSA(): un transfert réfère à une station inconnue");
+        transferts.push_back(make_tuple(de->second, vers->second, get<2>(transfert)));
+    }
+    sort(transferts.begin(), transferts.end());
+    for (const auto &t : transferts)
+    {
+        ++m_debutTransferts[get<0>(t) + 1];
+        m_transferts.push_back({get<1>(t), get<2>(t)});
+    }
+    for (size_t s = 0; s < m_stationIds.size(); ++s)
+        m_debutTransferts[s + 1] += m_debutTransferts[s];
+
+    //les mêmes transferts, regroupés par station d'arrivée, pour la recherche de profil
+    m_debutTransfertsInverses.assign(m_stationIds.size() + 1, 0);
+    sort(transferts.begin(), transferts.end(), [](const tuple<uint32_t, uint32_t, uint32_t> &a,
+                                                  const tuple<uint32_t, uint32_t, uint32_t> &b)
+    {
+        return get<1>(a) < get<1>(b) || (get<1>(a) == get<1>(b) && get<0>(a) < get<0>(b));
+    });
+    for (const auto &t : transferts)
+    {
+        ++m_debutTransfertsInverses[get<1>(t) + 1];
+        m_transfertsInverses.push_back({get<0>(t), get<2>(t)});
+    }
+    for (size_t s = 0; s < m_stationIds.size(); ++s)
+        m_debutTransfertsInverses[s + 1] += m_debutTransfertsInverses[s];
+
+    m_connexions.reserve(p_gtfs.getNbArrets());
+    for (const auto &voyage : p_gtfs.getVoyages())
+    {
+        const uint32_t v = static_cast<uint32_t>(m_voyageIds.size());
+        m_voyageIds.push_back(voyage.first);
+        const auto &arrets = voyage.second.getArrets();
+        for (auto arret = arrets.begin(), suivant = next(arrets.begin()); suivant != arrets.end(); ++arret, ++suivant)
+        {
+            auto de = indiceStation.find((*arret)->getStationId());
+            auto vers = indiceStation.find((*suivant)->getStationId());
+            if (de == indiceStation.end() || vers == indiceStation.end())
+                throw logic_error("RouteurCSA::RouteurCSA(): un arrêt réfère à une station inconnue");
+            //comme dans ReseauGTFS, les heures d'arrivée servent d'heures de passage
+            m_connexions.push_back({enSecondes((*arret)->getHeureArrivee()), enSecondes((*suivant)->getHeureArrivee()),
+                                    de->second, vers->second, v});
+        }
+    }
+    //tri stable: les connexions simultanées d'un même voyage restent dans l'ordre du voyage, dans un sens comme dans l'autre
+    stable_sort(m_connexions.begin(), m_connexions.end(), [](const Connexion &a, const Connexion &b)
+    {
+        return a.depart < b.depart || (a.depart == b.depart && a.arrivee < b.arrivee);
+    });
+    m_connexions.shrink_to_fit();
+}
+
+size_t RouteurCSA::getNbConnexions() const
+{
+    return m_connexions.size();
+}
+
+//! \brief retourne une estimation du nombre d'octets occupés par les structures du routeur
+size_t RouteurCSA::getTailleMemoire() const
+{
+    size_t taille = m_connexions.capacity() * sizeof(Connexion)
+                    + m_coordonnees.capacity() * sizeof(Coordonnees)
+                    + m_attentePermise.capacity() / 8
+                    + m_debutTransferts.capacity() * sizeof(uint32_t)
+                    + m_transferts.capacity() * sizeof(pair<uint32_t, uint32_t>)
+                    + m_debutTransfertsInverses.capacity() * sizeof(uint32_t)
+                    + m_transfertsInverses.capacity() * sizeof(pair<uint32_t, uint32_t>);
+    for (const auto &id : m_stationIds) taille += sizeof(string) + id.capacity();
+    for (const auto &id : m_voyageIds) taille += sizeof(string) + id.capacity();
+    return taille;
+}
+
+//! \brief Trouve l'heure d'arrivée la plus hâtive du point origine au point destination en balayant les connexions
+//! \param[in] p_pointOrigine: les coordonnées GPS du point origine
+//! \param[in] p_pointDestination: les coordonnées GPS du point destination
+//! \param[in] p_heureDepart: l'heure de départ du point origine
+//! \param[out] p_troncons: si non nul, reçoit les tronçons de l'itinéraire trouvé (vide si inatteignable)
+//! \return le temps du trajet en secondes (= numeric_limits<unsigned int>::max() si la destination n'est pas atteignable)
+unsigned int RouteurCSA::itineraire(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination,
+                                    const Heure &p_heureDepart, vector<Troncon> *p_troncons) const
+{
+    const size_t nbStations = m_stationIds.size();
+    const uint32_t depart = enSecondes(p_heureDepart);
+
+    vector<uint32_t> pret(nbStations, infini); //heure à partir de laquelle on peut monter à bord à la station
+    vector<uint32_t> pretDepuis(nbStations, infini); //station d'où provient pret[] (infini: point origine)
+    vector<bool> pretParAutobus(nbStations, false); //true si pret[] découle de l'arrivée en autobus à pretDepuis[]
+    vector<uint32_t> atteinte(nbStations, infini); //heure d'arrivée en autobus à la station
+    vector<uint32_t> entree(nbStations, infini); //connexions d'embarquement et de débarquement de ce dernier voyage
+    vector<uint32_t> sortie(nbStations, infini);
+    vector<uint32_t> embarquement(m_voyageIds.size(), infini); //connexion où l'on est monté à bord du voyage
+    vector<uint32_t> marcheDestination(nbStations, infini);
+
+    uint32_t meilleureArrivee = infini;
+    uint32_t stationFinale = infini;
+    bool finaleEnAutobus = false;
+
+    //met à jour pret[p_vers], puis propage les transferts qui partent de p_vers
+    vector<uint32_t> aPropager;
+    auto rendrePret = [&](uint32_t p_vers, uint32_t p_heure, uint32_t p_de, bool p_parAutobus)
+    {
+        if (p_heure >= pret[p_vers]) return;
+        pret[p_vers] = p_heure;
+        pretDepuis[p_vers] = p_de;
+        pretParAutobus[p_vers] = p_parAutobus;
+        aPropager.push_back(p_vers);
+        while (!aPropager.empty())
+        {
+            uint32_t s = aPropager.back();
+            aPropager.pop_back();
+            if (pretDepuis[s] != infini && marcheDestination[s] != infini &&
+                pret[s] + marcheDestination[s] < meilleureArrivee)
+            {
+                meilleureArrivee = pret[s] + marcheDestination[s];
+                stationFinale = s;
+                finaleEnAutobus = false;
+            }
+            for (uint32_t t = m_debutTransferts[s]; t < m_debutTransferts[s + 1]; ++t)
+            {
+                uint32_t vers = m_transferts[t].first;
+                uint32_t heure = pret[s] + m_transferts[t].second;
+                if (heure < pret[vers])
+                {
+                    pret[vers] = heure;
+                    pretDepuis[vers] = s;
+                    pretParAutobus[vers] = false;
+                    aPropager.push_back(vers);
+                }
+            }
+        }
+    };
+
+    for (size_t s = 0; s < nbStations; ++s)
+    {
+        double distanceDestination = p_pointDestination - m_coordonnees[s];
+        if (std::isnan(distanceDestination)) distanceDestination = 0; //point confondu avec la station
+        if (distanceDestination <= distanceMaxMarche)
+            marcheDestination[s] = static_cast<uint32_t>(distanceDestination / vitesseDeMarche * 3600);
+    }
+    for (uint32_t s = 0; s < nbStations; ++s)
+    {
+        double distanceOrigine = p_pointOrigine - m_coordonnees[s];
+        if (std::isnan(distanceOrigine)) distanceOrigine = 0; //point confondu avec la station
+        if (distanceOrigine <= distanceMaxMarche)
+            rendrePret(s, depart + static_cast<uint32_t>(distanceOrigine / vitesseDeMarche * 3600), infini, false);
+    }
+
+    auto premiere = lower_bound(m_connexions.begin(), m_connexions.end(), depart,
+                                [](const Connexion &c, uint32_t h) { return c.depart < h; });
+    for (auto c = premiere; c != m_connexions.end(); ++c)
+    {
+        if (c->depart >= meilleureArrivee) break; //aucune connexion restante ne peut améliorer l'arrivée
+        const uint32_t indice = static_cast<uint32_t>(c - m_connexions.begin());
+
+        if (embarquement[c->voyage] == infini)
+        {
+            if (pret[c->stationDepart] > c->depart) continue;
+            embarquement[c->voyage] = indice;
+        }
+
+        const uint32_t s = c->stationArrivee;
+        if (c->arrivee >= atteinte[s]) continue;
+        atteinte[s] = c->arrivee;
+        entree[s] = embarquement[c->voyage];
+        sortie[s] = indice;
+
+        if (marcheDestination[s] != infini && c->arrivee + marcheDestination[s] < meilleureArrivee)
+        {
+            meilleureArrivee = c->arrivee + marcheDestination[s];
+            stationFinale = s;
+            finaleEnAutobus = true;
+        }
+        if (m_attentePermise[s]) rendrePret(s, c->arrivee + delaisMinArcsAttente, s, true);
+        for (uint32_t t = m_debutTransferts[s]; t < m_debutTransferts[s + 1]; ++t)
+            rendrePret(m_transferts[t].first, c->arrivee + m_transferts[t].second, s, true);
+    }
+
+    if (p_troncons) p_troncons->clear();
+    if (meilleureArrivee == infini) return numeric_limits<unsigned int>::max();
+
+    if (p_troncons)
+    {
+        //on remonte l'itinéraire de la station finale jusqu'au point origine
+        vector<Troncon> troncons;
+        uint32_t s = stationFinale;
+        bool enAutobus = finaleEnAutobus;
+        while (true)
+        {
+            if (enAutobus)
+            {
+                const Connexion &premiereConnexion = m_connexions[entree[s]];
+                const Connexion &derniereConnexion = m_connexions[sortie[s]];
+                troncons.push_back({m_voyageIds[premiereConnexion.voyage], m_stationIds[premiereConnexion.stationDepart],
+                                    m_stationIds[derniereConnexion.stationArrivee], premiereConnexion.depart,
+                                    derniereConnexion.arrivee});
+                s = premiereConnexion.stationDepart;
+            }
+            //on est prêt à la station s: soit à pieds du point origine, soit après un autobus ou un transfert
+            uint32_t precedente = pretDepuis[s];
+            if (precedente == infini) break; //on a marché du point origine
+            if (precedente != s)
+                troncons.push_back({"", m_stationIds[precedente], m_stationIds[s],
+                                    pretParAutobus[s] ? atteinte[precedente] : pret[precedente], pret[s]});
+            enAutobus = pretParAutobus[s];
+            s = precedente;
+        }
+        reverse(troncons.begin(), troncons.end());
+        *p_troncons = troncons;
+    }
+
+    return meilleureArrivee - depart;
+}
+
+//! \brief Trouve en un seul balayage tous les trajets non dominés partant du point origine dans un intervalle
+//! \brief Les connexions sont balayées de la plus tardive à la plus hâtive; chaque station conserve son profil: les
+//! \brief paires (heure à laquelle on est prêt à la station, heure d'arrivée à destination) non dominées
+//! \param[in] p_pointOrigine: les coordonnées GPS du point origine
+//! \param[in] p_pointDestination: les coordonnées GPS du point destination
+//! \param[in] p_debut: l'heure de départ la plus hâtive
+//! \param[in] p_fin: l'heure de départ la plus tardive
+//! \param[out] p_tempsAPieds: si non nul, reçoit la durée d'un trajet fait uniquement à pieds (par des transferts), ou
+//! \param[out] numeric_limits<unsigned int>::max() s'il n'y en a pas; les trajets plus lents que ce dernier sont omis
+//! \return les trajets de l'ensemble de Pareto (partir plus tard, arriver plus tôt), triés par heure de départ;
+//! \return pour une heure de départ t de l'intervalle, le premier trajet partant à t ou après donne l'arrivée la plus
+//! \return hâtive (le dernier trajet peut donc partir après p_fin)
+//! \throws logic_error si p_fin précède p_debut
+vector<RouteurCSA::Trajet> RouteurCSA::profil(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination,
+                                              const Heure &p_debut, const Heure &p_fin,
+                                              unsigned int *p_tempsAPieds) const
+{
+    if (p_fin < p_debut)
+        throw logic_error("RouteurCSA::profil(): l'intervalle de départ est vide");
+    const size_t nbStations = m_stationIds.size();
+    const uint32_t debut = enSecondes(p_debut);
+    const uint32_t fin = enSecondes(p_fin);
+
+    //durée minimale pour marcher de chaque station jusqu'au point destination, en empruntant au besoin des transferts
+    vector<uint32_t> marcheDestination(nbStations, infini);
+    priority_queue<pair<uint32_t, uint32_t>, vector<pair<uint32_t, uint32_t> >,
+            greater<pair<uint32_t, uint32_t> > > file;
+    for (uint32_t s = 0; s < nbStations; ++s)
+    {
+        double distanceDestination = p_pointDestination - m_coordonnees[s];
+        if (std::isnan(distanceDestination)) distanceDestination = 0; //point confondu avec la station
+        if (distanceDestination <= distanceMaxMarche)
+        {
+            marcheDestination[s] = static_cast<uint32_t>(distanceDestination / vitesseDeMarche * 3600);
+            file.push({marcheDestination[s], s});
+        }
+    }
+    while (!file.empty())
+    {
+        pair<uint32_t, uint32_t> courant = file.top();
+        file.pop();
+        if (courant.first > marcheDestination[courant.second]) continue;
+        for (uint32_t t = m_debutTransfertsInverses[courant.second]; t < m_debutTransfertsInverses[courant.second + 1]; ++t)
+        {
+            uint32_t de = m_transfertsInverses[t].first;
+            uint32_t duree = courant.first + m_transfertsInverses[t].second;
+            if (duree < marcheDestination[de])
+            {
+                marcheDestination[de] = duree;
+                file.push({duree, de});
+            }
+        }
+    }
+
+    //profils des stations: (prêt à, arrivée), heures de départ et d'arrivée strictement décroissantes
+    vector<vector<pair<uint32_t, uint32_t> > > profils(nbStations);
+    auto arriveeDepuis = [&](uint32_t p_station, uint32_t p_heure)
+    {
+        uint32_t arrivee = marcheDestination[p_station] == infini ? infini : p_heure + marcheDestination[p_station];
+        const auto &profilStation = profils[p_station];
+        auto suivant = partition_point(profilStation.begin(), profilStation.end(),
+                                       [p_heure](const pair<uint32_t, uint32_t> &e) { return e.first >= p_heure; });
+        if (suivant != profilStation.begin()) arrivee = min(arrivee, prev(suivant)->second);
+        return arrivee;
+    };
+    //insère (p_pret, p_arrivee) au profil de la station s'il n'est pas dominé, puis aux stations d'où l'on peut y marcher
+    vector<pair<uint32_t, pair<uint32_t, uint32_t> > > aInserer;
+    auto inserer = [&](uint32_t p_station, uint32_t p_pret, uint32_t p_arrivee)
+    {
+        aInserer.push_back({p_station, {p_pret, p_arrivee}});
+        while (!aInserer.empty())
+        {
+            uint32_t s = aInserer.back().first;
+            uint32_t pret = aInserer.back().second.first;
+            uint32_t arrivee = aInserer.back().second.second;
+            aInserer.pop_back();
+
+            auto &profilStation = profils[s];
+            auto k = partition_point(profilStation.begin(), profilStation.end(),
+                                     [pret](const pair<uint32_t, uint32_t> &e) { return e.first >= pret; });
+            if (k != profilStation.begin() && prev(k)->second <= arrivee) continue; //dominé
+            auto premier = k;
+            while (premier != profilStation.begin() && prev(premier)->first == pret) --premier;
+            auto dernier = k;
+            while (dernier != profilStation.end() && dernier->second >= arrivee) ++dernier;
+            premier = profilStation.erase(premier, dernier);
+            profilStation.insert(premier, {pret, arrivee});
+
+            for (uint32_t t = m_debutTransfertsInverses[s]; t < m_debutTransfertsInverses[s + 1]; ++t)
+                if (pret >= m_transfertsInverses[t].second)
+                    aInserer.push_back({m_transfertsInverses[t].first, {pret - m_transfertsInverses[t].second, arrivee}});
+        }
+    };
+
+    vector<uint32_t> arriveeVoyage(m_voyageIds.size(), infini); //arrivée si l'on reste à bord du voyage
+    auto premiere = lower_bound(m_connexions.begin(), m_connexions.end(), debut,
+                                [](const Connexion &c, uint32_t h) { return c.depart < h; });
+    for (auto c = m_connexions.end(); c != premiere;)
+    {
+        --c;
+        const uint32_t s = c->stationArrivee;
+        uint32_t arrivee = arriveeVoyage[c->voyage];
+        if (marcheDestination[s] != infini)
+            arrivee = min(arrivee, c->arrivee + marcheDestination[s]);
+        if (m_attentePermise[s])
+            arrivee = min(arrivee, arriveeDepuis(s, c->arrivee + delaisMinArcsAttente));
+        for (uint32_t t = m_debutTransferts[s]; t < m_debutTransferts[s + 1]; ++t)
+            arrivee = min(arrivee, arriveeDepuis(m_transferts[t].first, c->arrivee + m_transferts[t].second));
+        if (arrivee == infini) continue;
+        arriveeVoyage[c->voyage] = arrivee;
+        inserer(c->stationDepart, c->depart, arrivee);
+    }
+
+    //trajet à pieds seulement: marcher à une station, puis au moins un transfert (comme dans itineraire())
+    uint32_t tempsAPieds = infini;
+    vector<Trajet> candidats;
+    for (uint32_t s = 0; s < nbStations; ++s)
+    {
+        double distanceOrigine = p_pointOrigine - m_coordonnees[s];
+        if (std::isnan(distanceOrigine)) distanceOrigine = 0; //point confondu avec la station
+        if (distanceOrigine <= distanceMaxMarche) //même critère que itineraire()
+        {
+            const uint32_t marche = static_cast<uint32_t>(distanceOrigine / vitesseDeMarche * 3600);
+            for (uint32_t t = m_debutTransferts[s]; t < m_debutTransferts[s + 1]; ++t)
+                if (marcheDestination[m_transferts[t].first] != infini)
+                    tempsAPieds = min(tempsAPieds,
+                                      marche + m_transferts[t].second + marcheDestination[m_transferts[t].first]);
+            for (const auto &e : profils[s])
+                if (e.first >= debut + marche)
+                    candidats.push_back({e.first - marche, e.second});
+        }
+    }
+
+    //on ne garde que les trajets non dominés
+    sort(candidats.begin(), candidats.end(), [](const Trajet &a, const Trajet &b)
+    {
+        return a.heureDepart > b.heureDepart || (a.heureDepart == b.heureDepart && a.heureArrivee < b.heureArrivee);
+    });
+    vector<Trajet> trajets;
+    for (const auto &trajet : candidats)
+    {
+        if (!trajets.empty() && trajets.back().heureArrivee <= trajet.heureArrivee) continue;
+        if (tempsAPieds != infini && trajet.heureArrivee - trajet.heureDepart >= tempsAPieds) continue;
+        trajets.push_back(trajet);
+    }
+    reverse(trajets.begin(), trajets.end());
+    //après p_fin, seul le trajet le plus hâtif reste utile pour un départ à l'intérieur de l'intervalle
+    auto apresFin = partition_point(trajets.begin(), trajets.end(),
+                                    [fin](const Trajet &t) { return t.heureDepart <= fin; });
+    if (apresFin != trajets.end()) trajets.erase(next(apresFin), trajets.end());
+
+    if (p_tempsAPieds)
+        *p_tempsAPieds = tempsAPieds == infini ? numeric_limits<unsigned int>::max() : tempsAPieds;
+    return trajets;
+}
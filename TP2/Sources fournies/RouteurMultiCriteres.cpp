@@ -0,0 +1,354 @@
+//
+// Recherche multicritère (durée, correspondances, marche) sur le graphe espace-temps de ReseauGTFS
+//
+
+#include "RouteurMultiCriteres.h"
+#include "parallele.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <functional>
+
+using namespace std;
+
+const uint32_t RouteurMultiCriteres::infini;
+
+//! \brief copie le graphe du réseau en format CSR et dérive les attributs de chaque arc
+//! \param[in] p_gtfs: les données GTFS ayant servi à construire p_reseau
+//! \param[in] p_reseau: le réseau, sans point origine ni point destination ajoutés
+//! \post un arc est un arc de voyage si ses deux arrêts appartiennent au même voyage; sinon c'est une correspondance,
+//! \post dont la marche est la distance entre ses deux stations (0 pour une attente à la même station)
+//! \throws logic_error si un arrêt du réseau réfère à une station inconnue
+RouteurMultiCriteres::RouteurMultiCriteres(const DonneesGTFS &p_gtfs, const ReseauGTFS &p_reseau)
+        : m_reseau(p_reseau), m_generation(p_reseau.getGeneration())
+{
+    unordered_map<string, uint32_t> indiceStation;
+    for (const auto &station : p_gtfs.getStations())
+    {
+        indiceStation.insert({station.first, static_cast<uint32_t>(m_coordonnees.size())});
+        m_coordonnees.push_back(station.second.getCoords());
+    }
+
+    const size_t nbSommets = p_reseau.m_leGraphe.getNbSommets();
+    m_stationDuSommet.resize(nbSommets);
+    for (size_t i = 0; i < nbSommets; ++i)
+    {
+        if (!p_reseau.m_arretDuSommet[i]) continue; //sommet libéré par ReseauGTFS::avancerFenetre(), sans arcs
+        auto it = indiceStation.find(p_reseau.m_arretDuSommet[i]->getStationId());
+        if (it == indiceStation.end())
+            throw logic_error("RouteurMultiCriteres: un arrêt du réseau réfère à une station inconnue");
+        m_stationDuSommet[i] = it->second;
+    }
+
+    map<pair<uint32_t, uint32_t>, uint32_t> marcheEntreStations; //les transferts relient peu de paires distinctes
+    m_debutArcs.reserve(nbSommets + 1);
+    m_arcs.reserve(p_reseau.m_leGraphe.getNbArcs());
+    for (size_t i = 0; i < nbSommets; ++i)
+    {
+        m_debutArcs.push_back(static_cast<uint32_t>(m_arcs.size()));
+        if (!p_reseau.m_arretDuSommet[i]) continue;
+        const string voyage = p_reseau.m_arretDuSommet[i]->getVoyageId();
+        for (const auto &arc : p_reseau.m_leGraphe.getArcs(i))
+        {
+            Arc a;
+            a.destination = static_cast<uint32_t>(arc.first);
+            a.duree = arc.second;
+            a.voyage = p_reseau.m_arretDuSommet[arc.first]->getVoyageId() == voyage;
+            a.marche = 0;
+            uint32_t s = m_stationDuSommet[i];
+            uint32_t t = m_stationDuSommet[arc.first];
+            if (!a.voyage && s != t)
+            {
+                auto res = marcheEntreStations.insert({{s, t}, 0});
+                if (res.second) res.first->second = metres(m_coordonnees[s], m_coordonnees[t]);
+                a.marche = res.first->second;
+            }
+            m_arcs.push_back(a);
+        }
+    }
+    m_debutArcs.push_back(static_cast<uint32_t>(m_arcs.size()));
+}
+
+//! \brief distance entre deux points en mètres, arrondie; Coordonnees::operator- peut donner NaN pour des points confondus
+uint32_t RouteurMultiCriteres::metres(const Coordonnees &p_a, const Coordonnees &p_b)
+{
+    double km = p_a - p_b;
+    if (!(km > 0)) return 0;
+    return static_cast<uint32_t>(lround(km * 1000));
+}
+
+//! \brief ajoute la marche aux arcs virtuels d'une requête
+//! \param[in] p_requete: la requête obtenue de ReseauGTFS::preparerRequete() pour ces points
+//! \param[in] p_origine, p_destination: les points de la requête
+//! \throws logic_error si le graphe du réseau a changé depuis la construction du routeur (voir ReseauGTFS::getGeneration())
+RouteurMultiCriteres::ArcsRequete RouteurMultiCriteres::preparer(const ReseauGTFS::Requete &p_requete,
+                                                                  const Coordonnees &p_origine,
+                                                                  const Coordonnees &p_destination) const
+{
+    if (m_reseau.getGeneration() != m_generation)
+        throw logic_error("RouteurMultiCriteres: le graphe du réseau a changé depuis la construction du routeur");
+
+    const size_t nbSommets = m_stationDuSommet.size();
+    vector<uint32_t> marcheDeStation(m_coordonnees.size(), infini);
+    ArcsRequete arcs;
+    for (const auto &arc : p_requete.arcs.depuisOrigine)
+    {
+        uint32_t s = m_stationDuSommet[arc.first];
+        if (marcheDeStation[s] == infini) marcheDeStation[s] = metres(p_origine, m_coordonnees[s]);
+        arcs.depuisOrigine.push_back({static_cast<uint32_t>(arc.first), arc.second, marcheDeStation[s], false});
+    }
+
+    fill(marcheDeStation.begin(), marcheDeStation.end(), infini);
+    arcs.dureeVersDestination.assign(nbSommets, infini);
+    arcs.marcheVersDestination.assign(nbSommets, 0);
+    for (const auto &arc : p_requete.arcs.versDestination)
+    {
+        uint32_t s = m_stationDuSommet[arc.first];
+        if (marcheDeStation[s] == infini) marcheDeStation[s] = metres(m_coordonnees[s], p_destination);
+        if (arc.second < arcs.dureeVersDestination[arc.first])
+        {
+            arcs.dureeVersDestination[arc.first] = arc.second;
+            arcs.marcheVersDestination[arc.first] = marcheDeStation[s];
+        }
+    }
+    return arcs;
+}
+
+//! \brief trouve l'ensemble de Pareto des trajets (durée, nombre de correspondances, marche) entre deux points
+//! \brief Recherche à étiquettes: chaque sommet garde ses étiquettes non dominées (durée, montées, marche, en véhicule);
+//! \brief les étiquettes sont traitées par ordre lexicographique (durée, montées, marche), donc une étiquette traitée ne
+//! \brief sera plus dominée. Une étiquette est abandonnée si une étiquette de la destination la domine déjà, si elle
+//! \brief dépasse p_nbTransfertsMax correspondances ou si sa durée dépasse p_etirementMax fois celle du trajet le plus rapide.
+//! \param[in] p_origine, p_destination: les points de la requête
+//! \param[in] p_heureDepart: l'heure de départ du point origine
+//! \param[out] p_tempsExecution: le temps d'exécution de la recherche (préparation de la requête exclue), en microsecondes
+//! \param[in] p_nbTransfertsMax: le nombre maximal de correspondances
+//! \param[in] p_etirementMax: la durée maximale relative à celle du trajet le plus rapide (>= 1)
+//! \return les critères des trajets non dominés, par durée croissante; vide si la destination n'est pas atteignable
+//! \throws logic_error si p_etirementMax < 1 ou si le graphe du réseau a changé depuis la construction du routeur
+vector<RouteurMultiCriteres::Criteres> RouteurMultiCriteres::pareto(const Coordonnees &p_origine,
+                                                                     const Coordonnees &p_destination,
+                                                                     const Heure &p_heureDepart,
+                                                                     long &p_tempsExecution,
+                                                                     unsigned int p_nbTransfertsMax,
+                                                                     double p_etirementMax) const
+{
+    if (!(p_etirementMax >= 1))
+        throw logic_error("RouteurMultiCriteres::pareto(): l'étirement maximal doit être au moins 1");
+    ReseauGTFS::Requete requete = m_reseau.preparerRequete(p_origine, p_destination, p_heureDepart);
+
+    timeval tv1;
+    timeval tv2;
+    if (gettimeofday(&tv1, 0) != 0)
+        throw logic_error("RouteurMultiCriteres::pareto(): gettimeofday() a échoué pour tv1");
+    ArcsRequete arcs = preparer(requete, p_origine, p_destination);
+
+    //une étiquette de la destination garde son nombre de correspondances dans montees, et dansVehicule = true
+    struct Etiquette
+    {
+        uint32_t sommet;
+        uint32_t duree;
+        uint32_t marche;
+        uint16_t montees;
+        bool dansVehicule;
+        bool active;
+    };
+    auto domine = [](const Etiquette &a, const Etiquette &b)
+    {
+        return a.duree <= b.duree && a.marche <= b.marche && a.montees <= b.montees
+               && a.montees + !a.dansVehicule <= b.montees + !b.dansVehicule;
+    };
+
+    const uint32_t destination = static_cast<uint32_t>(m_stationDuSommet.size()); //sommet destination virtuel
+    const uint32_t monteesMax = p_nbTransfertsMax + 1;
+    vector<Etiquette> etiquettes;
+    vector<vector<uint32_t> > sac(destination + 1); //indices dans etiquettes des étiquettes actives de chaque sommet
+    uint32_t dureeMax = infini;
+
+    typedef tuple<uint32_t, uint32_t, uint32_t, uint32_t> Entree; //(durée, montées, marche, indice de l'étiquette)
+    priority_queue<Entree, vector<Entree>, greater<Entree> > file;
+
+    auto ajouter = [&](Etiquette p_etiquette)
+    {
+        if (p_etiquette.duree > dureeMax) return;
+        Etiquette borne = p_etiquette; //meilleurs critères que l'étiquette peut encore atteindre à la destination
+        borne.montees = static_cast<uint16_t>(max<uint16_t>(borne.montees, 1) - 1);
+        borne.dansVehicule = true;
+        for (uint32_t e : sac[destination])
+            if (domine(etiquettes[e], borne)) return;
+        if (p_etiquette.sommet == destination) p_etiquette = borne;
+        auto &s = sac[p_etiquette.sommet];
+        for (uint32_t e : s)
+            if (domine(etiquettes[e], p_etiquette)) return;
+        size_t k = 0;
+        for (uint32_t e : s)
+            if (domine(p_etiquette, etiquettes[e])) etiquettes[e].active = false;
+            else s[k++] = e;
+        s.resize(k);
+        s.push_back(static_cast<uint32_t>(etiquettes.size()));
+        etiquettes.push_back(p_etiquette);
+        file.push(Entree(p_etiquette.duree, p_etiquette.montees, p_etiquette.marche, s.back()));
+    };
+
+    for (const Arc &arc : arcs.depuisOrigine)
+        ajouter({arc.destination, arc.duree, arc.marche, 0, false, true});
+
+    vector<Criteres> resultats;
+    while (!file.empty())
+    {
+        Etiquette l = etiquettes[get<3>(file.top())];
+        file.pop();
+        if (!l.active || l.duree > dureeMax) continue;
+        if (l.sommet == destination)
+        {
+            if (resultats.empty())
+                dureeMax = static_cast<uint32_t>(min<double>(infini - 1, floor(l.duree * p_etirementMax)));
+            resultats.push_back({l.duree, l.montees, l.marche});
+            continue;
+        }
+        if (arcs.dureeVersDestination[l.sommet] != infini)
+            ajouter({destination, l.duree + arcs.dureeVersDestination[l.sommet],
+                     l.marche + arcs.marcheVersDestination[l.sommet], l.montees, true, true});
+        for (uint32_t a = m_debutArcs[l.sommet]; a < m_debutArcs[l.sommet + 1]; ++a)
+        {
+            const Arc &arc = m_arcs[a];
+            if (arc.voyage)
+            {
+                uint16_t montees = static_cast<uint16_t>(l.montees + !l.dansVehicule);
+                if (montees > monteesMax) continue;
+                ajouter({arc.destination, l.duree + arc.duree, l.marche, montees, true, true});
+            }
+            else
+                ajouter({arc.destination, l.duree + arc.duree, l.marche + arc.marche, l.montees, false, true});
+        }
+    }
+
+    //une étiquette de la destination traitée peut encore être dominée à durée égale par une étiquette traitée après elle
+    vector<Criteres> paretoOptimaux;
+    for (const Criteres &c : resultats)
+    {
+        bool estDomine = false;
+        for (const Criteres &d : resultats)
+            if (&d != &c && d.duree <= c.duree && d.nbTransferts <= c.nbTransferts && d.marche <= c.marche
+                && (d.duree < c.duree || d.nbTransferts < c.nbTransferts || d.marche < c.marche || &d < &c))
+            {
+                estDomine = true;
+                break;
+            }
+        if (!estDomine) paretoOptimaux.push_back(c);
+    }
+
+    if (gettimeofday(&tv2, 0) != 0)
+        throw logic_error("RouteurMultiCriteres::pareto(): gettimeofday() a échoué pour tv2");
+    p_tempsExecution = tempsExecution(tv1, tv2);
+    return paretoOptimaux;
+}
+
+//! \brief trouve le trajet minimisant durée + p_secondesParTransfert * correspondances + p_secondesParKmDeMarche * km de marche
+//! \brief Algorithme de Dijkstra sur trois copies de chaque sommet: avant la première montée, en véhicule, et descendu
+//! \brief après au moins une montée; seule une montée depuis cette dernière copie est une correspondance pénalisée.
+//! \param[in] p_origine, p_destination: les points de la requête
+//! \param[in] p_heureDepart: l'heure de départ du point origine
+//! \param[in] p_secondesParTransfert: la pénalité d'une correspondance, en secondes (>= 0)
+//! \param[in] p_secondesParKmDeMarche: la pénalité d'un km de marche, en secondes (>= 0), en sus de la durée de marche
+//! \param[out] p_tempsExecution: le temps d'exécution de la recherche (préparation de la requête exclue), en microsecondes
+//! \return les critères du trajet trouvé (duree = numeric_limits<unsigned int>::max() si la destination n'est pas atteignable)
+//! \throws logic_error si une pénalité est négative ou si le graphe du réseau a changé depuis la construction du routeur
+RouteurMultiCriteres::Criteres RouteurMultiCriteres::pondere(const Coordonnees &p_origine,
+                                                             const Coordonnees &p_destination,
+                                                             const Heure &p_heureDepart,
+                                                             double p_secondesParTransfert,
+                                                             double p_secondesParKmDeMarche,
+                                                             long &p_tempsExecution) const
+{
+    if (!(p_secondesParTransfert >= 0) || !(p_secondesParKmDeMarche >= 0))
+        throw logic_error("RouteurMultiCriteres::pondere(): les pénalités doivent être positives ou nulles");
+    ReseauGTFS::Requete requete = m_reseau.preparerRequete(p_origine, p_destination, p_heureDepart);
+
+    timeval tv1;
+    timeval tv2;
+    if (gettimeofday(&tv1, 0) != 0)
+        throw logic_error("RouteurMultiCriteres::pondere(): gettimeofday() a échoué pour tv1");
+    ArcsRequete arcs = preparer(requete, p_origine, p_destination);
+
+    enum Copie {avantMontee = 0, enVehicule = 1, descendu = 2};
+    const double parMetre = p_secondesParKmDeMarche / 1000;
+    const size_t nbSommets = m_stationDuSommet.size();
+    vector<double> coutEtat(3 * nbSommets, numeric_limits<double>::infinity());
+    vector<Criteres> criteres(3 * nbSommets); //critères du meilleur trajet connu vers chaque copie
+    vector<bool> traite(3 * nbSommets, false);
+
+    typedef pair<double, uint32_t> Entree; //(coût, copie de sommet = 3 * sommet + copie)
+    priority_queue<Entree, vector<Entree>, greater<Entree> > file;
+    auto relacher = [&](uint32_t p_etat, double p_cout, const Criteres &p_criteres)
+    {
+        if (p_cout < coutEtat[p_etat])
+        {
+            coutEtat[p_etat] = p_cout;
+            criteres[p_etat] = p_criteres;
+            file.push({p_cout, p_etat});
+        }
+    };
+
+    for (const Arc &arc : arcs.depuisOrigine)
+        relacher(3 * arc.destination + avantMontee, arc.duree + parMetre * arc.marche, {arc.duree, 0, arc.marche});
+
+    double meilleurCout = numeric_limits<double>::infinity();
+    Criteres meilleur = {numeric_limits<unsigned int>::max(), 0, 0};
+    while (!file.empty())
+    {
+        double c = file.top().first;
+        uint32_t etat = file.top().second;
+        file.pop();
+        if (c >= meilleurCout) break;
+        if (traite[etat]) continue;
+        traite[etat] = true;
+
+        uint32_t sommet = etat / 3;
+        Copie copie = static_cast<Copie>(etat % 3);
+        const Criteres &k = criteres[etat];
+        if (arcs.dureeVersDestination[sommet] != infini)
+        {
+            uint32_t marche = arcs.marcheVersDestination[sommet];
+            double coutFinal = c + arcs.dureeVersDestination[sommet] + parMetre * marche;
+            if (coutFinal < meilleurCout)
+            {
+                meilleurCout = coutFinal;
+                meilleur = {k.duree + arcs.dureeVersDestination[sommet], k.nbTransferts, k.marche + marche};
+            }
+        }
+        for (uint32_t a = m_debutArcs[sommet]; a < m_debutArcs[sommet + 1]; ++a)
+        {
+            const Arc &arc = m_arcs[a];
+            if (arc.voyage)
+            {
+                bool correspondance = copie == descendu;
+                relacher(3 * arc.destination + enVehicule, c + arc.duree + (correspondance ? p_secondesParTransfert : 0),
+                         {k.duree + arc.duree, k.nbTransferts + correspondance, k.marche});
+            }
+            else
+                relacher(3 * arc.destination + (copie == avantMontee ? avantMontee : descendu),
+                         c + arc.duree + parMetre * arc.marche, {k.duree + arc.duree, k.nbTransferts, k.marche + arc.marche});
+        }
+    }
+
+    if (gettimeofday(&tv2, 0) != 0)
+        throw logic_error("RouteurMultiCriteres::pondere(): gettimeofday() a échoué pour tv2");
+    p_tempsExecution = tempsExecution(tv1, tv2);
+    return meilleur;
+}
+
+//! \brief retourne le nombre d'arcs du graphe copié
+size_t RouteurMultiCriteres::getNbArcs() const
+{
+    return m_arcs.size();
+}
+
+//! \brief retourne la taille mémoire (en octets) occupée par les tableaux du routeur
+size_t RouteurMultiCriteres::getTailleMemoire() const
+{
+    return m_debutArcs.capacity() * sizeof(uint32_t)
+           + m_arcs.capacity() * sizeof(Arc)
+           + m_stationDuSommet.capacity() * sizeof(uint32_t)
+           + m_coordonnees.capacity() * sizeof(Coordonnees);
+}
@@ -0,0 +1,70 @@
+//
+// Recherche multicritère (durée, correspondances, marche) sur le graphe espace-temps de ReseauGTFS
+//
+
+#ifndef TP2_ROUTEURMULTICRITERES_H
+#define TP2_ROUTEURMULTICRITERES_H
+
+#include "ReseauGTFS.h"
+#include <cstdint>
+#include <limits>
+
+//! \brief Routeur multicritère sur une copie (format CSR) du graphe d'un ReseauGTFS dont chaque arc porte ses attributs:
+//! \brief arc de voyage (en véhicule) ou de correspondance (attente ou transfert), et distance de marche entre stations
+//! \brief Deux types de requêtes:
+//! \brief - pareto(): toutes les combinaisons non dominées (durée, nombre de correspondances, marche), par une recherche
+//! \brief   à étiquettes; les ensembles d'étiquettes sont bornés par un nombre maximal de correspondances et une durée
+//! \brief   maximale relative au trajet le plus rapide, et élagués par les étiquettes déjà rendues à destination
+//! \brief - pondere(): le trajet minimisant durée + pénalités pondérées des correspondances et de la marche
+//! \brief Le réseau et les données GTFS doivent survivre au routeur; le réseau ne doit plus être renuméroté ni élagué.
+class RouteurMultiCriteres
+{
+
+public:
+    struct Criteres
+    {
+        unsigned int duree; //en secondes, du départ du point origine à l'arrivée au point destination
+        unsigned int nbTransferts; //nombre de correspondances (montées moins une)
+        unsigned int marche; //distance totale de marche, en mètres
+    };
+
+    RouteurMultiCriteres(const DonneesGTFS &, const ReseauGTFS &);
+    std::vector<Criteres> pareto(const Coordonnees &, const Coordonnees &, const Heure &, long & p_tempsExecution,
+                                 unsigned int p_nbTransfertsMax = 3, double p_etirementMax = 1.5) const;
+    Criteres pondere(const Coordonnees &, const Coordonnees &, const Heure &, double p_secondesParTransfert,
+                     double p_secondesParKmDeMarche, long & p_tempsExecution) const;
+    size_t getNbArcs() const;
+    size_t getTailleMemoire() const;
+
+private:
+    struct Arc
+    {
+        uint32_t destination;
+        uint32_t duree;
+        uint32_t marche; //en mètres; 0 sauf pour un transfert entre deux stations
+        bool voyage; //true pour un arc de voyage (on reste dans le véhicule), false pour une correspondance
+    };
+
+    //! \brief arcs virtuels d'une requête, avec leur marche
+    struct ArcsRequete
+    {
+        std::vector<Arc> depuisOrigine;
+        std::vector<uint32_t> dureeVersDestination; //par sommet (infini si aucun arc vers la destination)
+        std::vector<uint32_t> marcheVersDestination;
+    };
+
+    static const uint32_t infini = std::numeric_limits<uint32_t>::max();
+
+    const ReseauGTFS &m_reseau;
+    unsigned long m_generation; //génération du réseau copié, pour détecter un réseau modifié après la construction
+    std::vector<uint32_t> m_debutArcs; //arcs du sommet i: m_arcs[m_debutArcs[i] .. m_debutArcs[i + 1])
+    std::vector<Arc> m_arcs;
+    std::vector<uint32_t> m_stationDuSommet;
+    std::vector<Coordonnees> m_coordonnees; //par indice de station
+
+    ArcsRequete preparer(const ReseauGTFS::Requete &, const Coordonnees &, const Coordonnees &) const;
+    static uint32_t metres(const Coordonnees &, const Coordonnees &);
+};
+
+
+#endif //TP2_ROUTEURMULTICRITERES_H
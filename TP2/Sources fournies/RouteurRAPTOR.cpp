@@ -0,0 +1,317 @@
+//
+// Routeur par rondes (RAPTOR) donnant les compromis entre heure d'arrivée et nombre de correspondances
+//
+
+#include "RouteurRAPTOR.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+using namespace std;
+
+const uint32_t RouteurRAPTOR::infini;
+
+//! \brief retourne une heure en secondes depuis minuit
+static uint32_t enSecondes(const Heure &p_heure)
+{
+    return static_cast<uint32_t>(p_heure - Heure(0, 0, 0));
+}
+
+//! \brief regroupe les voyages en parcours et construit les tableaux de passage et les transferts
+//! \param[in] p_gtfs: un objet DonneesGTFS dont tous les arrêts et transferts ont été ajoutés
+//! \post deux voyages font partie du même parcours s'ils desservent la même suite de stations et si aucun ne dépasse
+//! \post l'autre; les voyages d'un parcours sont triés, de sorte que leurs heures de passage croissent à chaque station
+//! \throws logic_error si un transfert ou un arrêt réfère à une station inconnue
+RouteurRAPTOR::RouteurRAPTOR(const DonneesGTFS &p_gtfs)
+{
+    unordered_map<string, uint32_t> indiceStation;
+    for (const auto &station : p_gtfs.getStations())
+    {
+        indiceStation.insert({station.first, static_cast<uint32_t>(m_coordonnees.size())});
+        m_coordonnees.push_back(station.second.getCoords());
+        m_attentePermise.push_back(p_gtfs.getStationsDeTransfert().find(station.first) ==
+                                   p_gtfs.getStationsDeTransfert().end());
+    }
+    const size_t nbStations = m_coordonnees.size();
+
+    //transferts regroupés par station de départ (format CSR)
+    m_debutTransferts.assign(nbStations + 1, 0);
+    vector<tuple<uint32_t, uint32_t, uint32_t> > transferts;
+    for (const auto &transfert : p_gtfs.getTransferts())
+    {
+        auto de = indiceStation.find(get<0>(transfert));
+        auto vers = indiceStation.find(get<1>(transfert));
+        if (de == indiceStation.end() || vers == indiceStation.end())
+            throw logic_error("RouteurRAPTOR::RouteurRAPTOR(): un transfert réfère à une station inconnue");
+        transferts.push_back(make_tuple(de->second, vers->second, get<2>(transfert)));
+    }
+    sort(transferts.begin(), transferts.end());
+    for (const auto &t : transferts)
+    {
+        ++m_debutTransferts[get<0>(t) + 1];
+        m_transferts.push_back({get<1>(t), get<2>(t)});
+    }
+    for (size_t s = 0; s < nbStations; ++s)
+        m_debutTransferts[s + 1] += m_debutTransferts[s];
+
+    //heures de passage de chaque voyage, regroupées par suite de stations
+    map<vector<uint32_t>, vector<vector<uint32_t> > > voyagesParSuite;
+    for (const auto &voyage : p_gtfs.getVoyages())
+    {
+        vector<uint32_t> suite;
+        vector<uint32_t> heures;
+        for (const auto &arret : voyage.second.getArrets())
+        {
+            auto s = indiceStation.find(arret->getStationId());
+            if (s == indiceStation.end())
+                throw logic_error("RouteurRAPTOR::RouteurRAPTOR(): un arrêt réfère à une station inconnue");
+            suite.push_back(s->second);
+            heures.push_back(enSecondes(arret->getHeureArrivee())); //comme dans ReseauGTFS
+        }
+        if (suite.size() >= 2) voyagesParSuite[suite].push_back(heures);
+    }
+
+    for (auto &suite : voyagesParSuite)
+    {
+        auto &voyages = suite.second;
+        sort(voyages.begin(), voyages.end());
+
+        //un voyage qui en dépasse un autre ne peut pas partager son parcours: on répartit les voyages de façon vorace
+        vector<vector<const vector<uint32_t> *> > groupes;
+        for (const auto &heures : voyages)
+        {
+            bool place = false;
+            for (auto &groupe : groupes)
+            {
+                const vector<uint32_t> &precedent = *groupe.back();
+                bool depasse = false;
+                for (size_t i = 0; i < heures.size() && !depasse; ++i)
+                    depasse = heures[i] < precedent[i];
+                if (!depasse)
+                {
+                    groupe.push_back(&heures);
+                    place = true;
+                    break;
+                }
+            }
+            if (!place) groupes.push_back({&heures});
+        }
+
+        for (const auto &groupe : groupes)
+        {
+            Parcours parcours;
+            parcours.debutStations = static_cast<uint32_t>(m_stationsParcours.size());
+            parcours.nbStations = static_cast<uint32_t>(suite.first.size());
+            parcours.debutHeures = static_cast<uint32_t>(m_heures.size());
+            parcours.nbVoyages = static_cast<uint32_t>(groupe.size());
+            m_stationsParcours.insert(m_stationsParcours.end(), suite.first.begin(), suite.first.end());
+            for (const auto *heures : groupe)
+                m_heures.insert(m_heures.end(), heures->begin(), heures->end());
+            m_parcours.push_back(parcours);
+        }
+    }
+
+    //parcours desservant chaque station (format CSR)
+    m_debutParcoursDeStation.assign(nbStations + 1, 0);
+    for (uint32_t s : m_stationsParcours)
+        ++m_debutParcoursDeStation[s + 1];
+    for (size_t s = 0; s < nbStations; ++s)
+        m_debutParcoursDeStation[s + 1] += m_debutParcoursDeStation[s];
+    m_parcoursDeStation.resize(m_stationsParcours.size());
+    vector<uint32_t> prochain(m_debutParcoursDeStation.begin(), m_debutParcoursDeStation.end() - 1);
+    for (uint32_t p = 0; p < m_parcours.size(); ++p)
+        for (uint32_t i = 0; i < m_parcours[p].nbStations; ++i)
+            m_parcoursDeStation[prochain[m_stationsParcours[m_parcours[p].debutStations + i]]++] = {p, i};
+
+    m_stationsParcours.shrink_to_fit();
+    m_heures.shrink_to_fit();
+}
+
+size_t RouteurRAPTOR::getNbParcours() const
+{
+    return m_parcours.size();
+}
+
+//! \brief retourne une estimation du nombre d'octets occupés par les structures du routeur
+size_t RouteurRAPTOR::getTailleMemoire() const
+{
+    return m_parcours.capacity() * sizeof(Parcours)
+           + m_stationsParcours.capacity() * sizeof(uint32_t)
+           + m_heures.capacity() * sizeof(uint32_t)
+           + m_debutParcoursDeStation.capacity() * sizeof(uint32_t)
+           + m_parcoursDeStation.capacity() * sizeof(pair<uint32_t, uint32_t>)
+           + m_coordonnees.capacity() * sizeof(Coordonnees)
+           + m_attentePermise.capacity() / 8
+           + m_debutTransferts.capacity() * sizeof(uint32_t)
+           + m_transferts.capacity() * sizeof(pair<uint32_t, uint32_t>);
+}
+
+//! \brief Trouve, pour chaque nombre de correspondances, l'arrivée la plus hâtive du point origine au point destination
+//! \brief La ronde k n'explore que les parcours qui desservent une station améliorée à la ronde k-1
+//! \param[in] p_pointOrigine: les coordonnées GPS du point origine
+//! \param[in] p_pointDestination: les coordonnées GPS du point destination
+//! \param[in] p_heureDepart: l'heure de départ du point origine
+//! \param[in] p_nbCorrespondancesMax: le nombre maximal de correspondances (la recherche fait au plus ce nombre + 1 rondes)
+//! \return l'ensemble de Pareto: des solutions triées par nombre croissant de correspondances et par temps de trajet
+//! \return strictement décroissant (vide si la destination n'est pas atteignable)
+vector<RouteurRAPTOR::Solution> RouteurRAPTOR::itineraires(const Coordonnees &p_pointOrigine,
+                                                           const Coordonnees &p_pointDestination,
+                                                           const Heure &p_heureDepart,
+                                                           unsigned int p_nbCorrespondancesMax) const
+{
+    const size_t nbStations = m_coordonnees.size();
+    const uint32_t depart = enSecondes(p_heureDepart);
+
+    vector<uint32_t> pret(nbStations, infini); //heure à partir de laquelle on peut monter à bord, tous rondes confondues
+    vector<uint32_t> pretPrecedent; //pret[] à la fin de la ronde précédente: sert à l'embarquement
+    vector<uint32_t> atteinte(nbStations, infini); //meilleure heure d'arrivée en autobus à la station
+    vector<uint32_t> marcheDestination(nbStations, infini);
+    vector<bool> ameliore(nbStations, false); //pret[] amélioré pendant la ronde courante
+    vector<uint32_t> stationsAmeliorees;
+    vector<bool> atteinteAmelioree(nbStations, false);
+    vector<uint32_t> stationsAtteintes;
+    vector<uint32_t> premierePosition(m_parcours.size(), infini); //première position à explorer de chaque parcours
+    vector<uint32_t> parcoursAExplorer;
+
+    uint32_t meilleureArrivee = infini; //toutes rondes confondues
+    uint32_t arriveeRonde = infini;
+    vector<Solution> solutions;
+
+    //met à jour pret[p_vers], puis propage les transferts qui partent de p_vers
+    vector<uint32_t> aPropager;
+    auto rendrePret = [&](uint32_t p_vers, uint32_t p_heure, bool p_versDestination)
+    {
+        if (p_heure >= pret[p_vers]) return;
+        pret[p_vers] = p_heure;
+        aPropager.push_back(p_vers);
+        while (!aPropager.empty())
+        {
+            uint32_t s = aPropager.back();
+            aPropager.pop_back();
+            if (!ameliore[s])
+            {
+                ameliore[s] = true;
+                stationsAmeliorees.push_back(s);
+            }
+            if (p_versDestination && marcheDestination[s] != infini)
+                arriveeRonde = min(arriveeRonde, pret[s] + marcheDestination[s]);
+            p_versDestination = true; //après un transfert, on peut toujours marcher vers la destination
+            for (uint32_t t = m_debutTransferts[s]; t < m_debutTransferts[s + 1]; ++t)
+            {
+                uint32_t vers = m_transferts[t].first;
+                uint32_t heure = pret[s] + m_transferts[t].second;
+                if (heure < pret[vers])
+                {
+                    pret[vers] = heure;
+                    aPropager.push_back(vers);
+                }
+            }
+        }
+    };
+
+    //ajoute une solution si la ronde améliore les précédentes
+    auto conclureRonde = [&](unsigned int p_ronde)
+    {
+        if (arriveeRonde >= meilleureArrivee) return;
+        meilleureArrivee = arriveeRonde;
+        Solution solution = {p_ronde > 0 ? p_ronde - 1 : 0, meilleureArrivee - depart};
+        //la marche seule et un seul autobus comptent tous deux zéro correspondance
+        if (!solutions.empty() && solutions.back().nbCorrespondances == solution.nbCorrespondances)
+            solutions.back() = solution;
+        else
+            solutions.push_back(solution);
+    };
+
+    for (size_t s = 0; s < nbStations; ++s)
+    {
+        double distanceDestination = p_pointDestination - m_coordonnees[s];
+        if (std::isnan(distanceDestination)) distanceDestination = 0; //point confondu avec la station
+        if (distanceDestination <= distanceMaxMarche)
+            marcheDestination[s] = static_cast<uint32_t>(distanceDestination / vitesseDeMarche * 3600);
+    }
+
+    //ronde 0: les stations accessibles à pieds du point origine
+    for (uint32_t s = 0; s < nbStations; ++s)
+    {
+        double distanceOrigine = p_pointOrigine - m_coordonnees[s];
+        if (std::isnan(distanceOrigine)) distanceOrigine = 0; //point confondu avec la station
+        if (distanceOrigine <= distanceMaxMarche)
+            rendrePret(s, depart + static_cast<uint32_t>(distanceOrigine / vitesseDeMarche * 3600), false);
+    }
+    conclureRonde(0);
+
+    for (unsigned int ronde = 1; ronde <= p_nbCorrespondancesMax + 1 && !stationsAmeliorees.empty(); ++ronde)
+    {
+        //les parcours qui desservent une station améliorée, à partir de la première telle station
+        for (uint32_t s : stationsAmeliorees)
+        {
+            ameliore[s] = false;
+            for (uint32_t k = m_debutParcoursDeStation[s]; k < m_debutParcoursDeStation[s + 1]; ++k)
+            {
+                uint32_t p = m_parcoursDeStation[k].first;
+                if (premierePosition[p] == infini) parcoursAExplorer.push_back(p);
+                premierePosition[p] = min(premierePosition[p], m_parcoursDeStation[k].second);
+            }
+        }
+        stationsAmeliorees.clear();
+        pretPrecedent = pret;
+        arriveeRonde = infini;
+
+        for (uint32_t p : parcoursAExplorer)
+        {
+            const Parcours &parcours = m_parcours[p];
+            const uint32_t *stations = &m_stationsParcours[parcours.debutStations];
+            const uint32_t *heures = &m_heures[parcours.debutHeures];
+            const uint32_t n = parcours.nbStations;
+            const uint32_t *voyage = nullptr; //heures du voyage à bord duquel on se trouve
+            uint32_t indiceVoyage = parcours.nbVoyages;
+
+            for (uint32_t i = premierePosition[p]; i < n; ++i)
+            {
+                const uint32_t s = stations[i];
+                if (voyage && voyage[i] < atteinte[s] && voyage[i] < meilleureArrivee)
+                {
+                    atteinte[s] = voyage[i];
+                    if (!atteinteAmelioree[s])
+                    {
+                        atteinteAmelioree[s] = true;
+                        stationsAtteintes.push_back(s);
+                    }
+                    if (marcheDestination[s] != infini)
+                        arriveeRonde = min(arriveeRonde, voyage[i] + marcheDestination[s]);
+                }
+                //peut-on monter à bord d'un voyage plus hâtif de ce parcours?
+                if (pretPrecedent[s] == infini || (voyage && pretPrecedent[s] > voyage[i])) continue;
+                uint32_t bas = 0;
+                uint32_t haut = indiceVoyage;
+                while (bas < haut)
+                {
+                    uint32_t milieu = (bas + haut) / 2;
+                    if (heures[milieu * n + i] < pretPrecedent[s]) bas = milieu + 1;
+                    else haut = milieu;
+                }
+                if (bas < indiceVoyage)
+                {
+                    indiceVoyage = bas;
+                    voyage = heures + static_cast<size_t>(bas) * n;
+                }
+            }
+            premierePosition[p] = infini;
+        }
+        parcoursAExplorer.clear();
+
+        //attente et transferts après les arrivées en autobus de cette ronde
+        for (uint32_t s : stationsAtteintes)
+        {
+            atteinteAmelioree[s] = false;
+            if (m_attentePermise[s]) rendrePret(s, atteinte[s] + delaisMinArcsAttente, true);
+            for (uint32_t t = m_debutTransferts[s]; t < m_debutTransferts[s + 1]; ++t)
+                rendrePret(m_transferts[t].first, atteinte[s] + m_transferts[t].second, true);
+        }
+        stationsAtteintes.clear();
+
+        conclureRonde(ronde);
+    }
+
+    return solutions;
+}
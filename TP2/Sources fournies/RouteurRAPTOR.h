@@ -0,0 +1,58 @@
+//
+// Routeur par rondes (RAPTOR) donnant les compromis entre heure d'arrivée et nombre de correspondances
+//
+
+#ifndef TP2_ROUTEURRAPTOR_H
+#define TP2_ROUTEURRAPTOR_H
+
+#include "DonneesGTFS.h"
+#include "parametresMarche.h"
+#include <cstdint>
+#include <limits>
+
+//! \brief Routeur RAPTOR construit directement à partir des données GTFS
+//! \brief Les voyages qui desservent la même suite de stations sont regroupés en parcours; les heures de passage d'un
+//! \brief parcours sont rangées dans un tableau contigu (un voyage par rangée). La ronde k trouve les meilleures
+//! \brief arrivées utilisant k autobus, ce qui donne directement l'ensemble de Pareto (heure d'arrivée, correspondances).
+//! \brief Les règles de correspondance sont celles de ReseauGTFS et de RouteurCSA.
+class RouteurRAPTOR
+{
+
+public:
+    //! \brief un itinéraire de l'ensemble de Pareto
+    struct Solution
+    {
+        unsigned int nbCorrespondances;
+        unsigned int tempsDuTrajet; //en secondes
+    };
+
+    explicit RouteurRAPTOR(const DonneesGTFS &);
+    std::vector<Solution> itineraires(const Coordonnees &, const Coordonnees &, const Heure &,
+                                      unsigned int p_nbCorrespondancesMax = 8) const;
+    size_t getNbParcours() const;
+    size_t getTailleMemoire() const;
+
+private:
+    struct Parcours
+    {
+        uint32_t debutStations; //indice du premier élément dans m_stationsParcours
+        uint32_t nbStations;
+        uint32_t debutHeures; //indice du premier élément dans m_heures
+        uint32_t nbVoyages;
+    };
+
+    static const uint32_t infini = std::numeric_limits<uint32_t>::max();
+
+    std::vector<Parcours> m_parcours;
+    std::vector<uint32_t> m_stationsParcours; //les stations de chaque parcours, dans l'ordre
+    std::vector<uint32_t> m_heures; //heure de passage du voyage j à la station i: m_heures[debutHeures + j * nbStations + i]
+    std::vector<uint32_t> m_debutParcoursDeStation; //CSR: parcours desservant chaque station
+    std::vector<std::pair<uint32_t, uint32_t> > m_parcoursDeStation; //(parcours, position de la station dans le parcours)
+    std::vector<Coordonnees> m_coordonnees;
+    std::vector<bool> m_attentePermise; //true si la station n'est pas une station de transfert
+    std::vector<uint32_t> m_debutTransferts; //CSR: transferts partant de chaque station
+    std::vector<std::pair<uint32_t, uint32_t> > m_transferts; //(station destination, durée minimale)
+};
+
+
+#endif //TP2_ROUTEURRAPTOR_H
@@ -3,30 +3,26 @@
 //
 
 #include "ReseauGTFS.h"
+#include "parallele.h"
 
 using namespace std;
 
 //! \brief ajout des arcs dus aux voyages
-//! \brief insère les arrêts (associés aux sommets) dans m_arretDuSommet et m_sommetDeArret
+//! \brief insère les arrêts de la fenêtre (associés aux sommets) dans m_arretDuSommet, m_sommetDeArret et m_ligneDuSommet
+//! \brief les arrêts d'un voyage qui sont dans la fenêtre sont consécutifs, puisque leurs heures croissent
 //! \throws logic_error si une incohérence est détecté lors de cette étape de construction du graphe
 void ReseauGTFS::ajouterArcsVoyages(const DonneesGTFS & p_gtfs)
 {
     try {
         for (auto &voyage: p_gtfs.getVoyages()) {
-            auto arret = voyage.second.getArrets().begin();
-            auto arretSuivant = voyage.second.getArrets().begin();
-            m_arretDuSommet.push_back(*arretSuivant);
-            m_sommetDeArret.insert({*arretSuivant, m_arretDuSommet.size() - 1});
-            ++arretSuivant;
-
-            while (arretSuivant != voyage.second.getArrets().end()) {
-                m_arretDuSommet.push_back(*arretSuivant);
-                m_sommetDeArret.insert({*arretSuivant, m_arretDuSommet.size() - 1});
-                this->m_leGraphe.ajouterArc(m_sommetDeArret.at(*arret),
-                                            m_sommetDeArret.at(*arretSuivant),
-                                            arretSuivant->get()->getHeureArrivee()-arret->get()->getHeureArrivee());
-                arretSuivant++;
-                arret++;
+            Arret::Ptr arret;
+            for (auto &arretSuivant : voyage.second.getArrets()) {
+                if (!dansFenetre(*arretSuivant)) continue;
+                const size_t sommetSuivant = ajouterSommet(p_gtfs, arretSuivant);
+                if (arret)
+                    this->m_leGraphe.ajouterArc(m_sommetDeArret.at(arret), sommetSuivant,
+                                                arretSuivant->getHeureArrivee() - arret->getHeureArrivee());
+                arret = arretSuivant;
             }
         }
     }
@@ -36,69 +32,120 @@ void ReseauGTFS::ajouterArcsVoyages(const DonneesGTFS & p_gtfs)
 }
 
 
+//! \brief ajoute au graphe les arcs générés par chaque tâche, dans l'ordre des tâches
+//! \brief l'ordre des arcs de chaque liste d'adjacence est donc celui d'une génération séquentielle
+static void fusionnerArcs(Graphe &p_graphe, const vector<vector<tuple<size_t, size_t, unsigned int> > > &p_arcsParTache)
+{
+    for (const auto &arcs : p_arcsParTache)
+        for (const auto &arc : arcs)
+            p_graphe.ajouterArc(get<0>(arc), get<1>(arc), get<2>(arc));
+}
+
 //! \brief ajouts des arcs dus aux transferts entre stations
+//! \brief Les transferts sont regroupés par station de départ; chaque groupe est une tâche dont les arcs sont générés
+//! \brief dans un tampon propre, puis tous les tampons sont fusionnés dans le graphe en une seule passe
+//! \param[in] p_transferts: les transferts (ceux de p_gtfs, éventuellement suivis de transferts à pied générés)
+//! \param[in] p_nbFils: le nombre de fils d'exécution (0 pour utiliser thread::hardware_concurrency())
 //! \throws logic_error si une incohérence est détecté lors de cette étape de construction du graphe
-
-void ReseauGTFS::ajouterArcsTransferts(const DonneesGTFS & p_gtfs)
+void ReseauGTFS::ajouterArcsTransferts(const DonneesGTFS & p_gtfs, const Transferts & p_transferts, unsigned int p_nbFils)
 {
     try {
-        for (auto &transfert : p_gtfs.getTransferts()) {
-
-            for (auto &arretOrigine : p_gtfs.getStations().at(get<0>(transfert)).getArrets()) {
-                set<string> ligneDejaUtilisee = {};
-                ligneDejaUtilisee.insert(p_gtfs.getLignes().find(p_gtfs.getVoyages().find(arretOrigine.second->getVoyageId())->second.getLigne())->second.getNumero());
-
-                auto arretDestinationPossible = p_gtfs.getStations().at(get<1>(transfert)).getArrets().lower_bound(arretOrigine.first.add_secondes(get<2>(transfert)));
-
-                while (arretDestinationPossible != p_gtfs.getStations().at(get<1>(transfert)).getArrets().end())
-                {
-                    string ligneDestination = p_gtfs.getLignes().find(p_gtfs.getVoyages().find(arretDestinationPossible->second->getVoyageId())->second.getLigne())->second.getNumero();
+        //les transferts de chaque station de départ, dans l'ordre où ils apparaissent
+        vector<vector<size_t> > transfertsParStation;
+        unordered_map<string, size_t> groupeDeStation;
+        for (size_t i = 0; i < p_transferts.size(); ++i) {
+            auto res = groupeDeStation.insert({get<0>(p_transferts[i]), transfertsParStation.size()});
+            if (res.second) transfertsParStation.emplace_back();
+            transfertsParStation[res.first->second].push_back(i);
+        }
 
-                    if(ligneDejaUtilisee.find(ligneDestination) == ligneDejaUtilisee.end())
+        vector<vector<tuple<size_t, size_t, unsigned int> > > arcsParTache(transfertsParStation.size());
+        executerEnParallele(transfertsParStation.size(), p_nbFils, [&](size_t tache)
+        {
+            //ligneDejaUtilisee[l] == epoque si le numéro de ligne l est déjà utilisé depuis l'arrêt courant
+            vector<unsigned int> ligneDejaUtilisee(m_nbNumerosDeLigne, 0);
+            unsigned int epoque = 0;
+            for (size_t i : transfertsParStation[tache]) {
+                auto &transfert = p_transferts[i];
+                auto &arretsDestination = p_gtfs.getStations().at(get<1>(transfert)).getArrets();
+                const Station &stationOrigine = p_gtfs.getStations().at(get<0>(transfert));
+                auto finOrigines = stationOrigine.getArrets().lower_bound(m_finFenetre);
+
+                for (auto arretOrigine = premierArretDansFenetre(stationOrigine); arretOrigine != finOrigines; ++arretOrigine) {
+                    if (!dansFenetre(*arretOrigine->second)) continue;
+                    const size_t sommetOrigine = m_sommetDeArret.at(arretOrigine->second);
+                    ++epoque;
+                    ligneDejaUtilisee[m_ligneDuSommet[sommetOrigine]] = epoque;
+
+                    auto arretDestinationPossible = arretsDestination.lower_bound(arretOrigine->first.add_secondes(get<2>(transfert)));
+
+                    for (; arretDestinationPossible != arretsDestination.end() && arretDestinationPossible->first < m_finFenetre;
+                         ++arretDestinationPossible)
                     {
-                        ligneDejaUtilisee.insert(ligneDestination);
-                        this->m_leGraphe.ajouterArc(m_sommetDeArret.at(arretOrigine.second),
-                                                        m_sommetDeArret.at(arretDestinationPossible->second),
-                                                    arretDestinationPossible->first-arretOrigine.first);
+                        if (!dansFenetre(*arretDestinationPossible->second)) continue;
+                        const size_t sommetDestination = m_sommetDeArret.at(arretDestinationPossible->second);
+                        const uint32_t ligneDestination = m_ligneDuSommet[sommetDestination];
 
+                        if(ligneDejaUtilisee[ligneDestination] != epoque)
+                        {
+                            ligneDejaUtilisee[ligneDestination] = epoque;
+                            arcsParTache[tache].emplace_back(sommetOrigine, sommetDestination,
+                                                             arretDestinationPossible->first-arretOrigine->first);
+
+                        }
                     }
-                    arretDestinationPossible++;
                 }
             }
-        }
+        });
+        fusionnerArcs(m_leGraphe, arcsParTache);
     }
-    catch (logic_error){
+    catch (const logic_error &){
         throw logic_error("Il y a une erreur");
     }
 }
 
 //! \brief ajouts des arcs d'une station à elle-même pour les stations qui ne sont pas dans DonneesGTFS::m_stationsDeTransfert
+//! \brief Chaque station est une tâche dont les arcs sont générés dans un tampon propre, puis fusionnés comme les transferts
+//! \param[in] p_nbFils: le nombre de fils d'exécution (0 pour utiliser thread::hardware_concurrency())
 //! \throws logic_error si une incohérence est détecté lors de cette étape de construction du graphe
-void ReseauGTFS::ajouterArcsAttente(const DonneesGTFS & p_gtfs)
+void ReseauGTFS::ajouterArcsAttente(const DonneesGTFS & p_gtfs, unsigned int p_nbFils)
 {
     try {
-        for (auto &station : p_gtfs.getStations()) {
-            if (p_gtfs.getStationsDeTransfert().find(station.first) == p_gtfs.getStationsDeTransfert().end()) {
-                for (auto &arretOrigine : station.second.getArrets()) {
-                    auto arretDestinationPossible = station.second.getArrets().lower_bound(arretOrigine.first.add_secondes(this->delaisMinArcsAttente));
-                    set<string> ligneDejaUtilisee = {};
-                    ligneDejaUtilisee.insert(p_gtfs.getLignes().find(p_gtfs.getVoyages().find(arretOrigine.second->getVoyageId())->second.getLigne())->second.getNumero());
-
-                    while (arretDestinationPossible != station.second.getArrets().end()) {
-                        string ligneDestination = p_gtfs.getLignes().find(p_gtfs.getVoyages().find(arretDestinationPossible->second->getVoyageId())->second.getLigne())->second.getNumero();
-                        if(ligneDejaUtilisee.find(ligneDestination) == ligneDejaUtilisee.end()) {
-
-                            ligneDejaUtilisee.insert(ligneDestination);
-                            this->m_leGraphe.ajouterArc(m_sommetDeArret.at(arretOrigine.second),
-                                                        m_sommetDeArret.at(arretDestinationPossible->second),
-                                                        arretDestinationPossible->first - arretOrigine.first
-                                                        );
-                        }
-                        arretDestinationPossible++;
+        vector<const Station *> stations;
+        for (auto &station : p_gtfs.getStations())
+            if (p_gtfs.getStationsDeTransfert().find(station.first) == p_gtfs.getStationsDeTransfert().end())
+                stations.push_back(&station.second);
+
+        vector<vector<tuple<size_t, size_t, unsigned int> > > arcsParTache(stations.size());
+        executerEnParallele(stations.size(), p_nbFils, [&](size_t tache)
+        {
+            vector<unsigned int> ligneDejaUtilisee(m_nbNumerosDeLigne, 0); //voir ajouterArcsTransferts()
+            unsigned int epoque = 0;
+            auto &arrets = stations[tache]->getArrets();
+            auto finArrets = arrets.lower_bound(m_finFenetre);
+            for (auto arretOrigine = premierArretDansFenetre(*stations[tache]); arretOrigine != finArrets; ++arretOrigine) {
+                if (!dansFenetre(*arretOrigine->second)) continue;
+                auto arretDestinationPossible = arrets.lower_bound(arretOrigine->first.add_secondes(delaisMinArcsAttente));
+                const size_t sommetOrigine = m_sommetDeArret.at(arretOrigine->second);
+                ++epoque;
+                ligneDejaUtilisee[m_ligneDuSommet[sommetOrigine]] = epoque;
+
+                for (; arretDestinationPossible != arrets.end() && arretDestinationPossible->first < m_finFenetre;
+                     ++arretDestinationPossible) {
+                    if (!dansFenetre(*arretDestinationPossible->second)) continue;
+                    const size_t sommetDestination = m_sommetDeArret.at(arretDestinationPossible->second);
+                    const uint32_t ligneDestination = m_ligneDuSommet[sommetDestination];
+                    if(ligneDejaUtilisee[ligneDestination] != epoque) {
+
+                        ligneDejaUtilisee[ligneDestination] = epoque;
+                        arcsParTache[tache].emplace_back(sommetOrigine, sommetDestination,
+                                                         arretDestinationPossible->first - arretOrigine->first
+                                                         );
                     }
                 }
             }
-        }
+        });
+        fusionnerArcs(m_leGraphe, arcsParTache);
     }
     catch (...){
         throw logic_error("ajouterArcsAttente");
@@ -106,104 +153,138 @@ void ReseauGTFS::ajouterArcsAttente(const DonneesGTFS & p_gtfs)
 }
 
 
-//! \brief ajoute des arcs au réseau GTFS à partir des données GTFS
-//! \brief Il s'agit des arcs allant du point origine vers une station si celle-ci est accessible à pieds et des arcs allant d'une station vers le point destination
-//! \param[in] p_gtfs: un objet DonneesGTFS
+//! \brief construit les arcs d'une requête partant au début de la fenêtre du réseau, sans modifier le graphe
 //! \param[in] p_pointOrigine: les coordonnées GPS du point origine
 //! \param[in] p_pointDestination: les coordonnées GPS du point destination
-//! \throws logic_error si une incohérence est détecté lors de la construction du graphe
-//! \post constuit un réseau GTFS représenté par un graphe orienté pondéré avec poids non négatifs
-//! \post assigne la variable m_origine_dest_ajoute à true (car les points orignine et destination font parti du graphe)
-//! \post insère dans m_sommetsVersDestination les numéros de sommets connctés au point destination
-void ReseauGTFS::ajouterArcsOrigineDestination(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
-                                               const Coordonnees &p_pointDestination)
+//! \return la requête dont les arcs relient le sommet origine virtuel et le sommet destination virtuel aux sommets du graphe
+//! \throws logic_error si une incohérence est détecté lors de la construction des arcs
+ReseauGTFS::Requete ReseauGTFS::preparerRequete(const Coordonnees &p_pointOrigine,
+                                                const Coordonnees &p_pointDestination) const
 {
+    return preparerRequete(p_pointOrigine, p_pointDestination, m_debutFenetre);
+}
 
-    Arret::Ptr arret_ptr_origine = make_shared<Arret>(this->stationIdOrigine, Heure(), Heure(),0, "origine");
-    m_arretDuSommet.push_back(arret_ptr_origine);
-    m_sommetDeArret.insert({arret_ptr_origine, m_arretDuSommet.size() - 1});
-    this->m_sommetOrigine = m_sommetDeArret.at(arret_ptr_origine);
-
-    shared_ptr<Arret> arret_ptr_Destination = make_shared<Arret>(this->stationIdDestination, Heure(), Heure(),0, "destination");
-    m_arretDuSommet.push_back(arret_ptr_Destination);
-    m_sommetDeArret.insert({arret_ptr_Destination, m_arretDuSommet.size() - 1});
-    this->m_sommetDestination = m_sommetDeArret.at(arret_ptr_Destination);
-
-    this->m_leGraphe.resize(m_arretDuSommet.size());
-
-    for (auto &station : p_gtfs.getStations()) {
-        double distanceMarcheOrigineStation = p_pointOrigine - station.second.getCoords();
-
-        if (distanceMarcheOrigineStation <= this->distanceMaxMarche)
-        {
-            set<string> ligneDejaUtilisee = {};
-            auto arretDestinationPossible = station.second.getArrets().lower_bound(p_gtfs.getTempsDebut().add_secondes(distanceMarcheOrigineStation / this->vitesseDeMarche*3600));
-
-            while (arretDestinationPossible != station.second.getArrets().end()) {
-                string ligneDestination = p_gtfs.getLignes().find(p_gtfs.getVoyages().find(arretDestinationPossible->second->getVoyageId())->second.getLigne())->second.getNumero();
-                if(ligneDejaUtilisee.find(ligneDestination) == ligneDejaUtilisee.end()){
-
-                    ligneDejaUtilisee.insert(ligneDestination);
-                    this->m_leGraphe.ajouterArc(this->m_sommetOrigine,
-                                                m_sommetDeArret.at(arretDestinationPossible->second),
-                                                arretDestinationPossible->first - p_gtfs.getTempsDebut());
-
+//! \brief construit les arcs d'une requête à partir de l'index des stations du réseau, sans modifier le graphe
+//! \brief Il s'agit des arcs allant du point origine vers une station si celle-ci est accessible à pieds et des arcs allant d'une station vers le point destination
+//! \brief Un même graphe, construit pour toute la journée, répond ainsi à des requêtes partant à n'importe quelle heure
+//! \param[in] p_pointOrigine: les coordonnées GPS du point origine
+//! \param[in] p_pointDestination: les coordonnées GPS du point destination
+//! \param[in] p_heureDepart: l'heure de départ du point origine
+//! \return la requête dont les arcs relient le sommet origine virtuel et le sommet destination virtuel aux sommets du graphe
+//! \throws logic_error si p_heureDepart n'appartient pas à la fenêtre [getDebutFenetre(), getFinFenetre())
+//! \throws logic_error si une incohérence est détecté lors de la construction des arcs
+ReseauGTFS::Requete ReseauGTFS::preparerRequete(const Coordonnees &p_pointOrigine,
+                                                const Coordonnees &p_pointDestination, const Heure &p_heureDepart) const
+{
+    if (p_heureDepart < m_debutFenetre || p_heureDepart >= m_finFenetre)
+        throw logic_error("ReseauGTFS::preparerRequete(): l'heure de départ est hors de l'intervalle du réseau");
+
+    Requete requete;
+    requete.heureDepart = p_heureDepart;
+    requete.arcs.depuisOrigine = arcsDepuisOrigine(p_pointOrigine, p_heureDepart);
+    requete.arcs.versDestination = arcsVersDestination(p_pointDestination);
+    return requete;
+}
 
-                    this->m_nbArcsOrigineVersStations++;
-                }
-                arretDestinationPossible++;
+//! \brief construit les arcs allant du point origine vers les arrêts des stations accessibles à pieds
+//! \brief pour chaque station, seul le premier départ atteignable de chaque ligne est relié au point origine
+//! \param[in] p_pointOrigine: les coordonnées GPS du point origine
+//! \param[in] p_heureDepart: l'heure de départ du point origine; le poids de chaque arc est mesuré à partir de cette heure
+//! \return les paires (sommet, poids) des arcs du sommet origine virtuel
+std::vector<std::pair<size_t, unsigned int> > ReseauGTFS::arcsDepuisOrigine(const Coordonnees &p_pointOrigine,
+                                                                             const Heure &p_heureDepart) const
+{
+    std::vector<std::pair<size_t, unsigned int> > arcs;
+    vector<unsigned int> ligneDejaUtilisee(m_nbNumerosDeLigne, 0); //ligneDejaUtilisee[l] == epoque: ligne l déjà reliée
+    unsigned int epoque = 0;
+
+    //seules les stations à distance de marche sont examinées (voir IndexStations); une station confondue avec le point
+    //est à distance 0
+    for (const auto &voisin : m_indexStations.dansRayon(p_pointOrigine, distanceMaxMarche, true)) {
+        const auto &station = *voisin.station;
+        double distanceMarcheOrigineStation = voisin.distance;
+        ++epoque;
+        size_t nbLignesUtilisees = 0;
+        const size_t nbLignes = m_nbLignesDeStation.at(station.first);
+        //recherche binaire du premier départ atteignable; on s'arrête dès que chaque ligne a son arc
+        auto arretDestinationPossible = station.second.getArrets().lower_bound(p_heureDepart.add_secondes(distanceMarcheOrigineStation / vitesseDeMarche*3600));
+
+        //l'heure de départ appartient à la fenêtre: tout arrêt arrivant avant m_finFenetre y est aussi
+        while (arretDestinationPossible != station.second.getArrets().end()
+               && arretDestinationPossible->first < m_finFenetre && nbLignesUtilisees < nbLignes) {
+            const size_t sommetDestination = m_sommetDeArret.at(arretDestinationPossible->second);
+            const uint32_t ligneDestination = m_ligneDuSommet[sommetDestination];
+            if(ligneDejaUtilisee[ligneDestination] != epoque){
+
+                ligneDejaUtilisee[ligneDestination] = epoque;
+                ++nbLignesUtilisees;
+                arcs.push_back({sommetDestination, arretDestinationPossible->first - p_heureDepart});
             }
+            arretDestinationPossible++;
         }
+    }
 
+    return arcs;
+}
 
-        double distanceMarcheStationDestination =  p_pointDestination - station.second.getCoords();
-
-        if (distanceMarcheStationDestination <= this->distanceMaxMarche)
-        {
-            for (auto arretOriginePossible : station.second.getArrets()) {
-                this->m_leGraphe.ajouterArc(m_sommetDeArret.at(arretOriginePossible.second),
-                                            this->m_sommetDestination,
-                                            distanceMarcheStationDestination / this->vitesseDeMarche*3600);
-
-                this->m_sommetsVersDestination.push_back(m_sommetDeArret.at(arretOriginePossible.second));
-                this->m_nbArcsStationsVersDestination++;
-            }
+//! \brief construit les arcs allant de chaque arrêt des stations accessibles à pieds vers le point destination
+//! \param[in] p_pointDestination: les coordonnées GPS du point destination
+//! \return les paires (sommet, poids) des arcs vers le sommet destination virtuel
+std::vector<std::pair<size_t, unsigned int> > ReseauGTFS::arcsVersDestination(const Coordonnees &p_pointDestination) const
+{
+    std::vector<std::pair<size_t, unsigned int> > arcs;
+
+    for (const auto &voisin : m_indexStations.dansRayon(p_pointDestination, distanceMaxMarche, true)) {
+        const auto &station = *voisin.station;
+        double distanceMarcheStationDestination = voisin.distance;
+        auto finArrets = station.second.getArrets().lower_bound(m_finFenetre);
+        for (auto arretOriginePossible = premierArretDansFenetre(station.second); arretOriginePossible != finArrets;
+             ++arretOriginePossible) {
+            if (!dansFenetre(*arretOriginePossible->second)) continue;
+            arcs.push_back({m_sommetDeArret.at(arretOriginePossible->second),
+                            static_cast<unsigned int>(distanceMarcheStationDestination / vitesseDeMarche*3600)});
         }
     }
 
-    this->m_origine_dest_ajoute = true;
+    return arcs;
 }
 
-//! \brief Remet ReseauGTFS dans l'était qu'il était avant l'exécution de ReseauGTFS::ajouterArcsOrigineDestination()
+//! \brief ajoute au réseau GTFS la requête allant du point origine au point destination
 //! \param[in] p_gtfs: un objet DonneesGTFS
-//! \throws logic_error si une incohérence est détecté lors de la modification du graphe
-//! \post Enlève de ReaseauGTFS tous les arcs allant du point source vers un arrêt de station et ceux allant d'un arrêt de station vers la destination
-//! \post assigne la variable m_origine_dest_ajoute à false (les points orignine et destination sont enlevés du graphe)
-//! \post enlève les données de m_sommetsVersDestination
-void ReseauGTFS::enleverArcsOrigineDestination()
+//! \param[in] p_pointOrigine: les coordonnées GPS du point origine
+//! \param[in] p_pointDestination: les coordonnées GPS du point destination
+//! \throws logic_error si une incohérence est détecté lors de la construction des arcs
+//! \post m_requete contient les arcs du point origine et vers le point destination; m_leGraphe n'est pas modifié
+//! \post assigne la variable m_origine_dest_ajoute à true
+void ReseauGTFS::ajouterArcsOrigineDestination(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                                               const Coordonnees &p_pointDestination)
 {
-    try {
-        for(size_t arret : m_sommetsVersDestination) {
-            m_leGraphe.enleverArc(arret, this->m_sommetDestination);
-        }
-
-        m_sommetDeArret.erase(m_arretDuSommet.at(this->m_sommetOrigine));
-        m_sommetDeArret.erase(m_arretDuSommet.at(this->m_sommetDestination));
-
-        m_sommetsVersDestination.clear();
-
-        m_arretDuSommet.pop_back();
-        m_arretDuSommet.pop_back();
+    ajouterArcsOrigineDestination(p_gtfs, p_pointOrigine, p_pointDestination, m_debutFenetre);
+}
 
-        this->m_leGraphe.resize(m_arretDuSommet.size());
+//! \brief ajoute au réseau GTFS la requête allant du point origine au point destination, en partant à p_heureDepart
+//! \param[in] p_gtfs: un objet DonneesGTFS
+//! \param[in] p_pointOrigine: les coordonnées GPS du point origine
+//! \param[in] p_pointDestination: les coordonnées GPS du point destination
+//! \param[in] p_heureDepart: l'heure de départ du point origine
+//! \throws logic_error si p_heureDepart n'appartient pas à la fenêtre [getDebutFenetre(), getFinFenetre())
+//! \throws logic_error si une incohérence est détecté lors de la construction des arcs
+//! \post m_requete contient les arcs du point origine et vers le point destination; m_leGraphe n'est pas modifié
+//! \post assigne la variable m_origine_dest_ajoute à true
+void ReseauGTFS::ajouterArcsOrigineDestination(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                                               const Coordonnees &p_pointDestination, const Heure &p_heureDepart)
+{
+    m_requete = preparerRequete(p_pointOrigine, p_pointDestination, p_heureDepart);
+    this->m_origine_dest_ajoute = true;
+}
 
-        m_nbArcsStationsVersDestination = 0;
-        m_nbArcsOrigineVersStations = 0;
-        this->m_origine_dest_ajoute = false;
-    }
-    catch (logic_error e){
-        throw logic_error("Enelver arc origine destination");
-    }
+//! \brief Remet ReseauGTFS dans l'était qu'il était avant l'exécution de ReseauGTFS::ajouterArcsOrigineDestination()
+//! \post vide m_requete; comme le graphe n'a pas été modifié, aucune liste d'adjacence n'est parcourue
+//! \post assigne la variable m_origine_dest_ajoute à false
+void ReseauGTFS::enleverArcsOrigineDestination()
+{
+    m_requete = Requete();
+    this->m_origine_dest_ajoute = false;
 }
 
 
@@ -0,0 +1,169 @@
+//
+// Cache des résultats de ReseauGTFS::itineraire(), pour les requêtes répétées entre les mêmes secteurs
+//
+
+#include "cacheItineraires.h"
+
+using namespace std;
+
+bool CacheItineraires::Cle::operator==(const Cle &p_autre) const
+{
+    return origine == p_autre.origine && destination == p_autre.destination && minute == p_autre.minute;
+}
+
+size_t CacheItineraires::HachageCle::operator()(const Cle &p_cle) const
+{
+    size_t h = hash<const void *>()(p_cle.origine);
+    h = h * 31 + hash<const void *>()(p_cle.destination);
+    return h * 31 + p_cle.minute;
+}
+
+//! \brief construit un cache vide
+//! \param[in] p_gtfs: l'objet DonneesGTFS ayant servi à construire p_reseau; tous deux doivent survivre au cache
+//! \param[in] p_reseau: le réseau dont les itinéraires sont mémorisés
+//! \param[in] p_memoireMax: la taille maximale des entrées, en octets; les moins récemment utilisées sont évincées
+//! \param[in] p_rayonAccrochage: la distance maximale, en km, entre un point et la station à laquelle il est accroché
+//! \throws logic_error si p_rayonAccrochage est négatif
+CacheItineraires::CacheItineraires(const DonneesGTFS &p_gtfs, const ReseauGTFS &p_reseau, size_t p_memoireMax,
+                                   double p_rayonAccrochage)
+        : m_gtfs(p_gtfs), m_reseau(p_reseau), m_index(p_gtfs.getStations(), max(p_rayonAccrochage, 0.05)),
+          m_memoireMax(p_memoireMax), m_rayonAccrochage(p_rayonAccrochage), m_memoire(0),
+          m_generation(p_reseau.getGeneration()), m_nbSucces(0), m_nbEchecs(0), m_nbContournements(0)
+{
+    if (!(p_rayonAccrochage >= 0))
+        throw logic_error("CacheItineraires: le rayon d'accrochage doit être positif ou nul");
+}
+
+//! \brief retourne l'itinéraire d'une requête, mémorisé si sa clé a déjà été demandée
+//! \param[in] p_origine, p_destination: les points de la requête
+//! \param[in] p_heureDepart: l'heure de départ, dans la fenêtre du réseau
+//! \return le temps du trajet (mesuré à partir du départ de la requête représentative) et ses tronçons
+//! \throws logic_error si p_heureDepart n'appartient pas à la fenêtre du réseau
+CacheItineraires::Resultat CacheItineraires::itineraire(const Coordonnees &p_origine, const Coordonnees &p_destination,
+                                      const Heure &p_heureDepart)
+{
+    vector<IndexStations::Voisin> origine = m_index.plusProches(p_origine, 1);
+    vector<IndexStations::Voisin> destination = m_index.plusProches(p_destination, 1);
+    if (origine.empty() || destination.empty() || origine[0].distance > m_rayonAccrochage
+        || destination[0].distance > m_rayonAccrochage)
+    {
+        {
+            lock_guard<mutex> verrou(m_mutex);
+            ++m_nbContournements;
+        }
+        return calculer(p_origine, p_destination, p_heureDepart);
+    }
+
+    const unsigned int secondes = static_cast<unsigned int>(p_heureDepart - Heure(0, 0, 0));
+    Cle cle{origine[0].station, destination[0].station, secondes / 60};
+    {
+        lock_guard<mutex> verrou(m_mutex);
+        if (m_reseau.getGeneration() != m_generation)
+        {
+            viderSansVerrou();
+            m_generation = m_reseau.getGeneration();
+        }
+        auto position = m_positions.find(cle);
+        if (position != m_positions.end())
+        {
+            ++m_nbSucces;
+            m_entrees.splice(m_entrees.begin(), m_entrees, position->second);
+            return position->second->resultat;
+        }
+        ++m_nbEchecs;
+    }
+
+    //la recherche se fait hors du verrou; deux fils peuvent alors calculer la même clé, avec le même résultat
+    Heure depart = Heure(0, 0, 0).add_secondes(cle.minute * 60);
+    if (depart < m_reseau.getDebutFenetre()) depart = m_reseau.getDebutFenetre();
+    Entree entree{cle, calculer(origine[0].station->second.getCoords(), destination[0].station->second.getCoords(), depart)};
+
+    lock_guard<mutex> verrou(m_mutex);
+    const size_t taille = tailleEntree(entree);
+    if (m_reseau.getGeneration() != m_generation || taille > m_memoireMax
+        || m_positions.find(cle) != m_positions.end())
+        return entree.resultat;
+    while (m_memoire + taille > m_memoireMax)
+    {
+        m_memoire -= tailleEntree(m_entrees.back());
+        m_positions.erase(m_entrees.back().cle);
+        m_entrees.pop_back();
+    }
+    m_entrees.push_front(entree);
+    m_entrees.front().resultat.troncons.shrink_to_fit();
+    m_positions.insert({cle, m_entrees.begin()});
+    m_memoire += taille;
+    return entree.resultat;
+}
+
+//! \brief calcule un itinéraire avec le réseau et regroupe ses arrêts en tronçons
+CacheItineraires::Resultat CacheItineraires::calculer(const Coordonnees &p_origine, const Coordonnees &p_destination,
+                                                      const Heure &p_heureDepart) const
+{
+    ReseauGTFS::Requete requete = m_reseau.preparerRequete(p_origine, p_destination, p_heureDepart);
+    vector<Arret::Ptr> arrets;
+    long tempsRecherche;
+    Resultat resultat;
+    resultat.tempsDuTrajet = m_reseau.itineraire(m_gtfs, requete, arrets, tempsRecherche);
+    for (size_t k = 0; k + 1 < arrets.size();)
+    {
+        size_t fin = k;
+        while (fin + 1 < arrets.size() && arrets[fin + 1]->getVoyageId() == arrets[k]->getVoyageId()) ++fin;
+        if (fin > k) resultat.troncons.push_back({arrets[k], arrets[fin]});
+        k = fin + 1;
+    }
+    return resultat;
+}
+
+//! \brief estimation des octets occupés par une entrée: noeud de la liste, noeud de la table et tronçons
+size_t CacheItineraires::tailleEntree(const Entree &p_entree)
+{
+    return sizeof(Entree) + 2 * sizeof(void *)
+           + sizeof(pair<const Cle, list<Entree>::iterator>) + 2 * sizeof(void *) + sizeof(size_t)
+           + p_entree.resultat.troncons.size() * sizeof(Troncon);
+}
+
+//! \brief enlève toutes les entrées; les compteurs sont conservés
+void CacheItineraires::vider()
+{
+    lock_guard<mutex> verrou(m_mutex);
+    viderSansVerrou();
+}
+
+void CacheItineraires::viderSansVerrou()
+{
+    m_entrees.clear();
+    m_positions.clear();
+    m_memoire = 0;
+}
+
+size_t CacheItineraires::getNbSucces() const
+{
+    lock_guard<mutex> verrou(m_mutex);
+    return m_nbSucces;
+}
+
+size_t CacheItineraires::getNbEchecs() const
+{
+    lock_guard<mutex> verrou(m_mutex);
+    return m_nbEchecs;
+}
+
+size_t CacheItineraires::getNbContournements() const
+{
+    lock_guard<mutex> verrou(m_mutex);
+    return m_nbContournements;
+}
+
+size_t CacheItineraires::getNbEntrees() const
+{
+    lock_guard<mutex> verrou(m_mutex);
+    return m_entrees.size();
+}
+
+//! \brief retourne la taille estimée des entrées, en octets (toujours au plus p_memoireMax)
+size_t CacheItineraires::getTailleMemoire() const
+{
+    lock_guard<mutex> verrou(m_mutex);
+    return m_memoire;
+}
@@ -0,0 +1,90 @@
+//
+// Cache des résultats de ReseauGTFS::itineraire(), pour les requêtes répétées entre les mêmes secteurs
+//
+
+#ifndef TP2_CACHEITINERAIRES_H
+#define TP2_CACHEITINERAIRES_H
+
+#include "ReseauGTFS.h"
+#include "indexStations.h"
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+//! \brief Cache LRU des itinéraires d'un ReseauGTFS, borné en mémoire
+//! \brief Une requête est accrochée à sa clé: la station la plus proche de l'origine, celle de la destination (si
+//! \brief chacune est à au plus p_rayonAccrochage km) et la minute de départ. Le résultat d'une clé est celui de la
+//! \brief requête représentative, partant de la première station à la première seconde de la minute (ou au début de la
+//! \brief fenêtre du réseau) vers la seconde station; il ne dépend donc pas de la requête qui l'a calculé.
+//! \brief Une requête dont un point est trop loin de toute station contourne le cache et est calculée exactement.
+//! \brief Le cache est vidé dès que le réseau change de génération (ReseauGTFS::getGeneration()), par exemple après
+//! \brief avancerFenetre(). Ses méthodes peuvent être appelées simultanément par plusieurs fils d'exécution.
+class CacheItineraires
+{
+
+public:
+    //! \brief un trajet à bord d'un même voyage
+    struct Troncon
+    {
+        Arret::Ptr montee;
+        Arret::Ptr descente;
+    };
+
+    struct Resultat
+    {
+        unsigned int tempsDuTrajet; //en secondes (= numeric_limits<unsigned int>::max() si inatteignable)
+        std::vector<Troncon> troncons; //dans l'ordre du trajet; les marches et les attentes sont entre deux tronçons
+    };
+
+    CacheItineraires(const DonneesGTFS &, const ReseauGTFS &, size_t p_memoireMax, double p_rayonAccrochage = 0.1);
+    Resultat itineraire(const Coordonnees &, const Coordonnees &, const Heure &);
+    void vider();
+    size_t getNbSucces() const;
+    size_t getNbEchecs() const;
+    size_t getNbContournements() const;
+    size_t getNbEntrees() const;
+    size_t getTailleMemoire() const;
+
+private:
+    struct Cle
+    {
+        const IndexStations::EntreeStation *origine;
+        const IndexStations::EntreeStation *destination;
+        unsigned int minute; //minute de départ depuis minuit
+
+        bool operator==(const Cle &) const;
+    };
+
+    struct HachageCle
+    {
+        size_t operator()(const Cle &) const;
+    };
+
+    struct Entree
+    {
+        Cle cle;
+        Resultat resultat;
+    };
+
+    const DonneesGTFS &m_gtfs;
+    const ReseauGTFS &m_reseau;
+    IndexStations m_index;
+    size_t m_memoireMax; //en octets, estimée par tailleEntree()
+    double m_rayonAccrochage; //en km
+
+    mutable std::mutex m_mutex; //protège tous les membres qui suivent
+    std::list<Entree> m_entrees; //de la plus récemment utilisée à la moins récemment utilisée
+    std::unordered_map<Cle, std::list<Entree>::iterator, HachageCle> m_positions;
+    size_t m_memoire;
+    unsigned long m_generation; //génération du réseau des entrées
+    size_t m_nbSucces;
+    size_t m_nbEchecs;
+    size_t m_nbContournements;
+
+    Resultat calculer(const Coordonnees &, const Coordonnees &, const Heure &) const;
+    static size_t tailleEntree(const Entree &);
+    void viderSansVerrou();
+};
+
+
+#endif //TP2_CACHEITINERAIRES_H
@@ -0,0 +1,151 @@
+//
+// Distances d'un point à toutes les stations en un seul balayage vectorisé (AVX2 si le processeur le permet)
+//
+
+#include "distancesStations.h"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define DISTANCES_STATIONS_AVX2
+#endif
+
+using namespace std;
+
+constexpr double DistancesStations::rayonTerre;
+
+static const double radiansParDegre = 3.14159265358979323846 / 180.0;
+
+//! \brief vecteur unitaire d'un point, tel qu'utilisé implicitement par Coordonnees::operator-
+static void vecteurUnitaire(const Coordonnees &p_point, double &p_x, double &p_y, double &p_z)
+{
+    const double latitude = p_point.getLatitude() * radiansParDegre;
+    const double longitude = p_point.getLongitude() * radiansParDegre;
+    p_x = cos(latitude) * cos(longitude);
+    p_y = cos(latitude) * sin(longitude);
+    p_z = sin(latitude);
+}
+
+#ifdef DISTANCES_STATIONS_AVX2
+//! \brief balayage de 4 stations à la fois; p_nb est un multiple de 4
+//! \brief pas de fma: les produits et les sommes sont arrondis comme dans dansRayonScalaire()
+__attribute__((target("avx2")))
+static void balayerAVX2(const double *p_x, const double *p_y, const double *p_z, size_t p_nb, double p_px, double p_py,
+                        double p_pz, double p_seuil, vector<uint32_t> &p_indices)
+{
+    const __m256d px = _mm256_set1_pd(p_px);
+    const __m256d py = _mm256_set1_pd(p_py);
+    const __m256d pz = _mm256_set1_pd(p_pz);
+    const __m256d seuil = _mm256_set1_pd(p_seuil);
+    for (size_t i = 0; i < p_nb; i += 4)
+    {
+        __m256d produit = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(p_x + i), px),
+                                        _mm256_mul_pd(_mm256_loadu_pd(p_y + i), py));
+        produit = _mm256_add_pd(produit, _mm256_mul_pd(_mm256_loadu_pd(p_z + i), pz));
+        int masque = _mm256_movemask_pd(_mm256_cmp_pd(produit, seuil, _CMP_GE_OQ));
+        while (masque)
+        {
+            p_indices.push_back(static_cast<uint32_t>(i + __builtin_ctz(masque)));
+            masque &= masque - 1;
+        }
+    }
+}
+#endif
+
+//! \brief construit les tableaux de vecteurs unitaires
+//! \param[in] p_stations: les stations (normalement DonneesGTFS::getStations())
+//! \throws logic_error s'il y a plus de stations que d'indices sur 32 bits
+DistancesStations::DistancesStations(const std::map<std::string, Station> &p_stations)
+{
+    if (p_stations.size() >= numeric_limits<uint32_t>::max())
+        throw logic_error("DistancesStations::DistancesStations(): trop de stations");
+    const size_t nbComplete = (p_stations.size() + 3) / 4 * 4;
+    m_x.reserve(nbComplete);
+    m_y.reserve(nbComplete);
+    m_z.reserve(nbComplete);
+    for (const auto &station : p_stations)
+    {
+        double x, y, z;
+        vecteurUnitaire(station.second.getCoords(), x, y, z);
+        m_stations.push_back(&station);
+        m_x.push_back(x);
+        m_y.push_back(y);
+        m_z.push_back(z);
+    }
+    m_x.resize(nbComplete, numeric_limits<double>::quiet_NaN());
+    m_y.resize(nbComplete, numeric_limits<double>::quiet_NaN());
+    m_z.resize(nbComplete, numeric_limits<double>::quiet_NaN());
+}
+
+//! \brief cos(p_rayon / R): le produit scalaire minimal d'une station dans le rayon
+double DistancesStations::seuil(double p_rayon)
+{
+    return cos(min(p_rayon / rayonTerre, 3.14159265358979323846));
+}
+
+//! \brief retourne les stations à au plus p_rayon km d'un point, avec AVX2 si le processeur le permet
+//! \param[in] p_point: le point
+//! \param[in] p_rayon: le rayon de recherche, en km
+//! \return les indices des stations (voir getStation()), en ordre croissant; comme IndexStations::dansRayon() avec
+//! \return p_confondusInclus, à un arrondi près pour une station à la frontière du cercle
+std::vector<uint32_t> DistancesStations::dansRayon(const Coordonnees &p_point, double p_rayon) const
+{
+#ifdef DISTANCES_STATIONS_AVX2
+    if (avx2Disponible())
+    {
+        double x, y, z;
+        vecteurUnitaire(p_point, x, y, z);
+        vector<uint32_t> indices;
+        balayerAVX2(m_x.data(), m_y.data(), m_z.data(), m_x.size(), x, y, z, seuil(p_rayon), indices);
+        return indices;
+    }
+#endif
+    return dansRayonScalaire(p_point, p_rayon);
+}
+
+//! \brief version de référence de dansRayon(), une station à la fois
+std::vector<uint32_t> DistancesStations::dansRayonScalaire(const Coordonnees &p_point, double p_rayon) const
+{
+    double x, y, z;
+    vecteurUnitaire(p_point, x, y, z);
+    const double s = seuil(p_rayon);
+    vector<uint32_t> indices;
+    for (size_t i = 0; i < m_stations.size(); ++i)
+    {
+        double produit = m_x[i] * x + m_y[i] * y;
+        produit = produit + m_z[i] * z;
+        if (produit >= s) indices.push_back(static_cast<uint32_t>(i));
+    }
+    return indices;
+}
+
+//! \brief retourne la station d'un indice retourné par dansRayon()
+const DistancesStations::EntreeStation *DistancesStations::getStation(uint32_t p_indice) const
+{
+    return m_stations.at(p_indice);
+}
+
+size_t DistancesStations::getNbStations() const
+{
+    return m_stations.size();
+}
+
+//! \brief retourne le nombre d'octets des tableaux (les stations elles-mêmes ne sont pas comptées)
+size_t DistancesStations::getTailleMemoire() const
+{
+    return m_stations.capacity() * sizeof(const EntreeStation *)
+           + (m_x.capacity() + m_y.capacity() + m_z.capacity()) * sizeof(double);
+}
+
+//! \brief indique si le processeur permet AVX2 (et si la version AVX2 a été compilée)
+bool DistancesStations::avx2Disponible()
+{
+#ifdef DISTANCES_STATIONS_AVX2
+    static const bool disponible = __builtin_cpu_supports("avx2");
+    return disponible;
+#else
+    return false;
+#endif
+}
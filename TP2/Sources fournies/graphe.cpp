@@ -12,9 +12,12 @@ using namespace std;
 //! \brief Constructeur avec paramètre du nombre de sommets désiré
 //! \param[in] p_nbSommets indique le nombre de sommets désiré
 //! \post crée le vecteur de p_nbSommets de listes d'adjacence vides avec nbArcs=0
-Graphe::Graphe(size_t p_nbSommets)
-        : m_listesAdj(p_nbSommets), m_nbArcs(0)
+//! \throws logic_error lorsque Indice ne peut pas numéroter p_nbSommets sommets et les deux sommets virtuels
+template<typename Indice, typename Poids, template<typename> class Stockage>
+GrapheGenerique<Indice, Poids, Stockage>::GrapheGenerique(size_t p_nbSommets)
+        : m_nbArcs(0)
 {
+    resize(p_nbSommets);
 }
 
 //! \brief change le nombre de sommets du graphe
@@ -23,8 +26,12 @@ Graphe::Graphe(size_t p_nbSommets)
 //! \post les anciennes listes d'adjacence sont toujours présentes lorsque p_nouvelleTaille >= à l'ancienne taille
 //! \post les dernières listes d'adjacence sont enlevées lorsque p_nouvelleTaille < à l'ancienne taille
 //! \post nbArcs est diminué par le nombre d'arcs sortant des sommets à enlever si certaines listes d'adgacence sont supprimées
-void Graphe::resize(size_t p_nouvelleTaille)
+//! \throws logic_error lorsque Indice ne peut pas numéroter p_nouvelleTaille sommets et les deux sommets virtuels
+template<typename Indice, typename Poids, template<typename> class Stockage>
+void GrapheGenerique<Indice, Poids, Stockage>::resize(size_t p_nouvelleTaille)
 {
+    if (p_nouvelleTaille >= static_cast<size_t>(aucun) - 1)
+        throw logic_error("Graphe::resize(): trop de sommets pour le type des indices");
     if (p_nouvelleTaille < m_listesAdj.size()) //certaines listes d'adj seront supprimées
     {
         //diminuer nbArcs par le nb d'arcs sortant des sommets à enlever
@@ -36,32 +43,46 @@ void Graphe::resize(size_t p_nouvelleTaille)
     m_listesAdj.resize(p_nouvelleTaille);
 }
 
-size_t Graphe::getNbSommets() const
+template<typename Indice, typename Poids, template<typename> class Stockage>
+size_t GrapheGenerique<Indice, Poids, Stockage>::getNbSommets() const
 {
     return m_listesAdj.size();
 }
 
-size_t Graphe::getNbArcs() const
+template<typename Indice, typename Poids, template<typename> class Stockage>
+size_t GrapheGenerique<Indice, Poids, Stockage>::getNbArcs() const
 {
     return m_nbArcs;
 }
 
+//! \brief retourne une estimation du nombre d'octets occupés par les listes d'adjacence
+//! \brief le coût des arcs d'une liste est donné par la politique de stockage
+template<typename Indice, typename Poids, template<typename> class Stockage>
+size_t GrapheGenerique<Indice, Poids, Stockage>::getTailleMemoire() const
+{
+    size_t taille = m_listesAdj.capacity() * sizeof(typename Stockage<Arc>::Liste);
+    for (const auto &liste : m_listesAdj)
+        taille += Stockage<Arc>::tailleMemoire(liste);
+    return taille;
+}
+
 //! \brief ajoute un arc d'un poids donné dans le graphe
 //! \param[in] i: le sommet origine de l'arc
 //! \param[in] j: le sommet destination de l'arc
 //! \param[in] poids: le poids de l'arc
 //! \pre les sommets i et j doivent exister
 //! \throws logic_error lorsque le sommet i ou le sommet j n'existe pas
-//! \throws logic_error lorsque le poids == numeric_limits<unsigned int>::max()
-void Graphe::ajouterArc(size_t i, size_t j, unsigned int poids)
+//! \throws logic_error lorsque le poids >= numeric_limits<Poids>::max(): il n'est pas représentable sans perte
+template<typename Indice, typename Poids, template<typename> class Stockage>
+void GrapheGenerique<Indice, Poids, Stockage>::ajouterArc(size_t i, size_t j, unsigned long long poids)
 {
     if (i >= m_listesAdj.size())
         throw logic_error("Graphe::ajouterArc(): tentative d'ajouter l'arc(i,j) avec un sommet i inexistant");
     if (j >= m_listesAdj.size())
         throw logic_error("Graphe::ajouterArc(): tentative d'ajouter l'arc(i,j) avec un sommet j inexistant");
-    if (poids == numeric_limits<unsigned int>::max())
+    if (poids >= infini)
         throw logic_error("Graphe::ajouterArc(): valeur de poids interdite");
-    m_listesAdj[i].emplace_back(Arc(j, poids));
+    m_listesAdj[i].emplace_back(Arc(static_cast<Indice>(j), static_cast<Poids>(poids)));
     ++m_nbArcs;
 }
 
@@ -72,7 +93,8 @@ void Graphe::ajouterArc(size_t i, size_t j, unsigned int poids)
 //! \post enlève l'arc mais n'enlève jamais le sommet i
 //! \throws logic_error lorsque le sommet i ou le sommet j n'existe pas
 //! \throws logic_error lorsque l'arc n'existe pas
-void Graphe::enleverArc(size_t i, size_t j)
+template<typename Indice, typename Poids, template<typename> class Stockage>
+void GrapheGenerique<Indice, Poids, Stockage>::enleverArc(size_t i, size_t j)
 {
     if (i >= m_listesAdj.size())
         throw logic_error("Graphe::enleverArc(): tentative d'enlever l'arc(i,j) avec un sommet i inexistant");
@@ -95,8 +117,102 @@ void Graphe::enleverArc(size_t i, size_t j)
     --m_nbArcs;
 }
 
+//! \brief renumérote les sommets du graphe
+//! \brief les listes d'adjacence sont reconstruites dans le nouvel ordre des sommets, ce qui range aussi leurs arcs
+//! \brief en mémoire dans cet ordre
+//! \param[in] p_nouveauNumero: p_nouveauNumero[i] est le nouveau numéro de l'ancien sommet i
+//! \post l'arc (i,j) de poids p devient l'arc (p_nouveauNumero[i], p_nouveauNumero[j]) de poids p
+//! \throws logic_error lorsque p_nouveauNumero n'est pas une permutation des sommets
+template<typename Indice, typename Poids, template<typename> class Stockage>
+void GrapheGenerique<Indice, Poids, Stockage>::renumeroter(const std::vector<Indice> &p_nouveauNumero)
+{
+    const size_t n = m_listesAdj.size();
+    if (p_nouveauNumero.size() != n)
+        throw logic_error("Graphe::renumeroter(): il faut un nouveau numéro par sommet");
+    vector<size_t> ancienNumero(n, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (p_nouveauNumero[i] >= n || ancienNumero[p_nouveauNumero[i]] != n)
+            throw logic_error("Graphe::renumeroter(): les nouveaux numéros ne sont pas une permutation des sommets");
+        ancienNumero[p_nouveauNumero[i]] = i;
+    }
+
+    vector<typename Stockage<Arc>::Liste> listes(n);
+    for (size_t v = 0; v < n; ++v)
+        for (const auto &arc : m_listesAdj[ancienNumero[v]])
+            listes[v].emplace_back(Arc(p_nouveauNumero[arc.destination], arc.poids));
+    m_listesAdj.swap(listes);
+}
 
-unsigned int Graphe::getPoids(size_t i, size_t j) const
+//! \brief enlève les arcs dominés: l'arc (u,v) de poids p est enlevé s'il existe un autre arc (u,v) de poids plus petit
+//! \brief (ou égal, un seul étant gardé), ou un chemin u -> x -> v de longueur <= p dont les deux arcs ont un poids non nul
+//! \brief Le chemin témoin d'un arc enlevé n'utilise que des arcs plus légers que celui-ci; ces arcs sont gardés ou ont
+//! \brief eux-mêmes un témoin plus léger. Ainsi la distance entre deux sommets quelconques n'est pas modifiée.
+//! \return le nombre d'arcs enlevés
+//! \post aucun sommet n'est enlevé; l'ordre des arcs restants de chaque liste d'adjacence est conservé
+template<typename Indice, typename Poids, template<typename> class Stockage>
+size_t GrapheGenerique<Indice, Poids, Stockage>::elaguerArcsDomines()
+{
+    const size_t n = m_listesAdj.size();
+    const unsigned long long infini = numeric_limits<unsigned long long>::max();
+    vector<unsigned long long> poidsDirect(n, infini); //plus petit poids d'un arc (u,v)
+    vector<unsigned long long> poidsDeuxArcs(n, infini); //plus courte longueur d'un chemin u -> x -> v
+    vector<bool> dejaGarde(n, false); //un arc (u,v) de poids poidsDirect[v] a déjà été gardé
+    vector<Indice> successeurs;
+    vector<Indice> atteints;
+    size_t nbEnleves = 0;
+
+    for (size_t u = 0; u < n; ++u)
+    {
+        for (const auto &arc : m_listesAdj[u])
+        {
+            if (poidsDirect[arc.destination] == infini) successeurs.push_back(arc.destination);
+            poidsDirect[arc.destination] = min<unsigned long long>(poidsDirect[arc.destination], arc.poids);
+        }
+        for (Indice x : successeurs)
+        {
+            if (x == u || poidsDirect[x] == 0) continue;
+            for (const auto &arc : m_listesAdj[x])
+            {
+                if (arc.poids == 0 || arc.destination == x) continue;
+                if (poidsDeuxArcs[arc.destination] == infini) atteints.push_back(arc.destination);
+                poidsDeuxArcs[arc.destination] = min(poidsDeuxArcs[arc.destination], poidsDirect[x] + arc.poids);
+            }
+        }
+
+        auto &liste = m_listesAdj[u];
+        for (auto itr = liste.begin(); itr != liste.end();)
+        {
+            const Indice v = itr->destination;
+            const bool domine = poidsDeuxArcs[v] <= itr->poids || itr->poids > poidsDirect[v] || dejaGarde[v];
+            if (domine)
+            {
+                itr = liste.erase(itr);
+                ++nbEnleves;
+            }
+            else
+            {
+                if (itr->poids == poidsDirect[v]) dejaGarde[v] = true;
+                ++itr;
+            }
+        }
+
+        for (Indice v : successeurs)
+        {
+            poidsDirect[v] = infini;
+            dejaGarde[v] = false;
+        }
+        for (Indice v : atteints)
+            poidsDeuxArcs[v] = infini;
+        successeurs.clear();
+        atteints.clear();
+    }
+    m_nbArcs -= nbEnleves;
+    return nbEnleves;
+}
+
+template<typename Indice, typename Poids, template<typename> class Stockage>
+Poids GrapheGenerique<Indice, Poids, Stockage>::getPoids(size_t i, size_t j) const
 {
     if (i >= m_listesAdj.size()) throw logic_error("Graphe::getPoids(): l'incice i n,est pas un sommet existant");
     for (auto & arc : m_listesAdj[i])
@@ -106,14 +222,42 @@ unsigned int Graphe::getPoids(size_t i, size_t j) const
     throw logic_error("Graphe::getPoids(): l'arc(i,j) est inexistant");
 }
 
+//! \brief retourne les arcs sortant d'un sommet, dans l'ordre de sa liste d'adjacence
+//! \param[in] i: le sommet origine des arcs
+//! \return les paires (destination, poids) des arcs (i, destination)
+//! \throws logic_error lorsque le sommet i n'existe pas
+template<typename Indice, typename Poids, template<typename> class Stockage>
+std::vector<std::pair<Indice, Poids> > GrapheGenerique<Indice, Poids, Stockage>::getArcs(size_t i) const
+{
+    if (i >= m_listesAdj.size()) throw logic_error("Graphe::getArcs(): le sommet i n'existe pas");
+    std::vector<std::pair<Indice, Poids> > arcs;
+    arcs.reserve(m_listesAdj[i].size());
+    for (const auto &arc : m_listesAdj[i])
+        arcs.push_back({arc.destination, arc.poids});
+    return arcs;
+}
+
+//! \brief retourne le graphe transposé: chaque arc (i, j) devient l'arc (j, i), de même poids
+//! \brief une recherche sur le transposé depuis un sommet donne les plus courts chemins vers ce sommet dans le graphe
+template<typename Indice, typename Poids, template<typename> class Stockage>
+GrapheGenerique<Indice, Poids, Stockage> GrapheGenerique<Indice, Poids, Stockage>::transpose() const
+{
+    GrapheGenerique transpose(m_listesAdj.size());
+    for (Indice i = 0; i < m_listesAdj.size(); ++i)
+        for (const auto &arc : m_listesAdj[i])
+            transpose.m_listesAdj[arc.destination].emplace_back(Arc(i, arc.poids));
+    transpose.m_nbArcs = m_nbArcs;
+    return transpose;
+}
 
 //! \brief Version amméliorée de l'algorithme de Dijkstra permettant de trouver le plus court chemin entre p_origine et p_destination
 //! \pre p_origine et p_destination doivent être des sommets du graphe
 //! \return la longueur du plus court chemin est retournée
 //! \param[out] le chemin est retourné (un seul noeud si p_destination == p_origine ou si p_destination est inatteignable)
-//! \return la longueur du chemin (= numeric_limits<unsigned int>::max() si p_destination n'est pas atteignable)
+//! \return la longueur du chemin (= numeric_limits<Poids>::max() si p_destination n'est pas atteignable)
 //! \throws logic_error lorsque p_origine ou p_destination n'existe pas
-unsigned int Graphe::plusCourtChemin(size_t p_origine, size_t p_destination, std::vector<size_t> &p_chemin) const
+template<typename Indice, typename Poids, template<typename> class Stockage>
+Poids GrapheGenerique<Indice, Poids, Stockage>::plusCourtChemin(size_t p_origine, size_t p_destination, std::vector<Indice> &p_chemin) const
 {
     if (p_origine >= m_listesAdj.size() || p_destination >= m_listesAdj.size())
         throw logic_error("Graphe::dijkstraP(): p_origine ou p_destination n'existe pas");
@@ -125,21 +269,21 @@ unsigned int Graphe::plusCourtChemin(size_t p_origine, size_t p_destination, std
         p_chemin.push_back(p_destination);
         return 0;
     }
-    vector<unsigned int> distance(m_listesAdj.size(), numeric_limits<unsigned int>::max());
-    vector<size_t> predecesseur(m_listesAdj.size(), numeric_limits<size_t>::max());
+    vector<Poids> distance(m_listesAdj.size(), infini);
+    vector<Indice> predecesseur(m_listesAdj.size(), aucun);
     vector<bool> solutionne(m_listesAdj.size(), false);
 
     distance[p_origine] = 0;
 
-    set<size_t> q; //ensemble des noeuds non solutionnés en bordure des noeuds solutionnés;
+    set<Indice> q; //ensemble des noeuds non solutionnés en bordure des noeuds solutionnés;
     q.insert(p_origine);
 
     //Boucle principale: touver distance[] et predecesseur[]
     while (!q.empty())
     {
         //trouver le noeud dans q tel que distance[noeud] est minimal
-        unsigned int min = numeric_limits<unsigned int>::max();
-        auto noeud_solution = numeric_limits<size_t>::max();
+        Poids min = infini;
+        Indice noeud_solution = aucun;
         for(const auto & noeud : q)
         {
             if(distance[noeud] < min)
@@ -148,7 +292,7 @@ unsigned int Graphe::plusCourtChemin(size_t p_origine, size_t p_destination, std
                 noeud_solution = noeud;
             }
         }
-        if (min == numeric_limits<unsigned int>::max()) break; //quitter la boucle : il est impossible de se rendre à destination
+        if (min == infini) break; //quitter la boucle : il est impossible de se rendre à destination
 
         q.erase(noeud_solution); //enlever le noeud solutionné de q
         solutionne[noeud_solution] = true; //indique qu'il est solutionné
@@ -161,7 +305,7 @@ unsigned int Graphe::plusCourtChemin(size_t p_origine, size_t p_destination, std
             if (q.find(arc.destination) == q.end() && !solutionne[arc.destination])
                 q.insert(arc.destination); //insertion dans les noeuds à traiter
 
-            unsigned int temp = distance[noeud_solution] + arc.poids;
+            Poids temp = sommeBornee(distance[noeud_solution], arc.poids);
             if (temp < distance[arc.destination])
             {
                 distance[arc.destination] = temp;
@@ -172,24 +316,24 @@ unsigned int Graphe::plusCourtChemin(size_t p_origine, size_t p_destination, std
     }
 
     //cas où l'on n'a pas de solution
-    if (predecesseur[p_destination] == numeric_limits<unsigned int>::max())
+    if (predecesseur[p_destination] == aucun)
     {
         p_chemin.push_back(p_destination);
-        return numeric_limits<unsigned int>::max();
+        return infini;
     }
 
     //On a une solution, donc construire le plus court chemin à l'aide de predecesseur[]
-    stack<size_t> pileDuChemin;
-    size_t numero = p_destination;
+    stack<Indice> pileDuChemin;
+    Indice numero = p_destination;
     pileDuChemin.push(numero);
-    while (predecesseur[numero] != numeric_limits<size_t>::max())
+    while (predecesseur[numero] != aucun)
     {
         numero = predecesseur[numero];
         pileDuChemin.push(numero);
     }
     while (!pileDuChemin.empty())
     {
-        size_t temp = pileDuChemin.top();
+        Indice temp = pileDuChemin.top();
         p_chemin.push_back(temp);
         pileDuChemin.pop();
     }
@@ -197,3 +341,90 @@ unsigned int Graphe::plusCourtChemin(size_t p_origine, size_t p_destination, std
 }
 
 
+
+//! \brief Algorithme de Dijkstra entre le sommet origine virtuel et le sommet destination virtuel d'une requête
+//! \brief Les arcs de p_arcs sont consultés en plus de ceux du graphe, qui n'est jamais modifié; plusieurs requêtes peuvent donc s'exécuter en parallèle
+//! \param[in] p_arcs: les arcs sortant du sommet origine virtuel (getNbSommets()) et entrant au sommet destination virtuel (getNbSommets() + 1)
+//! \param[out] p_chemin: le chemin de l'origine virtuelle à la destination virtuelle (un seul noeud si la destination est inatteignable)
+//! \return la longueur du chemin (= numeric_limits<Poids>::max() si la destination n'est pas atteignable)
+//! \throws logic_error lorsqu'un arc virtuel réfère à un sommet inexistant
+template<typename Indice, typename Poids, template<typename> class Stockage>
+Poids GrapheGenerique<Indice, Poids, Stockage>::plusCourtChemin(const ArcsVirtuels &p_arcs, std::vector<Indice> &p_chemin) const
+{
+    EtatRecherche etat;
+    return plusCourtChemin(p_arcs, p_chemin, etat);
+}
+
+//! \brief Même recherche que ci-dessus, mais avec des tableaux de travail fournis par l'appelant
+//! \param[in,out] p_etat: l'état de recherche du fil d'exécution appelant; il ne doit pas être partagé entre fils d'exécution
+//! \post p_etat peut être réutilisé tel quel pour la requête suivante sur ce graphe
+template<typename Indice, typename Poids, template<typename> class Stockage>
+Poids GrapheGenerique<Indice, Poids, Stockage>::plusCourtChemin(const ArcsVirtuels &p_arcs, std::vector<Indice> &p_chemin,
+                                                    EtatRecherche &p_etat) const
+{
+    dijkstraVirtuel(*this, m_listesAdj.size(), p_arcs, infini, true, p_etat);
+    return cheminDepuisOrigine(p_etat, m_listesAdj.size() + 1, p_chemin);
+}
+
+//! \brief Recherche de un-vers-tous à partir du sommet origine virtuel, bornée par p_distanceMax
+//! \param[in] p_arcs: les arcs virtuels de la requête (les arcs vers la destination virtuelle sont optionnels)
+//! \param[in] p_distanceMax: la recherche s'arrête dès que la plus petite distance non solutionnée dépasse cette borne
+//! \param[in,out] p_etat: l'état de recherche du fil d'exécution appelant
+//! \post p_etat.distance[s] est la distance exacte de l'origine virtuelle à s si elle est <= p_distanceMax;
+//! \post une valeur > p_distanceMax signifie que s n'est pas atteignable à l'intérieur de la borne
+//! \post p_etat.predecesseur[] donne l'arbre des plus courts chemins des sommets solutionnés
+template<typename Indice, typename Poids, template<typename> class Stockage>
+void GrapheGenerique<Indice, Poids, Stockage>::distancesDepuisOrigine(const ArcsVirtuels &p_arcs, Poids p_distanceMax,
+                                                                 EtatRecherche &p_etat) const
+{
+    dijkstraVirtuel(*this, m_listesAdj.size(), p_arcs, p_distanceMax, false, p_etat);
+}
+
+//! \brief Plus court chemin lorsqu'entrer dans le sommet s coûte p_penaliteDeSommet[s] de plus que le poids de l'arc
+//! \brief Sert à la recherche d'itinéraires alternatifs par pénalités: le graphe n'est pas modifié et l'état de
+//! \brief recherche est réutilisé d'une recherche à l'autre
+//! \param[in] p_arcs: les arcs virtuels de la requête
+//! \param[in] p_penaliteDeSommet: une pénalité par sommet du graphe (les sommets virtuels n'en ont pas)
+//! \param[in] p_coutMax: la recherche abandonne dès que le coût pénalisé de la destination dépasserait cette borne
+//! \param[out] p_chemin: le chemin de coût pénalisé minimal (un seul noeud si aucun chemin ne respecte la borne)
+//! \param[in,out] p_etat: l'état de recherche du fil d'exécution appelant
+//! \return la longueur réelle (sans les pénalités) du chemin trouvé (= numeric_limits<Poids>::max() si aucun)
+//! \throws logic_error si p_penaliteDeSommet n'a pas une entrée par sommet
+template<typename Indice, typename Poids, template<typename> class Stockage>
+Poids GrapheGenerique<Indice, Poids, Stockage>::plusCourtCheminPenalise(const ArcsVirtuels &p_arcs, const std::vector<Poids> &p_penaliteDeSommet,
+                                                           Poids p_coutMax, std::vector<Indice> &p_chemin,
+                                                           EtatRecherche &p_etat) const
+{
+    const Indice destination = m_listesAdj.size() + 1;
+    if (p_penaliteDeSommet.size() != m_listesAdj.size())
+        throw logic_error("Graphe::plusCourtCheminPenalise(): il faut une pénalité par sommet");
+
+    p_chemin.clear();
+    dijkstraVirtuel(*this, m_listesAdj.size(), p_arcs, p_coutMax, true, p_etat, &p_penaliteDeSommet);
+
+    if (p_etat.distance[destination] > p_coutMax)
+    {
+        p_chemin.push_back(destination);
+        return infini;
+    }
+
+    Poids penalites = 0;
+    for (Indice numero = destination; numero != aucun; numero = p_etat.predecesseur[numero])
+    {
+        p_chemin.push_back(numero);
+        if (numero < m_listesAdj.size()) penalites = sommeBornee(penalites, p_penaliteDeSommet[numero]);
+    }
+    reverse(p_chemin.begin(), p_chemin.end());
+    return p_etat.distance[destination] - penalites;
+}
+
+template<typename Indice, typename Poids, template<typename> class Stockage>
+const Poids GrapheGenerique<Indice, Poids, Stockage>::infini;
+template<typename Indice, typename Poids, template<typename> class Stockage>
+const Indice GrapheGenerique<Indice, Poids, Stockage>::aucun;
+
+//les combinaisons offertes par graphe.h; en ajouter une ici pour l'utiliser ailleurs
+template class GrapheGenerique<size_t, unsigned int, StockageListes>;
+template class GrapheGenerique<uint32_t, unsigned int, StockageVecteurs>;
+template class GrapheGenerique<uint32_t, uint16_t, StockageVecteurs>;
+template class GrapheGenerique<uint32_t, uint64_t, StockageVecteurs>;
@@ -16,38 +16,308 @@
 #include <limits>
 #include <iostream>
 #include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+//! \brief  Stockage des arcs sortant d'un sommet dans une std::list (une allocation par arc)
+template<typename Arc>
+struct StockageListes
+{
+    typedef std::list<Arc> Liste;
+
+    //! \brief chaque arc est un noeud de std::list: l'arc lui-même et deux pointeurs
+    static size_t tailleMemoire(const Liste & p_liste)
+    {
+        return p_liste.size() * (sizeof(Arc) + 2 * sizeof(void *));
+    }
+};
+
+//! \brief  Stockage des arcs sortant d'un sommet dans un std::vector (arcs contigus en mémoire)
+template<typename Arc>
+struct StockageVecteurs
+{
+    typedef std::vector<Arc> Liste;
+
+    static size_t tailleMemoire(const Liste & p_liste)
+    {
+        return p_liste.capacity() * sizeof(Arc);
+    }
+};
+
+//! \brief retourne p_a + p_b, ou numeric_limits<Poids>::max() si la somme n'est pas représentable
+//! \brief une distance infinie reste ainsi infinie, même avec des poids sur 16 bits
+template<typename Poids>
+inline Poids sommeBornee(Poids p_a, Poids p_b)
+{
+    return p_a > std::numeric_limits<Poids>::max() - p_b ? std::numeric_limits<Poids>::max() : static_cast<Poids>(p_a + p_b);
+}
+
+//! \brief relâche l'arc (p_u, p_v) de poids p_poids, pour toutes les recherches de Dijkstra et A* sur une liste de sommets
+//! \brief (Graphe, GrapheCompact, ReperesALT): la distance de p_u plus p_poids est bornée par sommeBornee()
+//! \param[in,out] p_etat: un état de recherche ayant distance[], predecesseur[] et sommetsModifies, comme
+//! \param[in,out] GrapheGenerique::EtatRecherche
+//! \return true si distance[p_v] a diminué; l'appelant ajoute alors p_v à sa file de priorité
+template<typename Etat, typename Poids>
+inline bool relacherArc(Etat & p_etat, size_t p_u, size_t p_v, Poids p_poids)
+{
+    const Poids temp = sommeBornee(p_etat.distance[p_u], p_poids);
+    if (!(temp < p_etat.distance[p_v])) return false;
+    if (p_etat.distance[p_v] == std::numeric_limits<Poids>::max()) p_etat.sommetsModifies.push_back(p_v);
+    p_etat.distance[p_v] = temp;
+    p_etat.predecesseur[p_v] = p_u;
+    return true;
+}
+
+//! \brief Algorithme de Dijkstra (avec monceau binaire) à partir du sommet origine virtuel d'une requête, commun aux
+//! \brief représentations d'un graphe: p_graphe.pourChaqueArc(u, f) appelle f(v, poids) pour chaque arc (u, v) du
+//! \brief graphe (GrapheGenerique, GrapheCompact et ReseauProjete le font, chacun pour son rangement des arcs)
+//! \param[in] p_nbSommets: le nombre de sommets du graphe; l'origine virtuelle est p_nbSommets et la destination
+//! \param[in] virtuelle p_nbSommets + 1
+//! \param[in] p_arcs: les arcs virtuels de la requête (voir GrapheGenerique::ArcsVirtuels)
+//! \param[in] p_distanceMax: aucun sommet plus loin que cette distance n'est solutionné
+//! \param[in] p_arreterADestination: true pour s'arrêter dès que la destination virtuelle est solutionnée
+//! \param[in,out] p_etat: l'état de recherche, comme GrapheGenerique::EtatRecherche; seules les entrées modifiées par
+//! \param[in,out] la requête précédente sont réinitialisées
+//! \param[in] p_penaliteDeSommet: si non nul, coût ajouté à chaque arc entrant dans un sommet du graphe
+//! \throws logic_error lorsqu'un arc virtuel réfère à un sommet inexistant
+template<typename Representation, typename ArcsVirtuels, typename Poids, typename Etat>
+void dijkstraVirtuel(const Representation & p_graphe, size_t p_nbSommets, const ArcsVirtuels & p_arcs,
+                     Poids p_distanceMax, bool p_arreterADestination, Etat & p_etat,
+                     const std::vector<Poids> * p_penaliteDeSommet = nullptr)
+{
+    typedef typename std::decay<decltype(p_etat.predecesseur[0])>::type Indice;
+    const Poids infini = std::numeric_limits<Poids>::max();
+    const Indice aucun = std::numeric_limits<Indice>::max();
+    const size_t origine = p_nbSommets;
+    const size_t destination = p_nbSommets + 1;
+
+    //remettre à zéro uniquement ce que la requête précédente a touché
+    if (p_etat.distance.size() != p_nbSommets + 2)
+    {
+        p_etat.distance.assign(p_nbSommets + 2, infini);
+        p_etat.predecesseur.assign(p_nbSommets + 2, aucun);
+        p_etat.poidsVersDestination.assign(p_nbSommets, infini);
+    }
+    else
+    {
+        for (size_t s : p_etat.sommetsModifies)
+        {
+            p_etat.distance[s] = infini;
+            p_etat.predecesseur[s] = aucun;
+        }
+        for (size_t s : p_etat.sommetsVersDestination)
+            p_etat.poidsVersDestination[s] = infini;
+    }
+    p_etat.sommetsModifies.clear();
+    p_etat.sommetsVersDestination.clear();
+    p_etat.nbSommetsSolutionnes = 0;
+
+    std::vector<Poids> & distance = p_etat.distance;
+    std::vector<Poids> & poidsVersDestination = p_etat.poidsVersDestination;
+
+    for (const auto & arc : p_arcs.versDestination)
+    {
+        if (arc.first >= p_nbSommets)
+            throw std::logic_error("Graphe::plusCourtChemin(): un arc vers la destination part d'un sommet inexistant");
+        if (poidsVersDestination[arc.first] == infini)
+            p_etat.sommetsVersDestination.push_back(arc.first);
+        poidsVersDestination[arc.first] = std::min(poidsVersDestination[arc.first], arc.second);
+    }
+
+    typedef std::pair<Poids, Indice> Entree; //(distance, sommet)
+    std::priority_queue<Entree, std::vector<Entree>, std::greater<Entree> > q;
+
+    distance[origine] = 0;
+    p_etat.sommetsModifies.push_back(origine);
+    q.push(Entree(0, origine));
+
+    //relâche l'arc (u, v) de poids p, pénalité de v comprise (voir relacherArc())
+    auto relacher = [&](size_t u, size_t v, Poids p)
+    {
+        if (p_penaliteDeSommet && v < p_nbSommets) p = sommeBornee(p, (*p_penaliteDeSommet)[v]);
+        if (relacherArc(p_etat, u, v, p)) q.push(Entree(distance[v], v));
+    };
+
+    while (!q.empty())
+    {
+        Entree e = q.top();
+        q.pop();
+        size_t u = e.second;
+        if (e.first > distance[u]) continue; //entrée périmée: u a déjà été solutionné
+        if (e.first > p_distanceMax) break; //tous les sommets restants sont au-delà de la borne
+        ++p_etat.nbSommetsSolutionnes;
+        if (u == destination)
+        {
+            if (p_arreterADestination) break;
+            continue;
+        }
+
+        if (u == origine)
+        {
+            for (const auto & arc : p_arcs.depuisOrigine)
+            {
+                if (arc.first >= p_nbSommets)
+                    throw std::logic_error("Graphe::plusCourtChemin(): un arc de l'origine mène à un sommet inexistant");
+                relacher(u, arc.first, arc.second);
+            }
+            continue;
+        }
+
+        p_graphe.pourChaqueArc(u, [&](size_t v, Poids p) { relacher(u, v, p); });
+        if (poidsVersDestination[u] != infini)
+            relacher(u, destination, poidsVersDestination[u]);
+    }
+}
+
+//! \brief reconstruit, avec p_etat.predecesseur[], le chemin de l'origine virtuelle à p_destination
+//! \param[out] p_chemin: le chemin (un seul noeud, p_destination, si p_destination n'a pas été atteinte)
+//! \return p_etat.distance[p_destination] (= numeric_limits<Poids>::max() si p_destination n'a pas été atteinte)
+template<typename Etat, typename Indice>
+typename std::decay<decltype(std::declval<Etat>().distance[0])>::type
+cheminDepuisOrigine(const Etat & p_etat, size_t p_destination, std::vector<Indice> & p_chemin)
+{
+    typedef typename std::decay<decltype(p_etat.distance[0])>::type Poids;
+    typedef typename std::decay<decltype(p_etat.predecesseur[0])>::type Predecesseur;
+    p_chemin.clear();
+    if (p_etat.distance[p_destination] == std::numeric_limits<Poids>::max())
+    {
+        p_chemin.push_back(p_destination);
+        return std::numeric_limits<Poids>::max();
+    }
+    for (size_t numero = p_destination; numero != std::numeric_limits<Predecesseur>::max(); numero = p_etat.predecesseur[numero])
+        p_chemin.push_back(numero);
+    std::reverse(p_chemin.begin(), p_chemin.end());
+    return p_etat.distance[p_destination];
+}
 
 //! \brief  Classe pour graphes orientés pondérés (non négativement) avec listes d'adjacence
-class Graphe
+//! \brief  Indice est le type des numéros de sommets, Poids celui des poids et des longueurs de chemins, et Stockage
+//! \brief  celui des listes d'adjacence (StockageListes ou StockageVecteurs). Les boucles de recherche sont ainsi compilées
+//! \brief  pour chaque combinaison; numeric_limits<Poids>::max() est la longueur d'un chemin inexistant et
+//! \brief  numeric_limits<Indice>::max() l'absence de prédécesseur.
+//! \brief  Les définitions sont dans graphe.cpp, où les combinaisons offertes ci-dessous sont instanciées explicitement.
+//! \brief  Les sommets reçus en paramètre sont des size_t pour toutes les combinaisons, comme la taille du graphe, et
+//! \brief  les poids reçus par ajouterArc() des unsigned long long: chaque méthode vérifie qu'ils sont représentables.
+template<typename Indice, typename Poids, template<typename> class Stockage>
+class GrapheGenerique
 {
 public:
 
-	explicit Graphe(size_t = 0);
+	explicit GrapheGenerique(size_t = 0);
     void resize(size_t);
-	void ajouterArc(size_t i, size_t j, unsigned int poids);
+	void ajouterArc(size_t i, size_t j, unsigned long long poids);
 	void enleverArc(size_t i, size_t j);
-	unsigned int getPoids(size_t i, size_t j) const;
+    void renumeroter(const std::vector<Indice> & p_nouveauNumero);
+    size_t elaguerArcsDomines();
+	Poids getPoids(size_t i, size_t j) const;
+    std::vector<std::pair<Indice, Poids> > getArcs(size_t i) const;
+    GrapheGenerique transpose() const;
 	size_t getNbSommets() const;
     size_t getNbArcs() const;
+    size_t getTailleMemoire() const;
+
+    Poids plusCourtChemin(size_t p_origine, size_t p_destination,
+                          std::vector<Indice> & p_chemin) const;
 
-    unsigned int plusCourtChemin(size_t p_origine, size_t p_destination,
-                             std::vector<size_t> & p_chemin) const;
+    //! \brief arcs propres à une requête, consultés par la recherche sans modifier le graphe
+    //! \brief le sommet origine virtuel est getNbSommets() et le sommet destination virtuel est getNbSommets() + 1
+    //! \brief le constructeur de conversion copie les arcs virtuels d'un graphe d'autres types (par exemple ceux d'une
+    //! \brief ReseauGTFS::Requete): un poids trop grand pour Poids devient numeric_limits<Poids>::max(), comme une longueur
+    //! \brief trop grande, et l'arc n'est jamais emprunté; un sommet non représentable par Indice lève logic_error
+    struct ArcsVirtuels
+    {
+        ArcsVirtuels()
+        {
+        }
+
+        template<typename AutresArcsVirtuels>
+        explicit ArcsVirtuels(const AutresArcsVirtuels & p_arcs)
+        {
+            convertir(p_arcs.depuisOrigine, depuisOrigine);
+            convertir(p_arcs.versDestination, versDestination);
+        }
+
+        std::vector<std::pair<Indice, Poids> > depuisOrigine; //(j, poids) pour chaque arc (origine, j)
+        std::vector<std::pair<Indice, Poids> > versDestination; //(i, poids) pour chaque arc (i, destination)
+
+    private:
+        template<typename AutresArcs>
+        static void convertir(const AutresArcs & p_source, std::vector<std::pair<Indice, Poids> > & p_destination)
+        {
+            p_destination.reserve(p_source.size());
+            for (const auto &arc : p_source)
+            {
+                if (arc.first >= static_cast<unsigned long long>(std::numeric_limits<Indice>::max()) - 1)
+                    throw std::logic_error("Graphe::ArcsVirtuels: sommet non représentable par le type des indices");
+                const unsigned long long poids = arc.second;
+                const Poids poidsMax = std::numeric_limits<Poids>::max();
+                p_destination.push_back({static_cast<Indice>(arc.first), poids < poidsMax ? static_cast<Poids>(poids) : poidsMax});
+            }
+        }
+    };
+
+    //! \brief tableaux de travail de la recherche, réutilisables d'une requête à l'autre par un même fil d'exécution
+    //! \brief seules les entrées modifiées par la requête précédente sont réinitialisées
+    struct EtatRecherche
+    {
+        std::vector<Poids> distance;
+        std::vector<Indice> predecesseur;
+        std::vector<Poids> poidsVersDestination;
+        std::vector<Indice> sommetsModifies; //sommets dont distance[] ou predecesseur[] a été modifié
+        std::vector<Indice> sommetsVersDestination; //sommets dont poidsVersDestination[] a été modifié
+        size_t nbSommetsSolutionnes; //par la dernière recherche
+    };
+
+    Poids plusCourtChemin(const ArcsVirtuels & p_arcs, std::vector<Indice> & p_chemin) const;
+    Poids plusCourtChemin(const ArcsVirtuels & p_arcs, std::vector<Indice> & p_chemin,
+                          EtatRecherche & p_etat) const;
+    void distancesDepuisOrigine(const ArcsVirtuels & p_arcs, Poids p_distanceMax,
+                                EtatRecherche & p_etat) const;
+    Poids plusCourtCheminPenalise(const ArcsVirtuels & p_arcs, const std::vector<Poids> & p_penaliteDeSommet,
+                                  Poids p_coutMax, std::vector<Indice> & p_chemin,
+                                  EtatRecherche & p_etat) const;
+
+    //! \brief appelle p_visiteur(destination, poids) pour chaque arc sortant de p_sommet (voir dijkstraVirtuel())
+    template<typename Visiteur>
+    void pourChaqueArc(size_t p_sommet, Visiteur p_visiteur) const
+    {
+        for (const auto & arc : m_listesAdj[p_sommet])
+            p_visiteur(arc.destination, arc.poids);
+    }
 
 private:
+    friend class HierarchieContraction; //lit les listes d'adjacence une seule fois, à la construction
+    friend class GrapheCompact; //idem
+    friend class ReperesALT; //idem, et parcourt les listes d'adjacence lors des recherches A*
+
+    static const Poids infini = std::numeric_limits<Poids>::max();
+    static const Indice aucun = std::numeric_limits<Indice>::max();
 
 	struct Arc
 	{
-		Arc(size_t dest, unsigned int p) :
+		Arc(Indice dest, Poids p) :
 				destination(dest), poids(p)
 		{
 		}
-		size_t destination;
-		unsigned int poids;
+		Indice destination;
+		Poids poids;
 	};
 
-	std::vector<std::list<Arc> > m_listesAdj; /*!< les listes d'adjacence */
+	std::vector<typename Stockage<Arc>::Liste> m_listesAdj; /*!< les listes d'adjacence */
     unsigned long m_nbArcs;
 
 };
 
+//! \brief le graphe de toujours: indices size_t, poids unsigned int, listes chaînées
+typedef GrapheGenerique<size_t, unsigned int, StockageListes> Graphe;
+//! \brief indices sur 32 bits et arcs contigus: 8 octets par arc, sans pointeurs
+typedef GrapheGenerique<uint32_t, unsigned int, StockageVecteurs> GrapheIndices32;
+//! \brief idem, avec des poids sur 16 bits (longueurs d'au plus 65534, soit 18 h en secondes): tableaux de distances
+//! \brief deux fois plus petits; une longueur plus grande est vue comme infinie, et ajouterArc() refuse un poids plus grand
+typedef GrapheGenerique<uint32_t, uint16_t, StockageVecteurs> GrapheIndices32Poids16;
+//! \brief indices sur 32 bits et poids sur 64 bits, pour des poids qui dépassent unsigned int (par exemple des
+//! \brief coûts pondérés en millisecondes ou une somme de plusieurs critères): 16 octets par arc, alignement compris
+typedef GrapheGenerique<uint32_t, uint64_t, StockageVecteurs> GrapheIndices32Poids64;
+
 #endif  //GRAPH_H
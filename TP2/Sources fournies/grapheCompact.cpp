@@ -0,0 +1,182 @@
+//
+//  grapheCompact.cpp
+//  Représentation compacte (en lecture seule) d'un Graphe, pour les recherches
+//
+
+#include "grapheCompact.h"
+
+using namespace std;
+
+const uint16_t GrapheCompact::poidsDeborde;
+
+//! \brief ajoute un entier non signé en format LEB128: 7 bits par octet, le bit de poids fort indiquant une suite
+static void ecrireVarint(vector<uint8_t> &p_octets, uint32_t p_valeur)
+{
+    while (p_valeur >= 0x80)
+    {
+        p_octets.push_back(static_cast<uint8_t>(p_valeur | 0x80));
+        p_valeur >>= 7;
+    }
+    p_octets.push_back(static_cast<uint8_t>(p_valeur));
+}
+
+//! \brief lit un entier LEB128 et avance p_position après celui-ci
+static uint32_t lireVarint(const uint8_t *&p_position)
+{
+    uint32_t valeur = 0;
+    for (unsigned int decalage = 0; ; decalage += 7)
+    {
+        const uint8_t octet = *p_position++;
+        valeur |= static_cast<uint32_t>(octet & 0x7F) << decalage;
+        if (!(octet & 0x80)) return valeur;
+    }
+}
+
+//! \brief Construit la représentation compacte d'un graphe
+//! \param[in] p_graphe: le graphe; il n'est pas modifié
+//! \param[in] p_encodage: l'encodage des arcs
+//! \post avec Entiers32 et Poids16, les arcs de chaque sommet sont dans l'ordre de sa liste d'adjacence; avec Delta,
+//! \post ils sont triés par destination
+//! \throws logic_error si le graphe a trop de sommets ou d'arcs pour des indices de 32 bits
+GrapheCompact::GrapheCompact(const Graphe &p_graphe, Encodage p_encodage)
+        : m_encodage(p_encodage), m_nbSommets(p_graphe.getNbSommets()), m_nbArcs(p_graphe.getNbArcs())
+{
+    if (m_nbSommets >= numeric_limits<uint32_t>::max() || m_nbArcs >= numeric_limits<uint32_t>::max())
+        throw logic_error("GrapheCompact::GrapheCompact(): le graphe est trop grand pour des indices de 32 bits");
+
+    m_debut.reserve(m_nbSommets + 1);
+    m_debut.push_back(0);
+    for (size_t u = 0; u < m_nbSommets; ++u)
+    {
+        const auto &liste = p_graphe.m_listesAdj[u];
+        if (m_encodage == Encodage::Entiers32)
+        {
+            for (const auto &arc : liste)
+                m_arcs32.push_back({static_cast<uint32_t>(arc.destination), arc.poids});
+            m_debut.push_back(static_cast<uint32_t>(m_arcs32.size()));
+        }
+        else if (m_encodage == Encodage::Poids16)
+        {
+            for (const auto &arc : liste)
+            {
+                if (arc.poids >= poidsDeborde)
+                    m_debordements.push_back({static_cast<uint32_t>(m_destinations.size()), arc.poids});
+                m_destinations.push_back(static_cast<uint32_t>(arc.destination));
+                m_poids16.push_back(static_cast<uint16_t>(min<unsigned int>(arc.poids, poidsDeborde)));
+            }
+            m_debut.push_back(static_cast<uint32_t>(m_destinations.size()));
+        }
+        else
+        {
+            vector<pair<uint32_t, uint32_t> > arcs;
+            for (const auto &arc : liste)
+                arcs.push_back({static_cast<uint32_t>(arc.destination), arc.poids});
+            sort(arcs.begin(), arcs.end());
+            //écart en zigzag: la première destination peut précéder la source
+            int64_t precedente = static_cast<int64_t>(u);
+            for (const auto &arc : arcs)
+            {
+                const int64_t ecart = static_cast<int64_t>(arc.first) - precedente;
+                ecrireVarint(m_octets, static_cast<uint32_t>(ecart >= 0 ? 2 * ecart : -2 * ecart - 1));
+                ecrireVarint(m_octets, arc.second);
+                precedente = arc.first;
+            }
+            if (m_octets.size() >= numeric_limits<uint32_t>::max())
+                throw logic_error("GrapheCompact::GrapheCompact(): trop d'octets pour des positions de 32 bits");
+            m_debut.push_back(static_cast<uint32_t>(m_octets.size()));
+        }
+    }
+    m_arcs32.shrink_to_fit();
+    m_destinations.shrink_to_fit();
+    m_poids16.shrink_to_fit();
+    m_octets.shrink_to_fit();
+}
+
+//! \brief retourne le poids d'un arc dont le poids ne tient pas sur 16 bits (encodage Poids16)
+uint32_t GrapheCompact::poidsDebordant(uint32_t p_arc) const
+{
+    auto it = lower_bound(m_debordements.begin(), m_debordements.end(), make_pair(p_arc, 0u));
+    if (it == m_debordements.end() || it->first != p_arc)
+        throw logic_error("GrapheCompact::poidsDebordant(): poids absent de la table de débordement");
+    return it->second;
+}
+
+//! \brief appelle p_visiteur(destination, poids) pour chaque arc sortant de p_sommet (voir dijkstraVirtuel())
+template<typename Visiteur>
+void GrapheCompact::pourChaqueArc(uint32_t p_sommet, Visiteur p_visiteur) const
+{
+    const uint32_t debut = m_debut[p_sommet];
+    const uint32_t fin = m_debut[p_sommet + 1];
+    switch (m_encodage)
+    {
+        case Encodage::Entiers32:
+            for (uint32_t k = debut; k < fin; ++k)
+                p_visiteur(m_arcs32[k].destination, m_arcs32[k].poids);
+            break;
+        case Encodage::Poids16:
+            for (uint32_t k = debut; k < fin; ++k)
+                p_visiteur(m_destinations[k], m_poids16[k] != poidsDeborde ? m_poids16[k] : poidsDebordant(k));
+            break;
+        case Encodage::Delta:
+        {
+            const uint8_t *position = m_octets.data() + debut;
+            const uint8_t *finOctets = m_octets.data() + fin;
+            int64_t destination = p_sommet;
+            while (position < finOctets)
+            {
+                const uint32_t zigzag = lireVarint(position);
+                destination += (zigzag & 1) ? -static_cast<int64_t>(zigzag >> 1) - 1 : static_cast<int64_t>(zigzag >> 1);
+                const uint32_t poids = lireVarint(position);
+                p_visiteur(static_cast<uint32_t>(destination), poids);
+            }
+            break;
+        }
+    }
+}
+
+//! \brief reconstruit un Graphe (listes d'adjacence) ayant les mêmes arcs
+//! \post les arcs de chaque liste d'adjacence sont dans l'ordre de la représentation compacte
+Graphe GrapheCompact::versGraphe() const
+{
+    Graphe graphe(m_nbSommets);
+    for (uint32_t u = 0; u < m_nbSommets; ++u)
+        pourChaqueArc(u, [&](uint32_t v, uint32_t p) { graphe.ajouterArc(u, v, p); });
+    return graphe;
+}
+
+GrapheCompact::Encodage GrapheCompact::getEncodage() const
+{
+    return m_encodage;
+}
+
+size_t GrapheCompact::getNbSommets() const
+{
+    return m_nbSommets;
+}
+
+size_t GrapheCompact::getNbArcs() const
+{
+    return m_nbArcs;
+}
+
+//! \brief retourne le nombre d'octets occupés par les arcs et les débuts de blocs
+size_t GrapheCompact::getTailleMemoire() const
+{
+    return m_debut.capacity() * sizeof(uint32_t) + m_arcs32.capacity() * sizeof(Arc32)
+           + m_destinations.capacity() * sizeof(uint32_t) + m_poids16.capacity() * sizeof(uint16_t)
+           + m_debordements.capacity() * sizeof(pair<uint32_t, uint32_t>) + m_octets.capacity();
+}
+
+//! \brief Algorithme de Dijkstra entre le sommet origine virtuel et le sommet destination virtuel d'une requête
+//! \brief Même recherche que Graphe::plusCourtChemin(), avec le même état de recherche, sur les arcs compacts
+//! \param[in] p_arcs: les arcs sortant du sommet origine virtuel (getNbSommets()) et entrant au sommet destination virtuel (getNbSommets() + 1)
+//! \param[out] p_chemin: le chemin de l'origine virtuelle à la destination virtuelle (un seul noeud si la destination est inatteignable)
+//! \param[in,out] p_etat: l'état de recherche du fil d'exécution appelant; il ne doit pas être partagé entre fils d'exécution
+//! \return la longueur du chemin (= numeric_limits<unsigned int>::max() si la destination n'est pas atteignable)
+//! \throws logic_error lorsqu'un arc virtuel réfère à un sommet inexistant
+unsigned int GrapheCompact::plusCourtChemin(const Graphe::ArcsVirtuels &p_arcs, std::vector<size_t> &p_chemin,
+                                            Graphe::EtatRecherche &p_etat) const
+{
+    dijkstraVirtuel(*this, m_nbSommets, p_arcs, numeric_limits<unsigned int>::max(), true, p_etat);
+    return cheminDepuisOrigine(p_etat, m_nbSommets + 1, p_chemin);
+}
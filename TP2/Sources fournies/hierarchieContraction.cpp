@@ -0,0 +1,410 @@
+//
+//  hierarchieContraction.cpp
+//  Hiérarchie de contraction d'un graphe orienté pondéré (non négativement) qui ne change plus
+//
+
+#include "hierarchieContraction.h"
+#include <tuple>
+
+using namespace std;
+
+const uint32_t HierarchieContraction::aucun;
+
+//! \brief Construit la hiérarchie: ordre de contraction, raccourcis, puis graphes montant et descendant
+//! \brief L'ordre est choisi paresseusement: on contracte le sommet de plus faible priorité, où la priorité est le
+//! \brief nombre de raccourcis requis, moins le nombre d'arcs enlevés, plus le nombre de voisins déjà contractés
+//! \param[in] p_graphe: le graphe; il n'est pas modifié et peut être détruit une fois la hiérarchie construite
+//! \param[in] p_heures: vide, ou une heure par sommet telle que le poids de chaque arc (u, v) est au moins
+//! \param[in] p_heures[v] - p_heures[u] (c'est le cas d'un graphe espace-temps, où il y est égal)
+//! \param[in] p_maxVisitesTemoin: nombre maximal de sommets visités par une recherche de chemin témoin; une recherche
+//! \param[in] interrompue ajoute le raccourci, ce qui ne fausse jamais les distances
+//! \throws logic_error si le graphe a trop de sommets pour des indices de 32 bits
+//! \throws logic_error si p_heures n'a pas un élément par sommet ou si un arc viole la condition ci-dessus
+HierarchieContraction::HierarchieContraction(const Graphe &p_graphe, const vector<unsigned int> &p_heures,
+                                             unsigned int p_maxVisitesTemoin)
+        : m_nbSommets(p_graphe.getNbSommets()), m_nbRaccourcis(0), m_heures(p_heures)
+{
+    if (m_nbSommets >= aucun)
+        throw logic_error("HierarchieContraction::HierarchieContraction(): le graphe a trop de sommets");
+    if (!m_heures.empty() && m_heures.size() != m_nbSommets)
+        throw logic_error("HierarchieContraction::HierarchieContraction(): il faut une heure par sommet");
+    const uint32_t n = static_cast<uint32_t>(m_nbSommets);
+    const unsigned int infini = numeric_limits<unsigned int>::max();
+    for (uint32_t u = 0; u < n && !m_heures.empty(); ++u)
+        for (const auto &arc : p_graphe.m_listesAdj[u])
+            if (static_cast<long>(arc.poids) < static_cast<long>(m_heures[arc.destination]) - static_cast<long>(m_heures[u]))
+                throw logic_error("HierarchieContraction::HierarchieContraction(): un arc est plus court que l'écart de ses heures");
+
+    //graphe restant: un seul arc (le plus léger) par paire de sommets, aucune boucle
+    vector<vector<Arc> > sortants(n);
+    vector<vector<Arc> > entrants(n);
+    auto ajouter = [&](uint32_t u, uint32_t v, unsigned int p, uint32_t milieu)
+    {
+        for (auto &a : sortants[u])
+        {
+            if (a.voisin != v) continue;
+            if (a.poids <= p) return;
+            a.poids = p;
+            a.milieu = milieu;
+            for (auto &b : entrants[v])
+                if (b.voisin == u)
+                {
+                    b.poids = p;
+                    b.milieu = milieu;
+                    break;
+                }
+            return;
+        }
+        sortants[u].push_back({v, p, milieu});
+        entrants[v].push_back({u, p, milieu});
+    };
+    for (uint32_t u = 0; u < n; ++u)
+        for (const auto &arc : p_graphe.m_listesAdj[u])
+            if (arc.destination != u) ajouter(u, static_cast<uint32_t>(arc.destination), arc.poids, aucun);
+
+    //recherche locale d'un chemin témoin partant de p_source et évitant p_exclu, bornée par p_borne
+    vector<unsigned int> distanceTemoin(n, infini);
+    vector<uint32_t> sommetsTemoin;
+    typedef pair<unsigned int, uint32_t> Entree;
+    auto rechercherTemoins = [&](uint32_t p_source, uint32_t p_exclu, unsigned int p_borne)
+    {
+        for (uint32_t s : sommetsTemoin) distanceTemoin[s] = infini;
+        sommetsTemoin.clear();
+        priority_queue<Entree, vector<Entree>, greater<Entree> > file;
+        distanceTemoin[p_source] = 0;
+        sommetsTemoin.push_back(p_source);
+        file.push(Entree(0, p_source));
+        unsigned int nbVisites = 0;
+        while (!file.empty())
+        {
+            Entree e = file.top();
+            file.pop();
+            if (e.first > distanceTemoin[e.second]) continue;
+            if (e.first > p_borne || ++nbVisites > p_maxVisitesTemoin) break;
+            for (const auto &a : sortants[e.second])
+            {
+                if (a.voisin == p_exclu) continue;
+                unsigned int d = e.first + a.poids;
+                if (d <= p_borne && d < distanceTemoin[a.voisin])
+                {
+                    if (distanceTemoin[a.voisin] == infini) sommetsTemoin.push_back(a.voisin);
+                    distanceTemoin[a.voisin] = d;
+                    file.push(Entree(d, a.voisin));
+                }
+            }
+        }
+    };
+
+    //compte (ou ajoute) les raccourcis requis par la contraction de p_sommet
+    auto raccourcis = [&](uint32_t p_sommet, bool p_ajouter)
+    {
+        int nb = 0;
+        unsigned int maxSortant = 0;
+        for (const auto &s : sortants[p_sommet]) maxSortant = max(maxSortant, s.poids);
+        for (size_t i = 0; i < entrants[p_sommet].size(); ++i)
+        {
+            const Arc e = entrants[p_sommet][i];
+            rechercherTemoins(e.voisin, p_sommet, e.poids + maxSortant);
+            for (size_t j = 0; j < sortants[p_sommet].size(); ++j)
+            {
+                const Arc s = sortants[p_sommet][j];
+                if (s.voisin == e.voisin || distanceTemoin[s.voisin] <= e.poids + s.poids) continue;
+                ++nb;
+                if (p_ajouter) ajouter(e.voisin, s.voisin, e.poids + s.poids, p_sommet);
+            }
+        }
+        return nb;
+    };
+
+    vector<unsigned int> voisinsContractes(n, 0);
+    auto priorite = [&](uint32_t p_sommet)
+    {
+        return raccourcis(p_sommet, false) - static_cast<int>(entrants[p_sommet].size() + sortants[p_sommet].size())
+               + static_cast<int>(voisinsContractes[p_sommet]);
+    };
+
+    typedef pair<int, uint32_t> Candidat;
+    priority_queue<Candidat, vector<Candidat>, greater<Candidat> > candidats;
+    for (uint32_t v = 0; v < n; ++v)
+        candidats.push(Candidat(priorite(v), v));
+
+    vector<vector<Arc> > montants(n);
+    vector<vector<Arc> > descendants(n);
+    while (!candidats.empty())
+    {
+        uint32_t v = candidats.top().second;
+        candidats.pop();
+        int p = priorite(v); //la priorité a pu changer depuis l'insertion
+        if (!candidats.empty() && p > candidats.top().first)
+        {
+            candidats.push(Candidat(p, v));
+            continue;
+        }
+
+        raccourcis(v, true);
+        //les arcs restants de v relient v à des sommets contractés plus tard: ce sont ses arcs de la hiérarchie
+        for (const auto &a : sortants[v])
+        {
+            auto &liste = entrants[a.voisin];
+            liste.erase(find_if(liste.begin(), liste.end(), [v](const Arc &b) { return b.voisin == v; }));
+            ++voisinsContractes[a.voisin];
+        }
+        for (const auto &a : entrants[v])
+        {
+            auto &liste = sortants[a.voisin];
+            liste.erase(find_if(liste.begin(), liste.end(), [v](const Arc &b) { return b.voisin == v; }));
+            ++voisinsContractes[a.voisin];
+        }
+        montants[v].swap(sortants[v]);
+        descendants[v].swap(entrants[v]);
+    }
+
+    //rangement contigu (format CSR)
+    m_debutMontants.assign(n + 1, 0);
+    m_debutDescendants.assign(n + 1, 0);
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        m_debutMontants[v + 1] = m_debutMontants[v] + static_cast<uint32_t>(montants[v].size());
+        m_debutDescendants[v + 1] = m_debutDescendants[v] + static_cast<uint32_t>(descendants[v].size());
+    }
+    m_montants.reserve(m_debutMontants[n]);
+    m_descendants.reserve(m_debutDescendants[n]);
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        for (const auto &a : montants[v])
+        {
+            m_montants.push_back(a);
+            if (a.milieu != aucun) ++m_nbRaccourcis;
+        }
+        for (const auto &a : descendants[v])
+        {
+            m_descendants.push_back(a);
+            if (a.milieu != aucun) ++m_nbRaccourcis;
+        }
+    }
+}
+
+size_t HierarchieContraction::getNbSommets() const
+{
+    return m_nbSommets;
+}
+
+//! \brief retourne le nombre d'arcs de la hiérarchie (arcs originaux et raccourcis, montants et descendants)
+size_t HierarchieContraction::getNbArcs() const
+{
+    return m_montants.size() + m_descendants.size();
+}
+
+size_t HierarchieContraction::getNbRaccourcis() const
+{
+    return m_nbRaccourcis;
+}
+
+//! \brief retourne une estimation du nombre d'octets occupés par la hiérarchie
+size_t HierarchieContraction::getTailleMemoire() const
+{
+    return (m_debutMontants.capacity() + m_debutDescendants.capacity()) * sizeof(uint32_t)
+           + (m_montants.capacity() + m_descendants.capacity()) * sizeof(Arc)
+           + m_heures.capacity() * sizeof(unsigned int);
+}
+
+//! \brief Plus court chemin entre le sommet origine virtuel et le sommet destination virtuel d'une requête
+//! \brief Mêmes conventions et même distance que Graphe::plusCourtChemin(const ArcsVirtuels &, ...)
+//! \param[in] p_arcs: les arcs sortant du sommet origine virtuel (getNbSommets()) et entrant au sommet destination virtuel (getNbSommets() + 1)
+//! \param[out] p_chemin: le chemin, raccourcis déroulés, de l'origine virtuelle à la destination virtuelle (un seul noeud si la destination est inatteignable)
+//! \return la longueur du chemin (= numeric_limits<unsigned int>::max() si la destination n'est pas atteignable)
+//! \throws logic_error lorsqu'un arc virtuel réfère à un sommet inexistant
+unsigned int HierarchieContraction::plusCourtChemin(const Graphe::ArcsVirtuels &p_arcs, vector<size_t> &p_chemin) const
+{
+    EtatRecherche etat;
+    return plusCourtChemin(p_arcs, p_chemin, etat);
+}
+
+//! \brief Même recherche que ci-dessus, mais avec des tableaux de travail fournis par l'appelant
+//! \brief Sans heures, les deux recherches avancent à tour de rôle (la plus petite clé d'abord) et s'arrêtent quand
+//! \brief leur plus petite clé atteint la meilleure longueur trouvée. Avec des heures, la recherche avant (montante,
+//! \brief donc petite) est complétée d'abord; la clé d'un sommet x de la recherche arrière est alors sa distance vers
+//! \brief la destination plus heure(x) - heure de départ, une borne inférieure de tout chemin passant par x.
+//! \param[in,out] p_etat: l'état de recherche du fil d'exécution appelant; il ne doit pas être partagé entre fils d'exécution
+unsigned int HierarchieContraction::plusCourtChemin(const Graphe::ArcsVirtuels &p_arcs, vector<size_t> &p_chemin,
+                                                    EtatRecherche &p_etat) const
+{
+    const unsigned int infini = numeric_limits<unsigned int>::max();
+    const size_t origine = m_nbSommets;
+    const size_t destination = m_nbSommets + 1;
+
+    if (p_etat.distanceAvant.size() != m_nbSommets)
+    {
+        p_etat.distanceAvant.assign(m_nbSommets, infini);
+        p_etat.distanceArriere.assign(m_nbSommets, infini);
+        p_etat.arcAvant.assign(m_nbSommets, aucun);
+        p_etat.arcArriere.assign(m_nbSommets, aucun);
+    }
+    else
+    {
+        for (size_t s : p_etat.sommetsModifies)
+        {
+            p_etat.distanceAvant[s] = infini;
+            p_etat.distanceArriere[s] = infini;
+            p_etat.arcAvant[s] = aucun;
+            p_etat.arcArriere[s] = aucun;
+        }
+    }
+    p_etat.sommetsModifies.clear();
+    vector<unsigned int> &distanceAvant = p_etat.distanceAvant;
+    vector<unsigned int> &distanceArriere = p_etat.distanceArriere;
+
+    typedef pair<unsigned int, uint32_t> Entree; //(clé, sommet)
+    priority_queue<Entree, vector<Entree>, greater<Entree> > fileAvant;
+    priority_queue<Entree, vector<Entree>, greater<Entree> > fileArriere;
+
+    //borne inférieure de la distance de l'origine virtuelle à un sommet: son heure moins l'heure de départ
+    const bool guidee = !m_heures.empty();
+    unsigned int heureDepart = 0;
+    for (const auto &arc : p_arcs.depuisOrigine)
+    {
+        if (arc.first >= m_nbSommets)
+            throw logic_error("HierarchieContraction::plusCourtChemin(): un arc de l'origine mène à un sommet inexistant");
+        if (guidee && m_heures[arc.first] > arc.second)
+            heureDepart = max(heureDepart, m_heures[arc.first] - arc.second);
+    }
+    auto borneAvant = [&](uint32_t p_sommet)
+    {
+        return guidee && m_heures[p_sommet] > heureDepart ? m_heures[p_sommet] - heureDepart : 0;
+    };
+
+    //met à jour la distance d'un sommet atteint par l'arc p_arc (aucun pour un arc virtuel)
+    auto relacher = [&](vector<unsigned int> &p_distance, vector<uint32_t> &p_arcDe,
+                        priority_queue<Entree, vector<Entree>, greater<Entree> > &p_file,
+                        uint32_t p_sommet, unsigned int p_d, uint32_t p_arc, unsigned int p_borne)
+    {
+        if (p_d >= p_distance[p_sommet]) return;
+        if (distanceAvant[p_sommet] == infini && distanceArriere[p_sommet] == infini)
+            p_etat.sommetsModifies.push_back(p_sommet);
+        p_distance[p_sommet] = p_d;
+        p_arcDe[p_sommet] = p_arc;
+        p_file.push(Entree(p_d + p_borne, p_sommet));
+    };
+
+    for (const auto &arc : p_arcs.depuisOrigine)
+        relacher(distanceAvant, p_etat.arcAvant, fileAvant, static_cast<uint32_t>(arc.first), arc.second, aucun, 0);
+    for (const auto &arc : p_arcs.versDestination)
+    {
+        if (arc.first >= m_nbSommets)
+            throw logic_error("HierarchieContraction::plusCourtChemin(): un arc vers la destination part d'un sommet inexistant");
+        relacher(distanceArriere, p_etat.arcArriere, fileArriere, static_cast<uint32_t>(arc.first), arc.second, aucun,
+                 borneAvant(static_cast<uint32_t>(arc.first)));
+    }
+
+    unsigned int meilleure = infini;
+    uint32_t rencontre = aucun;
+    while (!fileAvant.empty() || !fileArriere.empty())
+    {
+        const bool avant = !fileAvant.empty() &&
+                           (guidee || fileArriere.empty() || fileAvant.top().first <= fileArriere.top().first);
+        auto &file = avant ? fileAvant : fileArriere;
+        Entree e = file.top();
+        if (e.first >= meilleure)
+        {
+            if (!guidee || !avant) break; //c'est la plus petite clé des recherches qui restent
+            fileAvant = priority_queue<Entree, vector<Entree>, greater<Entree> >(); //la recherche avant est terminée
+            continue;
+        }
+        file.pop();
+        const uint32_t u = e.second;
+
+        if (avant)
+        {
+            if (e.first > distanceAvant[u]) continue;
+            if (distanceArriere[u] != infini && e.first + distanceArriere[u] < meilleure)
+            {
+                meilleure = e.first + distanceArriere[u];
+                rencontre = u;
+            }
+            for (uint32_t k = m_debutMontants[u]; k < m_debutMontants[u + 1]; ++k)
+                relacher(distanceAvant, p_etat.arcAvant, fileAvant, m_montants[k].voisin,
+                         e.first + m_montants[k].poids, k, 0);
+        }
+        else
+        {
+            const unsigned int d = distanceArriere[u];
+            if (e.first > d + borneAvant(u)) continue;
+            if (distanceAvant[u] != infini && d + distanceAvant[u] < meilleure)
+            {
+                meilleure = d + distanceAvant[u];
+                rencontre = u;
+            }
+            for (uint32_t k = m_debutDescendants[u]; k < m_debutDescendants[u + 1]; ++k)
+                relacher(distanceArriere, p_etat.arcArriere, fileArriere, m_descendants[k].voisin,
+                         d + m_descendants[k].poids, k, borneAvant(m_descendants[k].voisin));
+        }
+    }
+
+    p_chemin.clear();
+    if (meilleure == infini)
+    {
+        p_chemin.push_back(destination);
+        return infini;
+    }
+
+    //remontée de la recherche avant: de la rencontre jusqu'au premier sommet atteint depuis l'origine
+    vector<uint32_t> montee;
+    for (uint32_t v = rencontre; ; )
+    {
+        montee.push_back(v);
+        uint32_t k = p_etat.arcAvant[v];
+        if (k == aucun) break;
+        v = static_cast<uint32_t>(upper_bound(m_debutMontants.begin(), m_debutMontants.end(), k) - m_debutMontants.begin() - 1);
+    }
+    reverse(montee.begin(), montee.end());
+    p_chemin.push_back(origine);
+    p_chemin.push_back(montee[0]);
+    for (size_t i = 1; i < montee.size(); ++i)
+        derouler(montee[i - 1], montee[i], m_montants[p_etat.arcAvant[montee[i]]].milieu, p_chemin);
+
+    //descente de la recherche arrière: de la rencontre jusqu'au dernier sommet, relié à la destination
+    for (uint32_t v = rencontre; p_etat.arcArriere[v] != aucun; )
+    {
+        uint32_t k = p_etat.arcArriere[v];
+        uint32_t suivant = static_cast<uint32_t>(upper_bound(m_debutDescendants.begin(), m_debutDescendants.end(), k) -
+                                                 m_debutDescendants.begin() - 1);
+        derouler(v, suivant, m_descendants[k].milieu, p_chemin);
+        v = suivant;
+    }
+    p_chemin.push_back(destination);
+
+    return meilleure;
+}
+
+//! \brief ajoute à p_chemin les sommets du graphe original que parcourt l'arc (p_de, p_vers), p_de exclu
+//! \param[in] p_milieu: le sommet contourné par l'arc, ou aucun s'il s'agit d'un arc du graphe original
+//! \throws logic_error si un demi-raccourci est introuvable (hiérarchie incohérente)
+void HierarchieContraction::derouler(uint32_t p_de, uint32_t p_vers, uint32_t p_milieu, vector<size_t> &p_chemin) const
+{
+    //pile explicite: un raccourci peut en contenir beaucoup d'autres
+    vector<tuple<uint32_t, uint32_t, uint32_t> > pile(1, make_tuple(p_de, p_vers, p_milieu));
+    while (!pile.empty())
+    {
+        uint32_t de, vers, milieu;
+        tie(de, vers, milieu) = pile.back();
+        pile.pop_back();
+        if (milieu == aucun)
+        {
+            p_chemin.push_back(vers);
+            continue;
+        }
+
+        //le milieu a été contracté avant ses deux voisins: (de, milieu) est descendant et (milieu, vers) est montant
+        const Arc *premier = nullptr;
+        for (uint32_t k = m_debutDescendants[milieu]; k < m_debutDescendants[milieu + 1] && !premier; ++k)
+            if (m_descendants[k].voisin == de) premier = &m_descendants[k];
+        const Arc *second = nullptr;
+        for (uint32_t k = m_debutMontants[milieu]; k < m_debutMontants[milieu + 1] && !second; ++k)
+            if (m_montants[k].voisin == vers) second = &m_montants[k];
+        if (!premier || !second)
+            throw logic_error("HierarchieContraction::derouler(): raccourci sans arcs correspondants");
+
+        pile.push_back(make_tuple(milieu, vers, second->milieu));
+        pile.push_back(make_tuple(de, milieu, premier->milieu));
+    }
+}
@@ -0,0 +1,64 @@
+//
+//  hierarchieContraction.h
+//  Hiérarchie de contraction d'un graphe orienté pondéré (non négativement) qui ne change plus
+//
+
+#ifndef HIERARCHIE_CONTRACTION_H
+#define HIERARCHIE_CONTRACTION_H
+
+#include "graphe.h"
+#include <cstdint>
+
+//! \brief  Hiérarchie de contraction construite une fois pour toutes à partir d'un Graphe
+//! \brief  Les sommets sont contractés du moins important au plus important; chaque contraction ajoute les raccourcis
+//! \brief  nécessaires pour préserver les plus courts chemins entre les sommets restants. Une requête explore le graphe
+//! \brief  montant depuis l'origine et le graphe descendant, à rebours, depuis la destination; les raccourcis du chemin
+//! \brief  trouvé sont ensuite déroulés en sommets du graphe original.
+//! \brief  Si une heure est fournie pour chaque sommet (graphe espace-temps), la recherche avant est complétée d'abord
+//! \brief  et la recherche arrière est guidée (A*) par la borne inférieure qu'en donnent les heures.
+class HierarchieContraction
+{
+public:
+    //! \brief tableaux de travail d'une requête, réutilisables d'une requête à l'autre par un même fil d'exécution
+    struct EtatRecherche
+    {
+        std::vector<unsigned int> distanceAvant; //depuis l'origine virtuelle, dans le graphe montant
+        std::vector<unsigned int> distanceArriere; //vers la destination virtuelle, dans le graphe descendant
+        std::vector<uint32_t> arcAvant; //indice dans m_montants de l'arc par lequel on a atteint le sommet
+        std::vector<uint32_t> arcArriere; //indice dans m_descendants de l'arc par lequel on a atteint le sommet
+        std::vector<size_t> sommetsModifies;
+    };
+
+    explicit HierarchieContraction(const Graphe &, const std::vector<unsigned int> & p_heures = std::vector<unsigned int>(),
+                                   unsigned int p_maxVisitesTemoin = 500);
+
+    unsigned int plusCourtChemin(const Graphe::ArcsVirtuels & p_arcs, std::vector<size_t> & p_chemin) const;
+    unsigned int plusCourtChemin(const Graphe::ArcsVirtuels & p_arcs, std::vector<size_t> & p_chemin,
+                                 EtatRecherche & p_etat) const;
+    size_t getNbSommets() const;
+    size_t getNbArcs() const;
+    size_t getNbRaccourcis() const;
+    size_t getTailleMemoire() const;
+
+private:
+    struct Arc
+    {
+        uint32_t voisin;
+        unsigned int poids;
+        uint32_t milieu; //sommet contracté qu'un raccourci contourne (aucun pour un arc du graphe original)
+    };
+
+    static const uint32_t aucun = std::numeric_limits<uint32_t>::max();
+
+    size_t m_nbSommets;
+    size_t m_nbRaccourcis;
+    std::vector<uint32_t> m_debutMontants; //arcs (u, v) tels que u est contracté avant v, rangés par u (voisin = v)
+    std::vector<Arc> m_montants;
+    std::vector<uint32_t> m_debutDescendants; //arcs (u, v) tels que v est contracté avant u, rangés par v (voisin = u)
+    std::vector<Arc> m_descendants;
+    std::vector<unsigned int> m_heures; //heure de chaque sommet (graphe espace-temps); vide si non fournie
+
+    void derouler(uint32_t p_de, uint32_t p_vers, uint32_t p_milieu, std::vector<size_t> & p_chemin) const;
+};
+
+#endif
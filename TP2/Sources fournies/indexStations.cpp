@@ -0,0 +1,214 @@
+//
+// Index spatial (grille uniforme) des stations, pour trouver rapidement les stations proches d'un point
+//
+
+#include "indexStations.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+constexpr double IndexStations::rayonTerre;
+
+static const double degresParRadian = 180.0 / 3.14159265358979323846;
+static const size_t nbCellulesMaxParAxe = 1024;
+
+//! \brief construit la grille
+//! \param[in] p_stations: les stations (normalement DonneesGTFS::getStations())
+//! \param[in] p_tailleCellule: le côté approximatif d'une cellule, en km; environ la moitié du rayon des recherches
+//! \throws logic_error si p_tailleCellule n'est pas strictement positive
+IndexStations::IndexStations(const std::map<std::string, Station> &p_stations, double p_tailleCellule)
+        : m_tailleCellule(p_tailleCellule), m_latitudeMin(0), m_longitudeMin(0), m_hauteurCellule(1),
+          m_largeurCellule(1), m_nbRangees(1), m_nbColonnes(1)
+{
+    if (!(p_tailleCellule > 0))
+        throw logic_error("IndexStations::IndexStations(): la taille des cellules doit être positive");
+    for (const auto &station : p_stations)
+    {
+        m_stations.push_back(&station);
+        m_coordonnees.push_back(station.second.getCoords());
+    }
+    construireGrille();
+}
+
+//! \brief construit la grille sur des coordonnées (par exemple les stations d'un ReseauProjete)
+//! \param[in] p_coordonnees: les coordonnées des stations; Voisin::indice donne la position dans ce vecteur
+//! \param[in] p_tailleCellule: le côté approximatif d'une cellule, en km; environ la moitié du rayon des recherches
+//! \throws logic_error si p_tailleCellule n'est pas strictement positive
+IndexStations::IndexStations(const std::vector<Coordonnees> &p_coordonnees, double p_tailleCellule)
+        : m_coordonnees(p_coordonnees), m_tailleCellule(p_tailleCellule), m_latitudeMin(0), m_longitudeMin(0),
+          m_hauteurCellule(1), m_largeurCellule(1), m_nbRangees(1), m_nbColonnes(1)
+{
+    if (!(p_tailleCellule > 0))
+        throw logic_error("IndexStations::IndexStations(): la taille des cellules doit être positive");
+    construireGrille();
+}
+
+//! \brief dimensionne la grille sur m_coordonnees et y range les stations
+void IndexStations::construireGrille()
+{
+    double latitudeMax = -90;
+    double longitudeMax = -180;
+    double latitudeAbsMax = 0;
+    m_latitudeMin = 90;
+    m_longitudeMin = 180;
+    for (const Coordonnees &c : m_coordonnees)
+    {
+        m_latitudeMin = min(m_latitudeMin, c.getLatitude());
+        m_longitudeMin = min(m_longitudeMin, c.getLongitude());
+        latitudeMax = max(latitudeMax, c.getLatitude());
+        longitudeMax = max(longitudeMax, c.getLongitude());
+        latitudeAbsMax = max(latitudeAbsMax, fabs(c.getLatitude()));
+    }
+    if (!m_coordonnees.empty())
+    {
+        //une cellule mesure environ m_tailleCellule km de côté à la latitude la plus éloignée de l'équateur
+        m_hauteurCellule = m_tailleCellule / rayonTerre * degresParRadian;
+        m_largeurCellule = m_hauteurCellule / max(cos(latitudeAbsMax / degresParRadian), 1e-6);
+        m_hauteurCellule = max(m_hauteurCellule, (latitudeMax - m_latitudeMin) / nbCellulesMaxParAxe);
+        m_largeurCellule = max(m_largeurCellule, (longitudeMax - m_longitudeMin) / nbCellulesMaxParAxe);
+        m_nbRangees = min(nbCellulesMaxParAxe, static_cast<size_t>((latitudeMax - m_latitudeMin) / m_hauteurCellule) + 1);
+        m_nbColonnes = min(nbCellulesMaxParAxe, static_cast<size_t>((longitudeMax - m_longitudeMin) / m_largeurCellule) + 1);
+    }
+
+    //tri par cellule (format CSR); dans une cellule, les stations restent dans l'ordre des identifiants
+    vector<uint32_t> celluleDeStation(m_coordonnees.size());
+    m_debutCellule.assign(m_nbRangees * m_nbColonnes + 1, 0);
+    for (size_t i = 0; i < m_coordonnees.size(); ++i)
+    {
+        const Coordonnees &c = m_coordonnees[i];
+        size_t rangee = min(m_nbRangees - 1, static_cast<size_t>((c.getLatitude() - m_latitudeMin) / m_hauteurCellule));
+        size_t colonne = min(m_nbColonnes - 1, static_cast<size_t>((c.getLongitude() - m_longitudeMin) / m_largeurCellule));
+        celluleDeStation[i] = static_cast<uint32_t>(rangee * m_nbColonnes + colonne);
+        ++m_debutCellule[celluleDeStation[i] + 1];
+    }
+    for (size_t c = 0; c + 1 < m_debutCellule.size(); ++c)
+        m_debutCellule[c + 1] += m_debutCellule[c];
+    m_stationsDesCellules.resize(m_coordonnees.size());
+    vector<uint32_t> prochain(m_debutCellule.begin(), m_debutCellule.end() - 1);
+    for (size_t i = 0; i < m_coordonnees.size(); ++i)
+        m_stationsDesCellules[prochain[celluleDeStation[i]]++] = static_cast<uint32_t>(i);
+}
+
+//! \brief retourne, en ordre croissant, les indices des stations des cellules qui recoupent le rectangle englobant
+//! \brief le cercle de rayon p_rayon centré en p_point
+std::vector<uint32_t> IndexStations::candidats(const Coordonnees &p_point, double p_rayon) const
+{
+    vector<uint32_t> indices;
+    if (m_coordonnees.empty() || !(p_rayon >= 0)) return indices;
+
+    //rectangle englobant exact sur la sphère, élargi d'un millimètre pour absorber les erreurs d'arrondi
+    const double angle = (p_rayon + 1e-6) / rayonTerre;
+    const double latitude = p_point.getLatitude() / degresParRadian;
+    double latitudeBas = (latitude - angle) * degresParRadian;
+    double latitudeHaut = (latitude + angle) * degresParRadian;
+    double longitudeGauche = -180;
+    double longitudeDroite = 180;
+    if (latitudeBas > -90 && latitudeHaut < 90 && sin(angle) < cos(latitude))
+    {
+        const double ecartLongitude = asin(sin(angle) / cos(latitude)) * degresParRadian;
+        longitudeGauche = p_point.getLongitude() - ecartLongitude;
+        longitudeDroite = p_point.getLongitude() + ecartLongitude;
+    }
+
+    //cellules recoupant le rectangle, bornées à la grille
+    const double rangeeBas = floor((latitudeBas - m_latitudeMin) / m_hauteurCellule);
+    const double rangeeHaut = floor((latitudeHaut - m_latitudeMin) / m_hauteurCellule);
+    const double colonneGauche = floor((longitudeGauche - m_longitudeMin) / m_largeurCellule);
+    const double colonneDroite = floor((longitudeDroite - m_longitudeMin) / m_largeurCellule);
+    if (rangeeHaut < 0 || colonneDroite < 0 || rangeeBas >= m_nbRangees || colonneGauche >= m_nbColonnes)
+        return indices;
+    const size_t r0 = static_cast<size_t>(max(0.0, rangeeBas));
+    const size_t r1 = static_cast<size_t>(min<double>(m_nbRangees - 1, rangeeHaut));
+    const size_t c0 = static_cast<size_t>(max(0.0, colonneGauche));
+    const size_t c1 = static_cast<size_t>(min<double>(m_nbColonnes - 1, colonneDroite));
+
+    for (size_t r = r0; r <= r1; ++r)
+    {
+        const size_t debut = m_debutCellule[r * m_nbColonnes + c0];
+        const size_t fin = m_debutCellule[r * m_nbColonnes + c1 + 1];
+        indices.insert(indices.end(), m_stationsDesCellules.begin() + debut, m_stationsDesCellules.begin() + fin);
+    }
+    sort(indices.begin(), indices.end());
+    return indices;
+}
+
+//! \brief retourne le voisin d'indice p_indice (dans m_coordonnees) à p_distance km
+IndexStations::Voisin IndexStations::voisin(uint32_t p_indice, double p_distance) const
+{
+    return {m_stations.empty() ? nullptr : m_stations[p_indice], p_distance, p_indice};
+}
+
+//! \brief retourne les stations à au plus p_rayon km de p_point
+//! \param[in] p_point: le centre de la recherche
+//! \param[in] p_rayon: le rayon de la recherche, en km
+//! \param[in] p_confondusInclus: true pour inclure, à distance 0, les stations pour lesquelles Coordonnees::operator-
+//! \param[in] donne NaN (points confondus ou presque)
+//! \return les stations telles que (p_point - coordonnées) <= p_rayon, dans l'ordre des identifiants; c'est le même
+//! \return test, dans le même ordre, qu'un parcours de toutes les stations
+std::vector<IndexStations::Voisin> IndexStations::dansRayon(const Coordonnees &p_point, double p_rayon,
+                                                            bool p_confondusInclus) const
+{
+    vector<Voisin> voisins;
+    for (uint32_t i : candidats(p_point, p_rayon))
+    {
+        double distance = p_point - m_coordonnees[i];
+        if (p_confondusInclus && std::isnan(distance)) distance = 0;
+        if (distance <= p_rayon) voisins.push_back(voisin(i, distance));
+    }
+    return voisins;
+}
+
+//! \brief retourne les p_k stations les plus proches de p_point (toutes les stations s'il y en a moins de p_k)
+//! \brief Le rayon de recherche part de la taille d'une cellule et double jusqu'à contenir p_k stations.
+//! \return les stations en ordre croissant de distance (puis d'identifiant); une station confondue avec p_point,
+//! \return pour laquelle Coordonnees::operator- peut donner NaN, est à distance 0
+std::vector<IndexStations::Voisin> IndexStations::plusProches(const Coordonnees &p_point, size_t p_k) const
+{
+    vector<Voisin> voisins;
+    p_k = min(p_k, m_coordonnees.size());
+    if (p_k == 0) return voisins;
+
+    for (double rayon = m_tailleCellule; ; rayon *= 2)
+    {
+        //au-delà d'un demi-tour de la Terre, le cercle contient toutes les stations
+        const bool toutes = rayon >= rayonTerre * 3.14159265358979323846;
+        voisins.clear();
+        vector<uint32_t> indices = candidats(p_point, min(rayon, rayonTerre * 3.14159265358979323846));
+        for (uint32_t i : indices)
+        {
+            double distance = p_point - m_coordonnees[i];
+            if (std::isnan(distance)) distance = 0;
+            if (distance <= rayon || toutes) voisins.push_back(voisin(i, distance));
+        }
+        if (voisins.size() >= p_k || toutes) break;
+    }
+
+    //stable: à distance égale, l'ordre des identifiants est conservé
+    stable_sort(voisins.begin(), voisins.end(), [](const Voisin &a, const Voisin &b)
+    {
+        return a.distance < b.distance;
+    });
+    voisins.resize(min(p_k, voisins.size()));
+    return voisins;
+}
+
+size_t IndexStations::getNbStations() const
+{
+    return m_coordonnees.size();
+}
+
+size_t IndexStations::getNbCellules() const
+{
+    return m_nbRangees * m_nbColonnes;
+}
+
+//! \brief retourne le nombre d'octets occupés par la grille (les stations elles-mêmes ne sont pas comptées)
+size_t IndexStations::getTailleMemoire() const
+{
+    return m_stations.capacity() * sizeof(const EntreeStation *) + m_coordonnees.capacity() * sizeof(Coordonnees)
+           + m_debutCellule.capacity() * sizeof(uint32_t)
+           + m_stationsDesCellules.capacity() * sizeof(uint32_t);
+}
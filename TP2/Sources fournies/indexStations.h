@@ -0,0 +1,63 @@
+//
+// Index spatial (grille uniforme) des stations, pour trouver rapidement les stations proches d'un point
+//
+
+#ifndef TP2_INDEXSTATIONS_H
+#define TP2_INDEXSTATIONS_H
+
+#include "station.h"
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+//! \brief Grille uniforme en latitude et longitude sur les stations, construite une seule fois
+//! \brief Une requête ne calcule la distance (Coordonnees::operator-) qu'aux stations des cellules qui recoupent le
+//! \brief rectangle englobant le cercle de recherche; ce rectangle est exact sur la sphère, donc aucune station n'est manquée.
+//! \brief Les stations sont référencées par pointeur: le conteneur fourni au constructeur doit survivre à l'index et
+//! \brief ne pas être modifié. Construit à partir de simples coordonnées (sans Station), l'index ne donne que la
+//! \brief position de chaque voisin dans le vecteur fourni.
+class IndexStations
+{
+
+public:
+    typedef std::map<std::string, Station>::value_type EntreeStation; //(identifiant, station)
+
+    struct Voisin
+    {
+        const EntreeStation *station; //nullptr si l'index a été construit à partir de coordonnées
+        double distance; //en km, telle que donnée par Coordonnees::operator-
+        uint32_t indice; //position de la station dans l'ordre des identifiants ou dans le vecteur de coordonnées
+    };
+
+    IndexStations(const std::map<std::string, Station> &, double p_tailleCellule);
+    IndexStations(const std::vector<Coordonnees> &, double p_tailleCellule);
+
+    std::vector<Voisin> dansRayon(const Coordonnees &, double p_rayon, bool p_confondusInclus = false) const;
+    std::vector<Voisin> plusProches(const Coordonnees &, size_t p_k) const;
+    size_t getNbStations() const;
+    size_t getNbCellules() const;
+    size_t getTailleMemoire() const;
+
+private:
+    static constexpr double rayonTerre = 6371; //en km, comme Coordonnees::operator-
+
+    std::vector<const EntreeStation *> m_stations; //dans l'ordre des identifiants; vide si construit de coordonnées
+    std::vector<Coordonnees> m_coordonnees; //les coordonnées de chaque station, dans le même ordre
+    double m_tailleCellule; //en km
+    double m_latitudeMin; //coin sud-ouest de la grille, en degrés
+    double m_longitudeMin;
+    double m_hauteurCellule; //en degrés
+    double m_largeurCellule;
+    size_t m_nbRangees;
+    size_t m_nbColonnes;
+    std::vector<uint32_t> m_debutCellule; //stations de la cellule c: m_stationsDesCellules[m_debutCellule[c] .. m_debutCellule[c + 1])
+    std::vector<uint32_t> m_stationsDesCellules; //indices dans m_stations, croissants dans chaque cellule
+
+    void construireGrille();
+    std::vector<uint32_t> candidats(const Coordonnees &, double p_rayon) const;
+    Voisin voisin(uint32_t, double p_distance) const;
+};
+
+
+#endif //TP2_INDEXSTATIONS_H
@@ -0,0 +1,12 @@
+//
+// Paramètres de marche communs à ReseauGTFS et aux routeurs qui doivent trouver les mêmes itinéraires
+//
+
+#ifndef TP2_PARAMETRESMARCHE_H
+#define TP2_PARAMETRESMARCHE_H
+
+const double vitesseDeMarche = 5.0; // vitesse moyenne de marche, en km/heure, d'un humain selon wikipedia
+const double distanceMaxMarche = 1.5; // distance maximale de marche permise, en km
+const unsigned int delaisMinArcsAttente = 300; // le délais minimal pour les arcs d'attentes en secondes
+
+#endif //TP2_PARAMETRESMARCHE_H
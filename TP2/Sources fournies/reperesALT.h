@@ -0,0 +1,61 @@
+//
+//  reperesALT.h
+//  Repères (landmarks) ALT: bornes inférieures par l'inégalité du triangle, pour guider (A*) les recherches d'un Graphe
+//
+
+#ifndef REPERES_ALT_H
+#define REPERES_ALT_H
+
+#include "graphe.h"
+#include <cstdint>
+
+//! \brief  Distances précalculées vers et depuis quelques repères, pour une recherche A* sur un Graphe qui ne change plus
+//! \brief  Les sommets sont regroupés en classes (par exemple les arrêts d'une même station d'un graphe espace-temps);
+//! \brief  les distances aux repères sont celles du graphe quotient des classes, dont l'arc (a, b) a le plus petit poids
+//! \brief  des arcs du graphe entre un sommet de a et un sommet de b. Tout chemin du graphe est donc au moins aussi
+//! \brief  long que le chemin correspondant du graphe quotient, et les bornes restent valides pour les sommets.
+//! \brief  Dans un graphe espace-temps, tous les chemins entre deux sommets ont la même durée (l'écart de leurs heures):
+//! \brief  des repères choisis parmi les sommets eux-mêmes ne donneraient que cet écart; le graphe quotient en est exempt.
+class ReperesALT
+{
+public:
+    //! \brief tableaux de travail d'une requête, réutilisables d'une requête à l'autre par un même fil d'exécution
+    struct EtatRecherche
+    {
+        std::vector<unsigned int> distance;
+        std::vector<size_t> predecesseur;
+        std::vector<unsigned int> poidsVersDestination;
+        std::vector<unsigned int> borne; //borne inférieure d'une classe vers la destination virtuelle, calculée au besoin
+        std::vector<size_t> sommetsModifies;
+        std::vector<size_t> sommetsVersDestination;
+        std::vector<uint32_t> classesBornees; //classes dont borne[] a été calculée
+        size_t nbSommetsSolutionnes; //par la dernière recherche
+    };
+
+    static const uint32_t aucune = std::numeric_limits<uint32_t>::max(); //classe d'un sommet sans classe (borne nulle)
+
+    ReperesALT(const Graphe &, const std::vector<uint32_t> & p_classeDuSommet, const std::vector<uint32_t> & p_reperes,
+               unsigned int p_nbFils = 0);
+
+    unsigned int plusCourtChemin(const Graphe &, const Graphe::ArcsVirtuels & p_arcs, std::vector<size_t> & p_chemin) const;
+    unsigned int plusCourtChemin(const Graphe &, const Graphe::ArcsVirtuels & p_arcs, std::vector<size_t> & p_chemin,
+                                 EtatRecherche & p_etat) const;
+    size_t getNbReperes() const;
+    size_t getNbClasses() const;
+    size_t getTailleMemoire() const;
+
+private:
+    static const unsigned int infini = std::numeric_limits<unsigned int>::max();
+
+    size_t m_nbSommets;
+    size_t m_nbClasses;
+    size_t m_nbReperes;
+    std::vector<uint32_t> m_classeDuSommet;
+    std::vector<unsigned int> m_versRepere; //m_versRepere[c * m_nbReperes + r]: distance de la classe c au repère r
+    std::vector<unsigned int> m_depuisRepere; //m_depuisRepere[c * m_nbReperes + r]: distance du repère r à la classe c
+
+    static void dijkstraQuotient(const std::vector<uint32_t> & p_debut, const std::vector<std::pair<uint32_t, unsigned int> > & p_arcs,
+                                 uint32_t p_source, size_t p_colonne, size_t p_nbColonnes, std::vector<unsigned int> & p_distances);
+};
+
+#endif
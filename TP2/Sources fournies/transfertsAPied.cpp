@@ -0,0 +1,97 @@
+//
+// Transferts à pied générés entre les stations proches, en complément des transferts de transfers.txt
+//
+
+#include "transfertsAPied.h"
+#include "indexStations.h"
+#include "graphe.h"
+#include "parallele.h"
+#include <set>
+#include <algorithm>
+
+using namespace std;
+
+//! \brief génère un transfert à pied entre chaque paire de stations distinctes à au plus p_rayon km l'une de l'autre
+//! \brief Les voisins de chaque station sont trouvés avec un IndexStations; chaque station est une tâche et les
+//! \brief transferts sont fusionnés dans l'ordre des stations, donc le résultat ne dépend pas du nombre de fils.
+//! \brief Les paires déjà présentes dans p_gtfs.getTransferts() sont omises: la durée de transfers.txt a préséance.
+//! \param[in] p_gtfs: les données GTFS (stations et transferts)
+//! \param[in] p_rayon: la distance maximale de marche, en km
+//! \param[in] p_vitesseDeMarche: en km/heure; la durée d'un transfert est distance / p_vitesseDeMarche, tronquée à la seconde
+//! \param[in] p_fermetureTransitive: true pour relier aussi les stations atteignables par une suite de transferts
+//! \param[in] générés; la durée est alors celle de la plus courte suite
+//! \param[in] p_nbFils: le nombre de fils d'exécution (0 pour utiliser thread::hardware_concurrency())
+//! \param[in] p_rayonFermeture: la marche totale d'une suite de transferts de la fermeture transitive, en km
+//! \param[in] (0 pour 3 * p_rayon); les suites plus longues sont omises et la recherche de chaque station s'arrête là
+//! \return les transferts, triés par station de départ puis par station d'arrivée
+//! \throws logic_error si p_rayon ou p_rayonFermeture est négatif ou si p_vitesseDeMarche n'est pas strictement positive
+Transferts genererTransfertsAPied(const DonneesGTFS &p_gtfs, double p_rayon, double p_vitesseDeMarche,
+                                  bool p_fermetureTransitive, unsigned int p_nbFils, double p_rayonFermeture)
+{
+    if (!(p_rayon >= 0))
+        throw logic_error("genererTransfertsAPied(): le rayon doit être positif ou nul");
+    if (!(p_rayonFermeture >= 0))
+        throw logic_error("genererTransfertsAPied(): le rayon de la fermeture transitive doit être positif ou nul");
+    if (!(p_vitesseDeMarche > 0))
+        throw logic_error("genererTransfertsAPied(): la vitesse de marche doit être strictement positive");
+
+    const auto &stations = p_gtfs.getStations();
+    vector<const string *> idDeStation;
+    map<string, uint32_t> indiceDeStation;
+    for (const auto &station : stations)
+    {
+        indiceDeStation.insert({station.first, static_cast<uint32_t>(idDeStation.size())});
+        idDeStation.push_back(&station.first);
+    }
+    set<pair<string, string> > transfertsGTFS;
+    for (const auto &transfert : p_gtfs.getTransferts())
+        transfertsGTFS.insert({get<0>(transfert), get<1>(transfert)});
+
+    //transferts directs: les voisins de chaque station, dans l'ordre des identifiants
+    IndexStations index(stations, max(p_rayon / 2, 0.05));
+    vector<vector<pair<uint32_t, unsigned int> > > directs(idDeStation.size());
+    executerEnParallele(idDeStation.size(), p_nbFils, [&](size_t s)
+    {
+        const Coordonnees &coords = stations.at(*idDeStation[s]).getCoords();
+        for (const auto &voisin : index.dansRayon(coords, p_rayon, true))
+        {
+            if (voisin.station->first == *idDeStation[s]) continue;
+            directs[s].push_back({indiceDeStation.at(voisin.station->first),
+                                  static_cast<unsigned int>(voisin.distance / p_vitesseDeMarche * 3600)});
+        }
+    });
+
+    //fermeture transitive: une recherche de un-vers-tous par station sur le graphe des transferts directs
+    vector<vector<pair<uint32_t, unsigned int> > > generes;
+    if (p_fermetureTransitive)
+    {
+        Graphe graphe(idDeStation.size());
+        for (size_t s = 0; s < directs.size(); ++s)
+            for (const auto &arc : directs[s])
+                graphe.ajouterArc(s, arc.first, arc.second);
+
+        //seuls les sommets touchés par la recherche bornée sont lus, dans l'ordre des stations
+        const unsigned int dureeMax = static_cast<unsigned int>(
+                (p_rayonFermeture > 0 ? p_rayonFermeture : 3 * p_rayon) / p_vitesseDeMarche * 3600);
+        generes.resize(idDeStation.size());
+        executerEnParallele(idDeStation.size(), p_nbFils, [&](size_t s, Graphe::EtatRecherche &etat)
+        {
+            Graphe::ArcsVirtuels arcs;
+            arcs.depuisOrigine.push_back({s, 0});
+            graphe.distancesDepuisOrigine(arcs, dureeMax, etat);
+            for (size_t t : etat.sommetsModifies)
+                if (t != s && t < idDeStation.size() && etat.distance[t] <= dureeMax)
+                    generes[s].push_back({static_cast<uint32_t>(t), etat.distance[t]});
+            sort(generes[s].begin(), generes[s].end());
+        });
+    }
+    else
+        generes.swap(directs);
+
+    Transferts transferts;
+    for (size_t s = 0; s < generes.size(); ++s)
+        for (const auto &arc : generes[s])
+            if (transfertsGTFS.find({*idDeStation[s], *idDeStation[arc.first]}) == transfertsGTFS.end())
+                transferts.emplace_back(*idDeStation[s], *idDeStation[arc.first], arc.second);
+    return transferts;
+}
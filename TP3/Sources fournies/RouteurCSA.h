@@ -0,0 +1,71 @@
+//
+// Routeur par balayage de connexions (Connection Scan Algorithm)
+//
+
+#ifndef TP2_ROUTEURCSA_H
+#define TP2_ROUTEURCSA_H
+
+#include "DonneesGTFS.h"
+#include "parametresMarche.h"
+#include <cstdint>
+#include <limits>
+
+//! \brief Routeur de plus hâtive arrivée construit directement à partir des données GTFS, sans graphe espace-temps
+//! \brief Les connexions élémentaires (arrêt i vers arrêt i+1 de chaque voyage) sont conservées dans un seul tableau
+//! \brief trié par heure de départ; une requête les balaie une seule fois, dans l'ordre, à partir de l'heure de départ.
+//! \brief Les règles de correspondance sont celles de ReseauGTFS: transferts de DonneesGTFS::getTransferts() et
+//! \brief délai minimal d'attente aux stations qui ne sont pas des stations de transfert.
+class RouteurCSA
+{
+
+public:
+    //! \brief un tronçon d'itinéraire: un voyage en autobus ou un déplacement à pieds entre deux stations
+    struct Troncon
+    {
+        std::string voyageId; //vide pour un déplacement à pieds
+        std::string stationDepart;
+        std::string stationArrivee;
+        unsigned int heureDepart; //en secondes depuis minuit
+        unsigned int heureArrivee;
+    };
+
+    //! \brief un trajet d'un profil: partir du point origine à heureDepart permet d'arriver à heureArrivee
+    struct Trajet
+    {
+        unsigned int heureDepart; //en secondes depuis minuit
+        unsigned int heureArrivee;
+    };
+
+    explicit RouteurCSA(const DonneesGTFS &);
+    unsigned int itineraire(const Coordonnees &, const Coordonnees &, const Heure &,
+                            std::vector<Troncon> * p_troncons = nullptr) const;
+    std::vector<Trajet> profil(const Coordonnees &, const Coordonnees &, const Heure &, const Heure &,
+                               unsigned int * p_tempsAPieds = nullptr) const;
+    size_t getNbConnexions() const;
+    size_t getTailleMemoire() const;
+
+private:
+    struct Connexion
+    {
+        uint32_t depart; //heure de départ, en secondes depuis minuit
+        uint32_t arrivee; //heure d'arrivée, en secondes depuis minuit
+        uint32_t stationDepart;
+        uint32_t stationArrivee;
+        uint32_t voyage;
+    };
+
+    static const uint32_t infini = std::numeric_limits<uint32_t>::max();
+
+    std::vector<Connexion> m_connexions; //triées par heure de départ
+    std::vector<std::string> m_stationIds; //m_stationIds[s] est l'identifiant de la station d'indice s
+    std::vector<Coordonnees> m_coordonnees; //m_coordonnees[s] sont les coordonnées de la station d'indice s
+    std::vector<bool> m_attentePermise; //true si la station n'est pas une station de transfert
+    std::vector<uint32_t> m_debutTransferts; //les transferts de la station s sont m_transferts[m_debutTransferts[s] .. m_debutTransferts[s+1])
+    std::vector<std::pair<uint32_t, uint32_t> > m_transferts; //(station destination, durée minimale)
+    std::vector<uint32_t> m_debutTransfertsInverses; //mêmes transferts, regroupés par station d'arrivée
+    std::vector<std::pair<uint32_t, uint32_t> > m_transfertsInverses; //(station de départ, durée minimale)
+    std::vector<std::string> m_voyageIds;
+};
+
+
+#endif //TP2_ROUTEURCSA_H
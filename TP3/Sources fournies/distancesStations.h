@@ -0,0 +1,47 @@
+//
+// Distances d'un point à toutes les stations en un seul balayage vectorisé (AVX2 si le processeur le permet)
+//
+
+#ifndef TP2_DISTANCESSTATIONS_H
+#define TP2_DISTANCESSTATIONS_H
+
+#include "station.h"
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+//! \brief Vecteurs unitaires des stations, rangés en tableaux séparés (x, y, z), pour comparer un point à toutes les stations
+//! \brief Coordonnees::operator- est R acos(u . v), où u et v sont les vecteurs unitaires des deux points: une station est
+//! \brief donc à au plus r km du point si u . v >= cos(r / R). Le balayage ne calcule ainsi ni acos, ni sin, ni cos;
+//! \brief il traite 4 stations à la fois avec AVX2 si le processeur le permet (vérifié à l'exécution), sinon une à la fois.
+//! \brief Les deux versions font les mêmes opérations dans le même ordre et retournent exactement les mêmes stations.
+//! \brief Les stations sont référencées par pointeur: le conteneur fourni au constructeur doit survivre à l'objet et
+//! \brief ne pas être modifié.
+class DistancesStations
+{
+
+public:
+    typedef std::map<std::string, Station>::value_type EntreeStation; //(identifiant, station)
+
+    explicit DistancesStations(const std::map<std::string, Station> &);
+    std::vector<uint32_t> dansRayon(const Coordonnees &, double p_rayon) const;
+    std::vector<uint32_t> dansRayonScalaire(const Coordonnees &, double p_rayon) const;
+    const EntreeStation *getStation(uint32_t) const;
+    size_t getNbStations() const;
+    size_t getTailleMemoire() const;
+    static bool avx2Disponible();
+
+private:
+    static constexpr double rayonTerre = 6371; //en km, comme Coordonnees::operator-
+
+    std::vector<const EntreeStation *> m_stations; //dans l'ordre des identifiants
+    std::vector<double> m_x; //complétés à un multiple de 4 par des NaN, qui ne sont jamais dans le rayon
+    std::vector<double> m_y;
+    std::vector<double> m_z;
+
+    static double seuil(double p_rayon);
+};
+
+
+#endif //TP2_DISTANCESSTATIONS_H
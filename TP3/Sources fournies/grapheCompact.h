@@ -0,0 +1,63 @@
+//
+//  grapheCompact.h
+//  Représentation compacte (en lecture seule) d'un Graphe, pour les recherches
+//
+
+#ifndef GRAPHE_COMPACT_H
+#define GRAPHE_COMPACT_H
+
+#include "graphe.h"
+#include <cstdint>
+
+//! \brief  Copie figée d'un Graphe dont les arcs sont rangés de façon contiguë (format CSR) selon l'un des encodages:
+//! \brief  - Entiers32: destination et poids sur 32 bits chacun (8 octets par arc)
+//! \brief  - Poids16: destination sur 32 bits, poids sur 16 bits; les rares poids qui ne tiennent pas sur 16 bits sont
+//! \brief    rangés dans une table de débordement (environ 6 octets par arc)
+//! \brief  - Delta: les arcs de chaque sommet sont triés par destination; chaque destination est codée par son écart à
+//! \brief    la précédente (à la source pour la première), puis le poids, en entiers de longueur variable (LEB128)
+//! \brief  Les recherches donnent les mêmes distances qu'avec le Graphe d'origine.
+class GrapheCompact
+{
+public:
+    enum class Encodage
+    {
+        Entiers32, Poids16, Delta
+    };
+
+    GrapheCompact(const Graphe &, Encodage);
+    Graphe versGraphe() const;
+
+    unsigned int plusCourtChemin(const Graphe::ArcsVirtuels & p_arcs, std::vector<size_t> & p_chemin,
+                                 Graphe::EtatRecherche & p_etat) const;
+    Encodage getEncodage() const;
+    size_t getNbSommets() const;
+    size_t getNbArcs() const;
+    size_t getTailleMemoire() const;
+
+    //! \brief défini dans grapheCompact.cpp, seul fichier qui parcourt les arcs compacts
+    template<typename Visiteur>
+    void pourChaqueArc(uint32_t p_sommet, Visiteur p_visiteur) const;
+
+private:
+    struct Arc32
+    {
+        uint32_t destination;
+        uint32_t poids;
+    };
+
+    static const uint16_t poidsDeborde = 0xFFFF; //le poids est dans m_debordements
+
+    Encodage m_encodage;
+    size_t m_nbSommets;
+    size_t m_nbArcs;
+    std::vector<uint32_t> m_debut; //arcs (Entiers32, Poids16) ou octets (Delta) du sommet i: [m_debut[i], m_debut[i + 1])
+    std::vector<Arc32> m_arcs32;
+    std::vector<uint32_t> m_destinations;
+    std::vector<uint16_t> m_poids16;
+    std::vector<std::pair<uint32_t, uint32_t> > m_debordements; //(indice de l'arc, poids), triées par indice
+    std::vector<uint8_t> m_octets;
+
+    uint32_t poidsDebordant(uint32_t p_arc) const;
+};
+
+#endif
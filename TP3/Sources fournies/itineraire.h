@@ -0,0 +1,154 @@
+//
+// Affichage d'un itinéraire à partir d'un chemin du graphe, commun à ReseauGTFS et à ReseauProjete
+//
+
+#ifndef TP2_ITINERAIRE_H
+#define TP2_ITINERAIRE_H
+
+#include "auxiliaires.h"
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+//! \brief vérifie le chemin d'une requête et, si demandé, affiche l'itinéraire correspondant
+//! \brief p_parcours décrit les sommets du chemin, sommets virtuels compris:
+//! \brief  - estOrigine(s), estDestination(s): s est le sommet origine virtuel, le sommet destination virtuel
+//! \brief  - station(s), voyage(s): clés comparables de la station et du voyage de s; les sommets virtuels ont leur
+//! \brief    propre station et leur propre voyage
+//! \brief  - afficherStation(s): affiche la station de s comme l'opérateur << de Station
+//! \brief  - afficherCourse(s): affiche « <numéro de ligne> à l'heure <heure d'arrivée> Vers <destination> »
+//! \brief  - heureArrivee(s): l'heure d'arrivée de s
+//! \param[in] p_chemin: le chemin du sommet origine virtuel au sommet destination virtuel
+//! \param[in] p_heureDepart: l'heure de départ du point origine
+//! \param[in] p_tempsDuTrajet: la longueur du chemin, en secondes (= numeric_limits<unsigned_int>::max() si aucun chemin)
+//! \param[in] p_afficherItineraire: true si on désire afficher l'itinéraire et false autrement
+//! \returns p_tempsDuTrajet
+//! \throws logic_error si le chemin est incohérent
+template<typename Parcours, typename Sommet>
+unsigned int afficherItineraire(const Parcours &p_parcours, const std::vector<Sommet> &p_chemin,
+                                const Heure &p_heureDepart, unsigned int p_tempsDuTrajet, bool p_afficherItineraire)
+{
+    using namespace std;
+    const vector<Sommet> &chemin = p_chemin;
+    const unsigned int tempsDuTrajet = p_tempsDuTrajet;
+
+    if (tempsDuTrajet == numeric_limits<unsigned int>::max())
+    {
+        if (p_afficherItineraire)
+            cout << "La destination n'est pas atteignable de l'orignine avec cette distance maximale de marche" << endl;
+        return tempsDuTrajet;
+    }
+
+    if (tempsDuTrajet == 0)
+    {
+        if (p_afficherItineraire) cout << "Vous êtes déjà situé à la destination demandée" << endl;
+        return tempsDuTrajet;
+    }
+
+    //un chemin non trivial a été trouvé
+    if (chemin.size() <= 2)
+        throw logic_error("afficherItineraire(): un chemin non trivial doit contenir au moins 3 sommets");
+    if (!p_parcours.estOrigine(chemin[0]))
+        throw logic_error("afficherItineraire(): le premier noeud du chemin doit être le point origine");
+    if (!p_parcours.estDestination(chemin[chemin.size() - 1]))
+        throw logic_error("afficherItineraire(): le dernier noeud du chemin doit être le point destination");
+
+    if (p_afficherItineraire)
+    {
+        cout << endl;
+        cout << "=====================" << endl;
+        cout << "     ITINÉRAIRE      " << endl;
+        cout << "=====================" << endl;
+        cout << endl;
+        cout << "Heure de départ du point d'origine: " << p_heureDepart << endl;
+    }
+    size_t a = chemin[0];
+    size_t b = chemin[1];
+    if (p_afficherItineraire)
+    {
+        cout << "Rendez vous à la station ";
+        p_parcours.afficherStation(b);
+        cout << endl;
+    }
+
+    size_t sommet = 1;
+    while (sommet < chemin.size() - 1)
+    {
+        a = b;
+        b = chemin[++sommet];
+        while (p_parcours.station(b) == p_parcours.station(a))
+        {
+            a = b;
+            b = chemin[++sommet];
+        }
+        //on a changé de station
+        if (p_parcours.estDestination(b)) //cas où on est arrivé à la destination
+        {
+            if (sommet != chemin.size() - 1)
+                throw logic_error("afficherItineraire(): incohérence de fin de chemin lors d'un changement de station");
+            break;
+        }
+        if (sommet == chemin.size() - 1)
+            throw logic_error("afficherItineraire(): on ne devrait pas être arrivé à destination");
+        //on a changé de station mais sommet n'est pas le noeud destination
+        if (p_parcours.voyage(a) != p_parcours.voyage(b)) //on a changé de station à pieds
+        {
+            if (p_afficherItineraire)
+            {
+                cout << "De cette station, rendez-vous à pieds à la station ";
+                p_parcours.afficherStation(b);
+                cout << endl;
+            }
+        }
+        else //on a changé de station avec un voyage
+        {
+            if (p_afficherItineraire)
+            {
+                cout << "De cette station, prenez l'autobus numéro ";
+                p_parcours.afficherCourse(a);
+                cout << endl;
+            }
+            //maintenant allons à la dernière station de ce voyage
+            a = b;
+            b = chemin[++sommet];
+            while (p_parcours.voyage(b) == p_parcours.voyage(a))
+            {
+                a = b;
+                b = chemin[++sommet];
+            }
+            //on a changé de voyage
+            if (p_afficherItineraire)
+            {
+                cout << "et arrêtez-vous à la station ";
+                p_parcours.afficherStation(a);
+                cout << " à l'heure " << p_parcours.heureArrivee(a) << endl;
+            }
+            if (p_parcours.estDestination(b)) //cas où on est arrivé à la destination
+            {
+                if (sommet != chemin.size() - 1)
+                    throw logic_error("afficherItineraire(): incohérence de fin de chemin lors d'un changement de voyage");
+                break;
+            }
+            if (p_parcours.station(a) != p_parcours.station(b)) //alors on s'est rendu à pieds à l'autre station
+                if (p_afficherItineraire)
+                {
+                    cout << "De cette station, rendez-vous à pieds à la station ";
+                    p_parcours.afficherStation(b);
+                    cout << endl;
+                }
+        }
+    }
+
+    if (p_afficherItineraire)
+    {
+        cout << "Déplacez-vous à pieds de cette station au point destination" << endl;
+        cout << "Heure d'arrivée à la destination: " << p_heureDepart.add_secondes(tempsDuTrajet) << endl;
+        cout << "Durée du trajet: " << tempsDuTrajet / 3600 << " heures, " << tempsDuTrajet % 3600 / 60
+             << " minutes, " << tempsDuTrajet % 60 << " secondes" << endl;
+    }
+
+    return tempsDuTrajet;
+}
+
+#endif //TP2_ITINERAIRE_H
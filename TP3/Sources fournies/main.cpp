@@ -4,46 +4,64 @@
 
 #include <iostream>
 #include <random>
+#include <thread>
+#include <chrono>
 
 #include "DonneesGTFS.h"
 #include "ReseauGTFS.h"
+#include "ReseauProjete.h"
+#include "indexStations.h"
+#include "transfertsAPied.h"
+#include "RouteurCSA.h"
+#include "RouteurRAPTOR.h"
+#include "RouteurMultiCriteres.h"
+#include "cacheItineraires.h"
+#include "distancesStations.h"
 
 using namespace std;
 
-int main()
+
+//! \brief les données partagées par les comparaisons: le GTFS de la journée, son réseau et les requêtes de la simulation
+struct Simulation
 {
-    const std::string chemin_dossier = "../RTC-1aout-25nov";
-    Date today(2022, 8, 3);
-    Heure now1(7, 30, 0);
-//  Date today; //Le constructeur par défaut initialise la date à aujourd'hui
-//  Heure now1; //Le constructeur par défaut initialise l'heure à maintenant
-    Heure now2 = now1.add_secondes(72000); //on désire obtenir tous les arrêts du reste de la journée
+    std::string cheminDossier;
+    Date date;
+    Heure depart; //l'heure de départ des requêtes
+    Heure finJournee;
+    DonneesGTFS &donnees;
+    ReseauGTFS &reseau;
+    std::default_random_engine generateur;
+    vector<pair<Coordonnees, Coordonnees> > paires; //les requêtes de la simulation
+    vector<unsigned int> tempsDesTrajets; //leurs temps de trajet sur reseau_rtc, tel que construit
+    vector<unsigned int> tempsCSA; //leurs temps de trajet selon RouteurCSA
+};
 
-    clock_t begin = clock();
-    DonneesGTFS donnees_rtc(today, now1, now2);
-    donnees_rtc.ajouterLignes(chemin_dossier + "/routes.txt");
-    cout << "Nombre de lignes = " << donnees_rtc.getNbLignes() << endl;
-    donnees_rtc.ajouterStations(chemin_dossier + "/stops.txt");
-    cout << "Nombre de stations initiales = " << donnees_rtc.getNbStations() << endl;
-    donnees_rtc.ajouterServices(chemin_dossier + "/calendar_dates.txt");
-    size_t nb_services = donnees_rtc.getNbServices();
-    cout << "Nombre de services = " << nb_services << endl;
-    if (nb_services == 0) throw logic_error("main(): On doit avoir nb_services > 0 pour continuer");
-    donnees_rtc.ajouterVoyagesDeLaDate(chemin_dossier + "/trips.txt");
-    donnees_rtc.ajouterArretsDesVoyagesDeLaDate(chemin_dossier + "/stop_times.txt");
-    donnees_rtc.ajouterTransferts(chemin_dossier + "/transfers.txt");
-    clock_t end = clock();
-    cout << "Chargement des données effectué en " << double(end - begin) / CLOCKS_PER_SEC << " secondes" << endl;
-    cout << "Nombre de stations ayant au moins 1 arrêt = " << donnees_rtc.getNbStations() << endl;
-    cout << "Nombre de transferts = " << donnees_rtc.getNbTransferts() << endl;
-    cout << "Nombres de voyages = " << donnees_rtc.getNbVoyages() << endl;
-    cout << "Nombre d'arrêts = " << donnees_rtc.getNbArrets() << endl;
-    begin = clock();
-    ReseauGTFS reseau_rtc(donnees_rtc);
-    end = clock();
-    cout << "Le nombre d'arcs (sans le point origine et destination) est = " << reseau_rtc.getNbArcs() << endl;
-    cout << "Graphe (sans le point source et destination) a été produit en " << double(end - begin) / CLOCKS_PER_SEC
-         << " secondes" << endl << endl;
+//! \brief lit les fichiers GTFS d'un dossier dans p_donnees, dont la date et l'intervalle de temps sont déjà fixés
+static void chargerDonnees(DonneesGTFS &p_donnees, const std::string &p_cheminDossier)
+{
+    p_donnees.ajouterLignes(p_cheminDossier + "/routes.txt");
+    p_donnees.ajouterStations(p_cheminDossier + "/stops.txt");
+    p_donnees.ajouterServices(p_cheminDossier + "/calendar_dates.txt");
+    p_donnees.ajouterVoyagesDeLaDate(p_cheminDossier + "/trips.txt");
+    p_donnees.ajouterArretsDesVoyagesDeLaDate(p_cheminDossier + "/stop_times.txt");
+    p_donnees.ajouterTransferts(p_cheminDossier + "/transfers.txt");
+}
+
+//! \brief vérifie qu'une comparaison d'équivalence a donné le même résultat pour chacun de ses cas
+//! \throws logic_error si p_nbIdentiques != p_nbCas
+static void exigerIdentiques(size_t p_nbIdentiques, size_t p_nbCas, const std::string &p_comparaison)
+{
+    if (p_nbIdentiques != p_nbCas)
+        throw logic_error("main(): " + p_comparaison + ": " + to_string(p_nbIdentiques) + "/" + to_string(p_nbCas)
+                          + " résultats identiques");
+}
+
+//! \brief les requêtes aléatoires de la simulation, affichées; remplit les paires et leurs temps de trajet
+static void simulerRequetes(Simulation &p_simulation)
+{
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    std::default_random_engine &generator = p_simulation.generateur;
 
     cout << "==========================================" << endl;
     cout << "           début de la simulation         " << endl;
@@ -51,13 +69,12 @@ int main()
 
     //placement des stations_id dans un vector pour une meilleure sélection aléatoire
     vector<std::string> station_ids;
-    const auto &stations = donnees_rtc.getStations();
+    const auto &stations = p_simulation.donnees.getStations();
     for (const auto &station : stations)
     {
         station_ids.push_back(station.first);
     }
 
-    std::default_random_engine generator;
     std::uniform_int_distribution<unsigned int> distribution(0, (unsigned int) (station_ids.size() -
                                                                                 1)); //range of numbers
     for (int i = 1; i <= 653; ++i) //réchauffement du générateur de nombres aléatoires
@@ -70,6 +87,8 @@ int main()
     long moy_tempsExecution = 0;
 
     unsigned int nbDeTestsComptabilises = 0;
+    vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires; //les mêmes requêtes, pour les comparaisons
+    vector<unsigned int> &tempsDesTrajets = p_simulation.tempsDesTrajets;
     //on comptabilise un test seulement si la destination est atteignable et différente de l'origine
     for (unsigned int i = 0; i < nbDeTests; ++i)
     {
@@ -96,6 +115,8 @@ int main()
 
         long tempsExecution(0);
         unsigned int tempsDuTrajet = reseau_rtc.itineraire(donnees_rtc, afficherItineraire, tempsExecution);
+        paires.push_back(make_pair(pointOrigine, pointDestination));
+        tempsDesTrajets.push_back(tempsDuTrajet);
         if (tempsDuTrajet == numeric_limits<unsigned int>::max())
         {
             cout << "impossible d'atteindre la destination. On passe au test suivant." << endl;
@@ -118,8 +139,1418 @@ int main()
 
     cout << endl << "La moyenne du temps d'exécution sur " << nbDeTests << " itinéraires est de "
          << (double)moy_tempsExecution / (double)nbDeTestsComptabilises << " microsecondes" << endl;
+}
 
-    return 0;
+//! \brief les mêmes requêtes en lot sur plusieurs fils d'exécution
+static void comparerTraitementEnLot(Simulation &p_simulation)
+{
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+    const vector<unsigned int> &tempsDesTrajets = p_simulation.tempsDesTrajets;
+
+    cout << endl;
+    cout << "==========================================" << endl;
+    cout << "         traitement en lot parallèle      " << endl;
+    cout << "==========================================" << endl << endl;
+
+    unsigned int nbFils = std::thread::hardware_concurrency();
+    ReseauGTFS::ResultatsLot lot = reseau_rtc.itinerairesEnLot(donnees_rtc, paires, nbFils);
+    if (lot.tempsDuTrajet != tempsDesTrajets)
+        throw logic_error("main(): le traitement en lot ne donne pas les mêmes temps de trajet");
+    cout << "Les " << paires.size() << " requêtes ont été traitées avec " << nbFils << " fils d'exécution en "
+         << lot.tempsTotal << " microsecondes" << endl;
+    cout << "Débit: " << lot.requetesParSeconde << " requêtes par seconde" << endl;
+    cout << "Latence par requête (microsecondes): p50 = " << lot.latenceP50 << ", p90 = " << lot.latenceP90
+         << ", p99 = " << lot.latenceP99 << endl;
+}
+
+//! \brief une matrice des temps de trajet comparée aux requêtes individuelles
+static void comparerMatrice(Simulation &p_simulation)
+{
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+
+    cout << endl;
+    cout << "==========================================" << endl;
+    cout << "        matrice des temps de trajet       " << endl;
+    cout << "==========================================" << endl << endl;
+
+    const size_t nbPoints = 20;
+    vector<Coordonnees> origines;
+    vector<Coordonnees> destinations;
+    vector<pair<Coordonnees, Coordonnees> > pairesMatrice;
+    for (size_t i = 0; i < nbPoints && i < paires.size(); ++i)
+    {
+        origines.push_back(paires[i].first);
+        destinations.push_back(paires[i].second);
+    }
+    for (const auto &o : origines)
+        for (const auto &d : destinations)
+            pairesMatrice.push_back(make_pair(o, d));
+
+    ReseauGTFS::MatriceTempsTrajet matrice = reseau_rtc.matriceTempsTrajet(origines, destinations,
+                                                                          reseau_rtc.getDebutFenetre());
+    ReseauGTFS::ResultatsLot lotMatrice = reseau_rtc.itinerairesEnLot(donnees_rtc, pairesMatrice);
+    if (matrice.temps != lotMatrice.tempsDuTrajet)
+        throw logic_error("main(): la matrice ne donne pas les mêmes temps de trajet que les requêtes individuelles");
+
+    //la même matrice pour un départ 15 minutes plus tard, comparée aux requêtes individuelles partant à cette heure
+    const Heure departMatrice = reseau_rtc.getDebutFenetre().add_secondes(900);
+    ReseauGTFS::MatriceTempsTrajet matricePlusTard = reseau_rtc.matriceTempsTrajet(origines, destinations, departMatrice);
+    for (size_t k = 0; k < pairesMatrice.size(); ++k)
+    {
+        long tempsRecherche;
+        vector<Arret::Ptr> arretsMatrice;
+        ReseauGTFS::Requete requete = reseau_rtc.preparerRequete(pairesMatrice[k].first,
+                                                                 pairesMatrice[k].second, departMatrice);
+        if (matricePlusTard.temps[k] != reseau_rtc.itineraire(donnees_rtc, requete, arretsMatrice, tempsRecherche))
+            throw logic_error("main(): la matrice partant à " + to_string(departMatrice - Heure(0, 0, 0))
+                              + " secondes ne donne pas les mêmes temps de trajet que les requêtes individuelles");
+    }
+    cout << "Matrice " << origines.size() << " x " << destinations.size() << " calculée en " << matrice.tempsTotal
+         << " microsecondes (une recherche par origine)" << endl;
+    cout << "Les mêmes " << pairesMatrice.size() << " requêtes individuelles ont nécessité " << lotMatrice.tempsTotal
+         << " microsecondes" << endl;
+    matrice.ecrireCSV("matriceTempsTrajet.csv");
+}
+
+//! \brief les stations atteignables en 30 minutes à partir du premier point origine
+static void calculerIsochrone(Simulation &p_simulation)
+{
+    const Heure &now1 = p_simulation.depart;
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+    clock_t begin, end;
+
+    cout << endl;
+    cout << "==========================================" << endl;
+    cout << "                isochrone                 " << endl;
+    cout << "==========================================" << endl << endl;
+
+    const unsigned int budget = 1800; //30 minutes
+    begin = clock();
+    std::map<std::string, Heure> isochrone = reseau_rtc.isochrone(paires.at(0).first, now1, budget);
+    end = clock();
+    cout << "À partir de " << paires.at(0).first << " à " << now1 << ", " << isochrone.size() << " stations sur "
+         << donnees_rtc.getNbStations() << " sont atteignables en " << budget / 60 << " minutes" << endl;
+    cout << "Isochrone calculé en " << double(end - begin) / CLOCKS_PER_SEC << " secondes" << endl;
+}
+
+//! \brief le balayage de connexions comparé au graphe; remplit les temps de trajet CSA
+static void comparerCSA(Simulation &p_simulation)
+{
+    const Heure &now1 = p_simulation.depart;
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+    const vector<unsigned int> &tempsDesTrajets = p_simulation.tempsDesTrajets;
+    vector<unsigned int> &tempsCSA = p_simulation.tempsCSA;
+    clock_t begin, end;
+
+    cout << endl;
+    cout << "==========================================" << endl;
+    cout << "   balayage de connexions (CSA) vs graphe " << endl;
+    cout << "==========================================" << endl << endl;
+
+    begin = clock();
+    RouteurCSA routeur_csa(donnees_rtc);
+    end = clock();
+    cout << "Routeur CSA (" << routeur_csa.getNbConnexions() << " connexions) produit en "
+         << double(end - begin) / CLOCKS_PER_SEC << " secondes" << endl;
+    cout << "Mémoire: graphe = " << reseau_rtc.getTailleMemoire() / 1024 << " Ko, CSA = "
+         << routeur_csa.getTailleMemoire() / 1024 << " Ko" << endl;
+
+    ReseauGTFS::ResultatsLot lotSequentiel = reseau_rtc.itinerairesEnLot(donnees_rtc, paires, 1);
+    unsigned int nbIdentiques = 0;
+    unsigned int nbPlusHatifs = 0;
+    begin = clock();
+    tempsCSA.clear();
+    for (const auto &paire : paires)
+        tempsCSA.push_back(routeur_csa.itineraire(paire.first, paire.second, now1));
+    end = clock();
+    for (size_t i = 0; i < paires.size(); ++i)
+    {
+        if (tempsCSA[i] == tempsDesTrajets[i]) ++nbIdentiques;
+        else if (tempsCSA[i] < tempsDesTrajets[i]) ++nbPlusHatifs;
+    }
+    cout << "Temps moyen par requête: graphe = " << (double)lotSequentiel.tempsTotal / paires.size()
+         << " microsecondes, CSA = " << 1e6 * double(end - begin) / CLOCKS_PER_SEC / paires.size()
+         << " microsecondes" << endl;
+    cout << "Temps de trajet identiques: " << nbIdentiques << " / " << paires.size() << " (CSA plus hâtif: "
+         << nbPlusHatifs << ")" << endl;
+}
+
+//! \brief les ensembles de Pareto de RAPTOR, dont l'arrivée la plus hâtive doit être celle de CSA
+static void comparerRAPTOR(Simulation &p_simulation)
+{
+    const Heure &now1 = p_simulation.depart;
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+    const vector<unsigned int> &tempsCSA = p_simulation.tempsCSA;
+    clock_t begin, end;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   RAPTOR: arrivée vs correspondances " << endl;
+    cout << "==========================================" << endl << endl;
+
+    begin = clock();
+    RouteurRAPTOR routeur_raptor(donnees_rtc);
+    end = clock();
+    cout << "Routeur RAPTOR (" << routeur_raptor.getNbParcours() << " parcours) produit en "
+         << double(end - begin) / CLOCKS_PER_SEC << " secondes, mémoire = "
+         << routeur_raptor.getTailleMemoire() / 1024 << " Ko" << endl;
+
+    unsigned int nbCommeCSA = 0;
+    size_t nbSolutions = 0;
+    begin = clock();
+    vector<vector<RouteurRAPTOR::Solution> > solutionsRAPTOR;
+    for (const auto &paire : paires)
+        solutionsRAPTOR.push_back(routeur_raptor.itineraires(paire.first, paire.second, now1));
+    end = clock();
+    for (size_t i = 0; i < paires.size(); ++i)
+    {
+        nbSolutions += solutionsRAPTOR[i].size();
+        unsigned int meilleur = solutionsRAPTOR[i].empty() ? numeric_limits<unsigned int>::max() :
+                                solutionsRAPTOR[i].back().tempsDuTrajet;
+        if (meilleur == tempsCSA[i]) ++nbCommeCSA;
+    }
+    cout << "Temps moyen par requête: RAPTOR = " << 1e6 * double(end - begin) / CLOCKS_PER_SEC / paires.size()
+         << " microsecondes, " << (double)nbSolutions / paires.size() << " solutions de Pareto en moyenne" << endl;
+    cout << "Arrivée la plus hâtive identique à CSA: " << nbCommeCSA << " / " << paires.size() << endl;
+    exigerIdentiques(nbCommeCSA, paires.size(), "RAPTOR contre CSA");
+    if (!solutionsRAPTOR.at(0).empty())
+    {
+        cout << "Compromis de la première requête:" << endl;
+        for (const auto &solution : solutionsRAPTOR.at(0))
+            cout << "  " << solution.nbCorrespondances << " correspondance(s): " << solution.tempsDuTrajet
+                 << " secondes" << endl;
+    }
+}
+
+//! \brief le profil de CSA sur deux heures, comparé à une requête par minute
+static void comparerProfil(Simulation &p_simulation)
+{
+    const Heure &now1 = p_simulation.depart;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+    clock_t begin, end;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   profil sur un intervalle de départ " << endl;
+    cout << "==========================================" << endl << endl;
+
+    const RouteurCSA routeur_csa(p_simulation.donnees);
+
+    const unsigned int dureeIntervalle = 7200;
+    const size_t nbPairesProfil = min<size_t>(10, paires.size());
+    Heure finIntervalle = now1.add_secondes(dureeIntervalle);
+    size_t nbTrajets = 0;
+    unsigned int nbMinutesIdentiques = 0;
+    clock_t tempsProfil = 0;
+    clock_t tempsParMinute = 0;
+    for (size_t i = 0; i < nbPairesProfil; ++i)
+    {
+        unsigned int tempsAPieds;
+        begin = clock();
+        vector<RouteurCSA::Trajet> trajets = routeur_csa.profil(paires[i].first, paires[i].second, now1,
+                                                                finIntervalle, &tempsAPieds);
+        end = clock();
+        tempsProfil += end - begin;
+        nbTrajets += trajets.size();
+
+        const unsigned int debutIntervalle = now1 - Heure(0, 0, 0);
+        for (unsigned int minute = 0; minute <= dureeIntervalle; minute += 60)
+        {
+            begin = clock();
+            unsigned int temps = routeur_csa.itineraire(paires[i].first, paires[i].second, now1.add_secondes(minute));
+            end = clock();
+            tempsParMinute += end - begin;
+
+            //l'arrivée selon le profil: le premier trajet partant à cette minute ou après, ou la marche seule
+            const unsigned int heure = debutIntervalle + minute;
+            unsigned int selonProfil = numeric_limits<unsigned int>::max();
+            for (const auto &trajet : trajets)
+                if (trajet.heureDepart >= heure)
+                {
+                    selonProfil = trajet.heureArrivee - heure;
+                    break;
+                }
+            if (tempsAPieds != numeric_limits<unsigned int>::max()) selonProfil = min(selonProfil, tempsAPieds);
+            if (selonProfil == temps) ++nbMinutesIdentiques;
+        }
+    }
+    const unsigned int nbMinutes = dureeIntervalle / 60 + 1;
+    cout << nbPairesProfil << " paires, départs de " << now1 << " à " << finIntervalle << ": "
+         << (double)nbTrajets / nbPairesProfil << " trajets non dominés par paire en moyenne" << endl;
+    cout << "Temps par paire: profil = " << 1e3 * double(tempsProfil) / CLOCKS_PER_SEC / nbPairesProfil
+         << " ms, une requête par minute (" << nbMinutes << " requêtes) = "
+         << 1e3 * double(tempsParMinute) / CLOCKS_PER_SEC / nbPairesProfil << " ms" << endl;
+    cout << "Minutes où le profil donne le même temps de trajet: " << nbMinutesIdentiques << " / "
+         << nbMinutes * nbPairesProfil << endl;
+    exigerIdentiques(nbMinutesIdentiques, nbMinutes * nbPairesProfil, "profil contre une requête par minute");
+}
+
+//! \brief le graphe de la journée interrogé à une heure tardive, comparé à un graphe construit pour cette heure
+static void comparerHeureDeDepart(Simulation &p_simulation)
+{
+    const std::string &chemin_dossier = p_simulation.cheminDossier;
+    const Date &today = p_simulation.date;
+    const Heure &now1 = p_simulation.depart;
+    const Heure &now2 = p_simulation.finJournee;
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+    clock_t begin, end;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   heure de départ choisie par requête " << endl;
+    cout << "==========================================" << endl << endl;
+
+    //un seul graphe pour toute la journée vs un DonneesGTFS/ReseauGTFS construit pour l'heure de départ
+    Heure heureTardive = now1.add_secondes(3 * 3600);
+    begin = clock();
+    DonneesGTFS donnees_tardives(today, heureTardive, now2);
+    chargerDonnees(donnees_tardives, chemin_dossier);
+    ReseauGTFS reseau_tardif(donnees_tardives);
+    end = clock();
+    cout << "Données et graphe construits pour un départ à " << heureTardive << " en "
+         << double(end - begin) / CLOCKS_PER_SEC << " secondes" << endl;
+
+    const size_t nbPairesTardives = min<size_t>(50, paires.size());
+    unsigned int nbTempsIdentiques = 0;
+    long tempsJournee = 0;
+    for (size_t i = 0; i < nbPairesTardives; ++i)
+    {
+        long tempsRecherche;
+        begin = clock();
+        ReseauGTFS::Requete requete = reseau_rtc.preparerRequete(paires[i].first, paires[i].second,
+                                                                 heureTardive);
+        unsigned int tempsJourneeEntiere = reseau_rtc.itineraire(donnees_rtc, requete, false, tempsRecherche);
+        end = clock();
+        tempsJournee += end - begin;
+        ReseauGTFS::Requete requeteTardive = reseau_tardif.preparerRequete(paires[i].first,
+                                                                           paires[i].second);
+        if (reseau_tardif.itineraire(donnees_tardives, requeteTardive, false, tempsRecherche) == tempsJourneeEntiere)
+            ++nbTempsIdentiques;
+    }
+    cout << "Requêtes partant à " << heureTardive << " sur le graphe de la journée: " << nbTempsIdentiques << " / "
+         << nbPairesTardives << " temps de trajet identiques au graphe construit pour cette heure, "
+         << 1e6 * double(tempsJournee) / CLOCKS_PER_SEC / nbPairesTardives << " microsecondes par requête" << endl;
+    exigerIdentiques(nbTempsIdentiques, nbPairesTardives, "graphe de la journée contre graphe construit pour l'heure");
+}
+
+//! \brief la construction du graphe sur un fil et sur tous les fils
+static void comparerConstructionParallele(Simulation &p_simulation)
+{
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   construction du graphe en parallèle " << endl;
+    cout << "==========================================" << endl << endl;
+
+    //temps réel (clock() additionnerait le temps de tous les fils)
+    auto debutSequentiel = chrono::steady_clock::now();
+    ReseauGTFS reseau_sequentiel(donnees_rtc, 1);
+    auto debutParallele = chrono::steady_clock::now();
+    ReseauGTFS reseau_parallele(donnees_rtc, 0);
+    auto finParallele = chrono::steady_clock::now();
+    cout << "Construction avec 1 fil: " << chrono::duration<double>(debutParallele - debutSequentiel).count()
+         << " secondes, avec " << thread::hardware_concurrency() << " fils: "
+         << chrono::duration<double>(finParallele - debutParallele).count() << " secondes" << endl;
+
+    const size_t nbPairesParallele = min<size_t>(50, paires.size());
+    unsigned int nbIdentiquesParallele = 0;
+    for (size_t i = 0; i < nbPairesParallele; ++i)
+    {
+        long tempsRecherche;
+        ReseauGTFS::Requete requeteSequentielle = reseau_sequentiel.preparerRequete(paires[i].first,
+                                                                                    paires[i].second);
+        ReseauGTFS::Requete requeteParallele = reseau_parallele.preparerRequete(paires[i].first,
+                                                                                paires[i].second);
+        if (reseau_sequentiel.itineraire(donnees_rtc, requeteSequentielle, false, tempsRecherche) ==
+            reseau_parallele.itineraire(donnees_rtc, requeteParallele, false, tempsRecherche))
+            ++nbIdentiquesParallele;
+    }
+    cout << "Nombre d'arcs: " << reseau_sequentiel.getNbArcs() << " (1 fil), " << reseau_parallele.getNbArcs()
+         << " (" << thread::hardware_concurrency() << " fils); " << nbIdentiquesParallele << " / " << nbPairesParallele
+         << " temps de trajet identiques" << endl;
+    if (reseau_sequentiel.getNbArcs() != reseau_parallele.getNbArcs())
+        throw logic_error("main(): la construction en parallèle ne donne pas le même nombre d'arcs");
+    exigerIdentiques(nbIdentiquesParallele, nbPairesParallele, "construction sur un fil contre plusieurs fils");
+}
+
+//! \brief le réseau écrit dans un fichier puis projeté en mémoire
+static void comparerReseauProjete(Simulation &p_simulation)
+{
+    const Heure &now1 = p_simulation.depart;
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+    clock_t begin, end;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   réseau écrit puis projeté en mémoire " << endl;
+    cout << "==========================================" << endl << endl;
+
+    const string fichierReseau = "reseau_rtc.bin";
+    begin = clock();
+    reseau_rtc.ecrireBinaire(donnees_rtc, fichierReseau);
+    end = clock();
+    cout << "Réseau écrit dans " << fichierReseau << " en " << double(end - begin) / CLOCKS_PER_SEC << " secondes" << endl;
+    auto debutOuverture = chrono::steady_clock::now();
+    ReseauProjete reseau_projete(fichierReseau);
+    auto finOuverture = chrono::steady_clock::now();
+    cout << "Réseau projeté en mémoire en "
+         << chrono::duration<double, micro>(finOuverture - debutOuverture).count() << " microsecondes: "
+         << reseau_projete.getNbSommets() << " sommets, " << reseau_projete.getNbArcs() << " arcs, "
+         << reseau_projete.getTailleFichier() << " octets" << endl;
+
+    const size_t nbPairesProjete = min<size_t>(50, paires.size());
+    unsigned int nbIdentiquesProjete = 0;
+    long tempsProjete = 0;
+    for (size_t i = 0; i < nbPairesProjete; ++i)
+    {
+        long tempsRecherche;
+        ReseauGTFS::Requete requete = reseau_rtc.preparerRequete(paires[i].first, paires[i].second);
+        unsigned int temps = reseau_rtc.itineraire(donnees_rtc, requete, false, tempsRecherche);
+        if (reseau_projete.itineraire(paires[i].first, paires[i].second, now1, false, tempsRecherche) == temps)
+            ++nbIdentiquesProjete;
+        tempsProjete += tempsRecherche;
+    }
+    cout << nbPairesProjete << " requêtes sur le réseau projeté: " << nbIdentiquesProjete
+         << " temps de trajet identiques, " << double(tempsProjete) / nbPairesProjete
+         << " microsecondes par requête (arcs du point origine et destination compris)" << endl;
+    exigerIdentiques(nbIdentiquesProjete, nbPairesProjete, "réseau projeté contre ReseauGTFS");
+}
+
+//! \brief les mêmes requêtes avant et après la renumérotation des sommets
+static void comparerRenumerotation(Simulation &p_simulation)
+{
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+    clock_t begin, end;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   renumérotation des sommets " << endl;
+    cout << "==========================================" << endl << endl;
+
+    //les mêmes requêtes avant et après: les sommets d'une station sont ensuite contigus, par heure d'arrivée
+    const size_t nbPairesRenumerotation = min<size_t>(200, paires.size());
+    vector<unsigned int> tempsAvantRenumerotation;
+    long tempsRecherchesAvant = 0;
+    for (size_t i = 0; i < nbPairesRenumerotation; ++i)
+    {
+        long tempsRecherche;
+        ReseauGTFS::Requete requete = reseau_rtc.preparerRequete(paires[i].first, paires[i].second);
+        tempsAvantRenumerotation.push_back(reseau_rtc.itineraire(donnees_rtc, requete, false, tempsRecherche));
+        tempsRecherchesAvant += tempsRecherche;
+    }
+
+    begin = clock();
+    reseau_rtc.renumeroterSommets();
+    end = clock();
+    cout << "Sommets renumérotés en " << double(end - begin) / CLOCKS_PER_SEC << " secondes" << endl;
+
+    unsigned int nbIdentiquesRenumerotation = 0;
+    long tempsRecherchesApres = 0;
+    for (size_t i = 0; i < nbPairesRenumerotation; ++i)
+    {
+        long tempsRecherche;
+        ReseauGTFS::Requete requete = reseau_rtc.preparerRequete(paires[i].first, paires[i].second);
+        if (reseau_rtc.itineraire(donnees_rtc, requete, false, tempsRecherche) == tempsAvantRenumerotation[i])
+            ++nbIdentiquesRenumerotation;
+        tempsRecherchesApres += tempsRecherche;
+    }
+    cout << nbPairesRenumerotation << " requêtes: avant = " << double(tempsRecherchesAvant) / nbPairesRenumerotation
+         << " microsecondes, après = " << double(tempsRecherchesApres) / nbPairesRenumerotation << " microsecondes, "
+         << nbIdentiquesRenumerotation << " temps de trajet identiques" << endl;
+    exigerIdentiques(nbIdentiquesRenumerotation, nbPairesRenumerotation, "avant contre après la renumérotation");
+}
+
+//! \brief les mêmes requêtes sur chaque encodage compact des arcs
+static void comparerGrapheCompact(Simulation &p_simulation)
+{
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+    clock_t begin, end;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   encodage compact des arcs " << endl;
+    cout << "==========================================" << endl << endl;
+
+    //les mêmes requêtes pour chaque représentation; la meilleure de trois passes est retenue
+    const size_t nbPairesCompact = min<size_t>(200, paires.size());
+    vector<ReseauGTFS::Requete> requetesCompact;
+    for (size_t i = 0; i < nbPairesCompact; ++i)
+        requetesCompact.push_back(reseau_rtc.preparerRequete(paires[i].first, paires[i].second));
+    vector<unsigned int> tempsListes;
+    const vector<pair<string, GrapheCompact::Encodage> > encodages = {
+            {"Entiers32", GrapheCompact::Encodage::Entiers32},
+            {"Poids16", GrapheCompact::Encodage::Poids16},
+            {"Delta", GrapheCompact::Encodage::Delta}};
+    for (size_t k = 0; k <= encodages.size(); ++k)
+    {
+        string nom = "listes";
+        if (k > 0)
+        {
+            nom = encodages[k - 1].first;
+            begin = clock();
+            reseau_rtc.compacterGraphe(encodages[k - 1].second);
+            end = clock();
+            nom += " (construit en " + to_string(double(end - begin) / CLOCKS_PER_SEC) + " s)";
+        }
+        long meilleurePasse = numeric_limits<long>::max();
+        unsigned int nbIdentiquesCompact = 0;
+        for (int passe = 0; passe < 3; ++passe)
+        {
+            long tempsPasse = 0;
+            for (size_t i = 0; i < nbPairesCompact; ++i)
+            {
+                long tempsRecherche;
+                unsigned int temps = reseau_rtc.itineraire(donnees_rtc, requetesCompact[i], false, tempsRecherche);
+                tempsPasse += tempsRecherche;
+                if (k == 0 && passe == 0) tempsListes.push_back(temps);
+                if (passe == 0 && temps == tempsListes[i]) ++nbIdentiquesCompact;
+            }
+            meilleurePasse = min(meilleurePasse, tempsPasse);
+        }
+        cout << nom << ": " << double(reseau_rtc.getTailleMemoireGraphe()) / reseau_rtc.getNbArcs() << " octets par arc, "
+             << double(meilleurePasse) / nbPairesCompact << " microsecondes par requête, " << nbIdentiquesCompact
+             << " / " << nbPairesCompact << " temps de trajet identiques" << endl;
+        exigerIdentiques(nbIdentiquesCompact, nbPairesCompact, k == 0 ? "listes" : "encodage " + encodages[k - 1].first);
+    }
+    reseau_rtc.abandonnerGrapheCompact();
+}
+
+//! \brief les mêmes requêtes avant et après l'élagage des arcs dominés
+static void comparerElagage(Simulation &p_simulation)
+{
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+    clock_t begin, end;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   élagage des arcs dominés " << endl;
+    cout << "==========================================" << endl << endl;
+
+    const size_t nbPairesElagage = min<size_t>(200, paires.size());
+    vector<ReseauGTFS::Requete> requetesElagage;
+    for (size_t i = 0; i < nbPairesElagage; ++i)
+        requetesElagage.push_back(reseau_rtc.preparerRequete(paires[i].first, paires[i].second));
+    //meilleure de trois passes sur les mêmes requêtes
+    auto mesurerRequetes = [&](vector<unsigned int> &p_temps)
+    {
+        long meilleurePasse = numeric_limits<long>::max();
+        for (int passe = 0; passe < 3; ++passe)
+        {
+            long tempsPasse = 0;
+            p_temps.clear();
+            for (const auto &requete : requetesElagage)
+            {
+                long tempsRecherche;
+                p_temps.push_back(reseau_rtc.itineraire(donnees_rtc, requete, false, tempsRecherche));
+                tempsPasse += tempsRecherche;
+            }
+            meilleurePasse = min(meilleurePasse, tempsPasse);
+        }
+        return double(meilleurePasse) / nbPairesElagage;
+    };
+    vector<unsigned int> tempsAvantElagage;
+    vector<unsigned int> tempsApresElagage;
+    const size_t nbArcsAvantElagage = reseau_rtc.getNbArcs();
+    double latenceAvantElagage = mesurerRequetes(tempsAvantElagage);
+
+    begin = clock();
+    size_t nbArcsEnleves = reseau_rtc.elaguerArcsDomines();
+    end = clock();
+    cout << "Élagage en " << double(end - begin) / CLOCKS_PER_SEC << " secondes: " << nbArcsEnleves << " arcs enlevés sur "
+         << nbArcsAvantElagage << " (" << 100.0 * nbArcsEnleves / nbArcsAvantElagage << " %)" << endl;
+
+    double latenceApresElagage = mesurerRequetes(tempsApresElagage);
+    unsigned int nbIdentiquesElagage = 0;
+    for (size_t i = 0; i < nbPairesElagage; ++i)
+        if (tempsApresElagage[i] == tempsAvantElagage[i]) ++nbIdentiquesElagage;
+    cout << nbPairesElagage << " requêtes: avant = " << latenceAvantElagage << " microsecondes, après = "
+         << latenceApresElagage << " microsecondes (accélération " << latenceAvantElagage / latenceApresElagage << "), "
+         << nbIdentiquesElagage << " temps de trajet identiques" << endl;
+    exigerIdentiques(nbIdentiquesElagage, nbPairesElagage, "avant contre après l'élagage");
+}
+
+//! \brief la grille des stations comparée à un parcours de toutes les stations
+static void comparerIndexStations(Simulation &p_simulation)
+{
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const auto &stations = p_simulation.donnees.getStations();
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+    clock_t begin, end;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   index spatial des stations " << endl;
+    cout << "==========================================" << endl << endl;
+
+    begin = clock();
+    IndexStations indexStations(stations, reseau_rtc.getDistMaxMarche() / 2);
+    end = clock();
+    cout << "Grille de " << indexStations.getNbCellules() << " cellules sur " << indexStations.getNbStations()
+         << " stations construite en " << double(end - begin) / CLOCKS_PER_SEC << " secondes ("
+         << indexStations.getTailleMemoire() << " octets)" << endl;
+
+    //les points origine et destination des requêtes: parcours de toutes les stations contre la grille
+    vector<Coordonnees> pointsIndex;
+    for (const auto &paire : paires)
+    {
+        pointsIndex.push_back(paire.first);
+        pointsIndex.push_back(paire.second);
+    }
+    size_t nbTrouvesParcours = 0;
+    auto debutParcours = chrono::steady_clock::now();
+    for (const auto &point : pointsIndex)
+        for (const auto &station : stations)
+            if (point - station.second.getCoords() <= reseau_rtc.getDistMaxMarche()) ++nbTrouvesParcours;
+    auto finParcours = chrono::steady_clock::now();
+    size_t nbTrouvesIndex = 0;
+    auto debutIndex = chrono::steady_clock::now();
+    for (const auto &point : pointsIndex)
+        nbTrouvesIndex += indexStations.dansRayon(point, reseau_rtc.getDistMaxMarche()).size();
+    auto finIndex = chrono::steady_clock::now();
+    double microsParcours = chrono::duration<double, micro>(finParcours - debutParcours).count() / pointsIndex.size();
+    double microsIndex = chrono::duration<double, micro>(finIndex - debutIndex).count() / pointsIndex.size();
+    cout << pointsIndex.size() << " recherches dans un rayon de " << reseau_rtc.getDistMaxMarche() << " km: parcours = "
+         << microsParcours << " microsecondes, grille = " << microsIndex << " microsecondes (accélération "
+         << microsParcours / microsIndex << "); " << nbTrouvesParcours << " et " << nbTrouvesIndex
+         << " stations trouvées" << endl;
+    exigerIdentiques(nbTrouvesIndex, nbTrouvesParcours, "stations dans un rayon, grille contre parcours");
+
+    //les 5 stations les plus proches, comparées à un tri de toutes les stations
+    const size_t kPlusProches = 5;
+    unsigned int nbIdentiquesPlusProches = 0;
+    for (const auto &point : pointsIndex)
+    {
+        vector<pair<double, string> > toutes;
+        for (const auto &station : stations)
+        {
+            double distance = point - station.second.getCoords();
+            toutes.push_back({std::isnan(distance) ? 0 : distance, station.first});
+        }
+        stable_sort(toutes.begin(), toutes.end(), [](const pair<double, string> &a, const pair<double, string> &b)
+        {
+            return a.first < b.first;
+        });
+        vector<IndexStations::Voisin> voisins = indexStations.plusProches(point, kPlusProches);
+        bool identiques = voisins.size() == kPlusProches;
+        for (size_t k = 0; identiques && k < kPlusProches; ++k)
+            identiques = voisins[k].station->first == toutes[k].second;
+        if (identiques) ++nbIdentiquesPlusProches;
+    }
+    cout << pointsIndex.size() << " recherches des " << kPlusProches << " stations les plus proches: "
+         << nbIdentiquesPlusProches << " identiques à un tri de toutes les stations" << endl;
+    exigerIdentiques(nbIdentiquesPlusProches, pointsIndex.size(), "stations les plus proches, grille contre tri");
+}
+
+//! \brief les transferts à pied générés et leur effet sur les temps de trajet
+static void comparerTransfertsAPied(Simulation &p_simulation)
+{
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+    clock_t begin, end;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   transferts à pied générés " << endl;
+    cout << "==========================================" << endl << endl;
+
+    const double rayonPietons = 0.4; //en km
+    Transferts transfertsAPied;
+    for (bool fermeture : {false, true})
+    {
+        for (unsigned int nbFilsPietons : {1u, thread::hardware_concurrency()})
+        {
+            auto debutPietons = chrono::steady_clock::now();
+            transfertsAPied = genererTransfertsAPied(donnees_rtc, rayonPietons, vitesseDeMarche, fermeture, nbFilsPietons);
+            auto finPietons = chrono::steady_clock::now();
+            cout << transfertsAPied.size() << " transferts à pied générés à moins de " << rayonPietons << " km"
+                 << (fermeture ? " (fermeture transitive)" : "") << " avec " << nbFilsPietons << " fil(s) en "
+                 << chrono::duration<double, milli>(finPietons - debutPietons).count() << " millisecondes" << endl;
+        }
+    }
+    cout << "(" << donnees_rtc.getTransferts().size() << " transferts dans transfers.txt)" << endl;
+
+    //réseau avec les transferts à pied de la fermeture transitive (la dernière génération ci-dessus)
+    begin = clock();
+    ReseauGTFS reseau_pietons(donnees_rtc, 1, transfertsAPied);
+    end = clock();
+    cout << "Réseau avec transferts à pied construit en " << double(end - begin) / CLOCKS_PER_SEC << " secondes: "
+         << reseau_pietons.getNbArcs() << " arcs, ";
+    reseau_pietons.elaguerArcsDomines(); //comme reseau_rtc
+    cout << reseau_pietons.getNbArcs() << " après élagage (contre " << reseau_rtc.getNbArcs() << ")" << endl;
+
+    const size_t nbPairesPietons = min<size_t>(200, paires.size());
+    unsigned int nbPlusCourts = 0;
+    unsigned int nbEgaux = 0;
+    unsigned int nbPlusLongs = 0;
+    long tempsSansPietons = 0;
+    long tempsAvecPietons = 0;
+    double gainTotal = 0;
+    for (size_t i = 0; i < nbPairesPietons; ++i)
+    {
+        long tempsRecherche;
+        ReseauGTFS::Requete requete = reseau_rtc.preparerRequete(paires[i].first, paires[i].second);
+        unsigned int sans = reseau_rtc.itineraire(donnees_rtc, requete, false, tempsRecherche);
+        tempsSansPietons += tempsRecherche;
+        requete = reseau_pietons.preparerRequete(paires[i].first, paires[i].second);
+        unsigned int avec = reseau_pietons.itineraire(donnees_rtc, requete, false, tempsRecherche);
+        tempsAvecPietons += tempsRecherche;
+        if (avec < sans)
+        {
+            ++nbPlusCourts;
+            if (sans != numeric_limits<unsigned int>::max()) gainTotal += sans - avec;
+        }
+        else if (avec == sans) ++nbEgaux;
+        else ++nbPlusLongs;
+    }
+    cout << nbPairesPietons << " requêtes: " << nbPlusCourts << " trajets plus courts (gain moyen de "
+         << (nbPlusCourts ? gainTotal / nbPlusCourts : 0) << " secondes), " << nbEgaux << " égaux, " << nbPlusLongs
+         << " plus longs; recherche = " << double(tempsSansPietons) / nbPairesPietons << " microsecondes sans, "
+         << double(tempsAvecPietons) / nbPairesPietons << " microsecondes avec" << endl;
+}
+
+//! \brief les itinéraires alternatifs par pénalités
+static void calculerItinerairesAlternatifs(Simulation &p_simulation)
+{
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   itinéraires alternatifs " << endl;
+    cout << "==========================================" << endl << endl;
+
+    //un exemple affiché, puis la latence moyenne pour k = 1 (recherche simple), 3 et 5
+    {
+        long tempsRecherche;
+        ReseauGTFS::Requete requete = reseau_rtc.preparerRequete(paires[0].first, paires[0].second);
+        reseau_rtc.itinerairesAlternatifs(donnees_rtc, requete, 3, true, tempsRecherche);
+        cout << endl;
+    }
+    const size_t nbPairesAlternatives = min<size_t>(100, paires.size());
+    vector<ReseauGTFS::Requete> requetesAlternatives;
+    for (size_t i = 0; i < nbPairesAlternatives; ++i)
+        requetesAlternatives.push_back(reseau_rtc.preparerRequete(paires[i].first, paires[i].second));
+    for (size_t k : {1, 3, 5})
+    {
+        long tempsTotal = 0;
+        size_t nbItineraires = 0;
+        double etirementTotal = 0;
+        for (const auto &requete : requetesAlternatives)
+        {
+            long tempsRecherche;
+            vector<unsigned int> durees = reseau_rtc.itinerairesAlternatifs(donnees_rtc, requete, k, false, tempsRecherche);
+            tempsTotal += tempsRecherche;
+            nbItineraires += durees.size();
+            for (unsigned int duree : durees)
+                if (durees[0] > 0) etirementTotal += double(duree) / durees[0];
+        }
+        cout << "k = " << k << ": " << double(tempsTotal) / nbPairesAlternatives << " microsecondes par requête, "
+             << double(nbItineraires) / nbPairesAlternatives << " itinéraires par requête, durée moyenne de "
+             << (nbItineraires ? etirementTotal / nbItineraires : 0) << " fois celle du meilleur" << endl;
+    }
+}
+
+//! \brief le routeur multicritère comparé à Dijkstra
+static void comparerMultiCriteres(Simulation &p_simulation)
+{
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+    clock_t begin, end;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   recherche multicritère " << endl;
+    cout << "==========================================" << endl << endl;
+
+    begin = clock();
+    RouteurMultiCriteres routeurMulti(donnees_rtc, reseau_rtc);
+    end = clock();
+    cout << "Routeur multicritère construit en " << double(end - begin) / CLOCKS_PER_SEC << " secondes: "
+         << routeurMulti.getNbArcs() << " arcs, " << routeurMulti.getTailleMemoire() << " octets" << endl;
+
+    //un ensemble de Pareto affiché, puis la latence moyenne de chaque recherche
+    {
+        long tempsRecherche;
+        vector<RouteurMultiCriteres::Criteres> ensemble = routeurMulti.pareto(paires[0].first, paires[0].second,
+                                                                              donnees_rtc.getTempsDebut(), tempsRecherche);
+        cout << "Ensemble de Pareto de la première paire (" << tempsRecherche << " microsecondes):" << endl;
+        for (const auto &criteres : ensemble)
+            cout << "   durée = " << criteres.duree << " s, correspondances = " << criteres.nbTransferts
+                 << ", marche = " << criteres.marche << " m" << endl;
+    }
+    const size_t nbPairesMulti = min<size_t>(100, paires.size());
+    long tempsUnCritere = 0;
+    long tempsPareto = 0;
+    long tempsPondere = 0;
+    size_t tailleParetoTotale = 0;
+    unsigned int nbDureesEgales = 0;
+    unsigned int nbPonderesEgaux = 0;
+    unsigned int nbMoinsDeCorrespondances = 0;
+    for (size_t i = 0; i < nbPairesMulti; ++i)
+    {
+        long tempsRecherche;
+        ReseauGTFS::Requete requete = reseau_rtc.preparerRequete(paires[i].first, paires[i].second);
+        unsigned int duree = reseau_rtc.itineraire(donnees_rtc, requete, false, tempsRecherche);
+        tempsUnCritere += tempsRecherche;
+
+        vector<RouteurMultiCriteres::Criteres> ensemble = routeurMulti.pareto(paires[i].first, paires[i].second,
+                                                                              donnees_rtc.getTempsDebut(), tempsRecherche);
+        tempsPareto += tempsRecherche;
+        tailleParetoTotale += ensemble.size();
+        unsigned int dureeMin = numeric_limits<unsigned int>::max();
+        for (const auto &criteres : ensemble) dureeMin = min(dureeMin, criteres.duree);
+        if (dureeMin == duree) ++nbDureesEgales;
+
+        RouteurMultiCriteres::Criteres rapide = routeurMulti.pondere(paires[i].first, paires[i].second,
+                                                                     donnees_rtc.getTempsDebut(), 0, 0, tempsRecherche);
+        if (rapide.duree == duree) ++nbPonderesEgaux;
+        RouteurMultiCriteres::Criteres confortable = routeurMulti.pondere(paires[i].first, paires[i].second,
+                                                                          donnees_rtc.getTempsDebut(), 600, 300,
+                                                                          tempsRecherche);
+        tempsPondere += tempsRecherche;
+        if (confortable.duree != numeric_limits<unsigned int>::max() && confortable.nbTransferts < rapide.nbTransferts)
+            ++nbMoinsDeCorrespondances;
+    }
+    cout << nbPairesMulti << " requêtes: un critère = " << double(tempsUnCritere) / nbPairesMulti
+         << " microsecondes, Pareto = " << double(tempsPareto) / nbPairesMulti << " microsecondes ("
+         << double(tailleParetoTotale) / nbPairesMulti << " trajets par ensemble), pondéré = "
+         << double(tempsPondere) / nbPairesMulti << " microsecondes" << endl;
+    cout << "Durée minimale de Pareto égale à Dijkstra: " << nbDureesEgales << "/" << nbPairesMulti
+         << "; pondéré sans pénalités égal à Dijkstra: " << nbPonderesEgaux << "/" << nbPairesMulti
+         << "; 600 s par correspondance et 300 s par km de marche: " << nbMoinsDeCorrespondances
+         << " trajets avec moins de correspondances" << endl;
+    exigerIdentiques(nbDureesEgales, nbPairesMulti, "durée minimale de Pareto contre Dijkstra");
+    exigerIdentiques(nbPonderesEgaux, nbPairesMulti, "pondéré sans pénalités contre Dijkstra");
+}
+
+//! \brief un réseau avancé par pas de 5 minutes comparé aux réseaux reconstruits
+static void comparerFenetreGlissante(Simulation &p_simulation)
+{
+    const std::string &chemin_dossier = p_simulation.cheminDossier;
+    const Date &today = p_simulation.date;
+    const Heure &now1 = p_simulation.depart;
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   fenêtre glissante " << endl;
+    cout << "==========================================" << endl << endl;
+
+    //un réseau pour l'heure qui vient, avancé de 5 minutes à la fois dans donnees_rtc (lu une seule fois)
+    const unsigned int dureeFenetre = 3600;
+    const unsigned int pasFenetre = 300;
+    const unsigned int nbPasFenetre = 12;
+    auto debutFenetre = chrono::steady_clock::now();
+    ReseauGTFS reseau_fenetre(donnees_rtc, now1, now1.add_secondes(dureeFenetre));
+    auto finFenetre = chrono::steady_clock::now();
+    cout << "Réseau de la fenêtre [" << reseau_fenetre.getDebutFenetre() << ", " << reseau_fenetre.getFinFenetre()
+         << ") construit en " << chrono::duration<double, milli>(finFenetre - debutFenetre).count()
+         << " millisecondes: " << reseau_fenetre.getNbArcs() << " arcs" << endl;
+
+    RouteurMultiCriteres routeurFenetre(donnees_rtc, reseau_fenetre); //copie du graphe, périmée dès la première avance
+    double millisAvances = 0;
+    for (unsigned int k = 0; k < nbPasFenetre; ++k)
+    {
+        auto debutAvance = chrono::steady_clock::now();
+        reseau_fenetre.avancerFenetre(donnees_rtc, pasFenetre);
+        auto finAvance = chrono::steady_clock::now();
+        millisAvances += chrono::duration<double, milli>(finAvance - debutAvance).count();
+    }
+
+    //les deux façons de reconstruire le réseau pour la fenêtre atteinte: à partir des fichiers, ou de donnees_rtc
+    const Heure debutAtteint = reseau_fenetre.getDebutFenetre();
+    const Heure finAtteinte = reseau_fenetre.getFinFenetre();
+    auto debutFichiers = chrono::steady_clock::now();
+    DonneesGTFS donnees_fenetre(today, debutAtteint, finAtteinte);
+    chargerDonnees(donnees_fenetre, chemin_dossier);
+    ReseauGTFS reseau_fichiers(donnees_fenetre);
+    auto finFichiers = chrono::steady_clock::now();
+    ReseauGTFS reseau_reconstruit(donnees_rtc, debutAtteint, finAtteinte);
+    auto finReconstruit = chrono::steady_clock::now();
+    cout << nbPasFenetre << " avances de " << pasFenetre << " secondes jusqu'à [" << debutAtteint << ", " << finAtteinte
+         << "): " << millisAvances / nbPasFenetre << " millisecondes par avance, contre "
+         << chrono::duration<double, milli>(finFichiers - debutFichiers).count()
+         << " millisecondes pour tout reconstruire à partir des fichiers et "
+         << chrono::duration<double, milli>(finReconstruit - finFichiers).count()
+         << " millisecondes pour reconstruire le graphe seul" << endl;
+
+    const size_t nbPairesFenetre = min<size_t>(100, paires.size());
+    unsigned int nbFenetresIdentiques = 0;
+    for (size_t i = 0; i < nbPairesFenetre; ++i)
+    {
+        long tempsRecherche;
+        ReseauGTFS::Requete requete = reseau_fenetre.preparerRequete(paires[i].first, paires[i].second);
+        unsigned int avance = reseau_fenetre.itineraire(donnees_rtc, requete, false, tempsRecherche);
+        requete = reseau_fichiers.preparerRequete(paires[i].first, paires[i].second);
+        if (avance == reseau_fichiers.itineraire(donnees_fenetre, requete, false, tempsRecherche)) ++nbFenetresIdentiques;
+    }
+    cout << "Arcs: " << reseau_fenetre.getNbArcs() << " après les avances, " << reseau_fichiers.getNbArcs()
+         << " reconstruits; " << nbFenetresIdentiques << "/" << nbPairesFenetre << " temps de trajet identiques" << endl;
+    exigerIdentiques(nbFenetresIdentiques, nbPairesFenetre, "fenêtre avancée contre réseau reconstruit");
+    bool routeurPerime = false;
+    try
+    {
+        long tempsRecherche;
+        routeurFenetre.pondere(paires[0].first, paires[0].second, debutAtteint, 0, 0, tempsRecherche);
+    }
+    catch (const logic_error &)
+    {
+        routeurPerime = true;
+    }
+    if (!routeurPerime)
+        throw logic_error("main(): le routeur multicritère n'a pas détecté les avances de la fenêtre");
+    cout << "Routeur multicritère construit avant les avances: refusé (génération " << reseau_fenetre.getGeneration()
+         << ")" << endl;
+
+    //une hiérarchie de contraction construite avant les avances est reconstruite à chaque avance, alors que des sommets
+    //libérés n'ont pas encore été réutilisés; on avance ainsi jusqu'à la fin de la journée, bien après le dernier service
+    ReseauGTFS reseau_hierarchieFenetre(donnees_rtc, now1, now1.add_secondes(dureeFenetre));
+    reseau_hierarchieFenetre.construireHierarchieContraction();
+    const size_t nbPairesHierarchieFenetre = min<size_t>(20, paires.size());
+    auto comparerAvecReconstruit = [&]()
+    {
+        ReseauGTFS reconstruit(donnees_rtc, reseau_hierarchieFenetre.getDebutFenetre(),
+                               reseau_hierarchieFenetre.getFinFenetre());
+        unsigned int nbIdentiques = 0;
+        for (size_t i = 0; i < nbPairesHierarchieFenetre; ++i)
+        {
+            long tempsRecherche;
+            ReseauGTFS::Requete requete = reseau_hierarchieFenetre.preparerRequete(paires[i].first,
+                                                                                   paires[i].second);
+            unsigned int avecHierarchie = reseau_hierarchieFenetre.itineraire(donnees_rtc, requete, false, tempsRecherche);
+            requete = reconstruit.preparerRequete(paires[i].first, paires[i].second);
+            if (avecHierarchie == reconstruit.itineraire(donnees_rtc, requete, false, tempsRecherche)) ++nbIdentiques;
+        }
+        return nbIdentiques;
+    };
+    reseau_hierarchieFenetre.avancerFenetre(donnees_rtc, dureeFenetre);
+    const unsigned int nbIdentiquesPremiereAvance = comparerAvecReconstruit();
+    unsigned int nbAvancesHierarchie = 1;
+    while (!(reseau_hierarchieFenetre.getFinFenetre().add_secondes(dureeFenetre) > donnees_rtc.getTempsFin()))
+    {
+        reseau_hierarchieFenetre.avancerFenetre(donnees_rtc, dureeFenetre);
+        ++nbAvancesHierarchie;
+    }
+    const unsigned int nbIdentiquesDerniereAvance = comparerAvecReconstruit();
+    cout << "Avec la hiérarchie de contraction: " << nbAvancesHierarchie << " avances de " << dureeFenetre
+         << " secondes jusqu'à [" << reseau_hierarchieFenetre.getDebutFenetre() << ", "
+         << reseau_hierarchieFenetre.getFinFenetre() << "); temps de trajet identiques au réseau reconstruit: "
+         << nbIdentiquesPremiereAvance << "/" << nbPairesHierarchieFenetre << " après la première avance, "
+         << nbIdentiquesDerniereAvance << "/" << nbPairesHierarchieFenetre << " après la dernière" << endl;
+    exigerIdentiques(nbIdentiquesPremiereAvance, nbPairesHierarchieFenetre,
+                     "hiérarchie de contraction après la première avance");
+    exigerIdentiques(nbIdentiquesDerniereAvance, nbPairesHierarchieFenetre,
+                     "hiérarchie de contraction après la dernière avance");
+}
+
+//! \brief le cache de résultats sur des requêtes répétées
+static void comparerCache(Simulation &p_simulation)
+{
+    const Heure &now1 = p_simulation.depart;
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    std::default_random_engine &generator = p_simulation.generateur;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   cache de résultats " << endl;
+    cout << "==========================================" << endl << endl;
+
+    //des requêtes répétées: quelques paires populaires, des départs dans les 5 minutes qui suivent now1
+    const size_t nbPairesCache = min<size_t>(40, paires.size());
+    const unsigned int nbRequetesCache = 1000;
+    std::geometric_distribution<unsigned int> distributionPaires(0.1);
+    std::uniform_int_distribution<unsigned int> distributionDeparts(0, 299);
+    vector<pair<size_t, Heure> > requetesCache;
+    for (unsigned int k = 0; k < nbRequetesCache; ++k)
+        requetesCache.push_back(make_pair(distributionPaires(generator) % nbPairesCache,
+                                          now1.add_secondes(distributionDeparts(generator))));
+
+    CacheItineraires cache(donnees_rtc, reseau_rtc, 1 << 20);
+    auto debutSansCache = chrono::steady_clock::now();
+    vector<unsigned int> tempsSansCache;
+    for (const auto &requete : requetesCache)
+    {
+        long tempsRecherche;
+        const pair<Coordonnees, Coordonnees> &paire = paires[requete.first];
+        tempsSansCache.push_back(reseau_rtc.itineraire(
+                donnees_rtc, reseau_rtc.preparerRequete(paire.first, paire.second, requete.second), false,
+                tempsRecherche));
+    }
+    auto debutAvecCache = chrono::steady_clock::now();
+    vector<unsigned int> tempsAvecCache;
+    for (const auto &requete : requetesCache)
+        tempsAvecCache.push_back(cache.itineraire(paires[requete.first].first, paires[requete.first].second,
+                                                  requete.second).tempsDuTrajet);
+    auto finAvecCache = chrono::steady_clock::now();
+
+    //un résultat mémorisé est celui de la requête partant au début de sa minute, qui peut attraper un départ manqué
+    //par la requête exacte
+    unsigned int nbCommeRepresentative = 0;
+    unsigned int nbAtteignables = 0;
+    double avanceTotale = 0;
+    for (size_t k = 0; k < requetesCache.size(); ++k)
+    {
+        long tempsRecherche;
+        const pair<Coordonnees, Coordonnees> &paire = paires[requetesCache[k].first];
+        const unsigned int secondes = requetesCache[k].second - now1;
+        Heure debutMinute = now1.add_secondes(secondes - secondes % 60);
+        if (tempsAvecCache[k] == reseau_rtc.itineraire(donnees_rtc, reseau_rtc.preparerRequete(
+                paire.first, paire.second, debutMinute), false, tempsRecherche))
+            ++nbCommeRepresentative;
+        if (tempsAvecCache[k] != numeric_limits<unsigned int>::max()
+            && tempsSansCache[k] != numeric_limits<unsigned int>::max())
+        {
+            avanceTotale += double(tempsSansCache[k]) + secondes % 60 - double(tempsAvecCache[k]);
+            ++nbAtteignables;
+        }
+    }
+    cout << nbRequetesCache << " requêtes sur " << nbPairesCache << " paires: " << cache.getNbSucces() << " succès, "
+         << cache.getNbEchecs() << " échecs, " << cache.getNbEntrees() << " entrées (" << cache.getTailleMemoire()
+         << " octets)" << endl;
+    cout << "Temps moyen par requête: sans cache = "
+         << chrono::duration<double, micro>(debutAvecCache - debutSansCache).count() / nbRequetesCache
+         << " microsecondes, avec cache = "
+         << chrono::duration<double, micro>(finAvecCache - debutAvecCache).count() / nbRequetesCache
+         << " microsecondes" << endl;
+    cout << "Identiques à la requête du début de la minute: " << nbCommeRepresentative << "/" << nbRequetesCache
+         << "; arrivée en moyenne " << avanceTotale / max(nbAtteignables, 1u)
+         << " secondes plus tôt que celle de la requête exacte" << endl;
+    exigerIdentiques(nbCommeRepresentative, nbRequetesCache, "cache contre requête du début de la minute");
+
+    //un point exactement sur une station (c'est le point de la requête représentative du cache): la station est à
+    //distance 0, sans marche, même si Coordonnees::operator- donne NaN pour des points confondus
+    const Station *stationConfondue = nullptr;
+    for (const auto &station : donnees_rtc.getStations())
+    {
+        auto prochain = station.second.getArrets().lower_bound(now1);
+        if (prochain != station.second.getArrets().end() && prochain->first < now1.add_secondes(600))
+        {
+            stationConfondue = &station.second;
+            break;
+        }
+    }
+    if (stationConfondue)
+    {
+        const Coordonnees surStation = stationConfondue->getCoords();
+        const unsigned int attente = stationConfondue->getArrets().lower_bound(now1)->first - now1;
+        ReseauGTFS::Requete requeteSurStation = reseau_rtc.preparerRequete(surStation, paires[0].second, now1);
+        ReseauGTFS::Requete requeteVersStation = reseau_rtc.preparerRequete(paires[0].first, surStation, now1);
+        const bool departTrouve = any_of(requeteSurStation.arcs.depuisOrigine.begin(),
+                                         requeteSurStation.arcs.depuisOrigine.end(),
+                                         [&](const pair<size_t, unsigned int> &arc) { return arc.second == attente; });
+        const bool arriveeTrouvee = any_of(requeteVersStation.arcs.versDestination.begin(),
+                                           requeteVersStation.arcs.versDestination.end(),
+                                           [](const pair<size_t, unsigned int> &arc) { return arc.second == 0; });
+        if (!departTrouve || !arriveeTrouvee)
+            throw logic_error("main(): une station confondue avec le point d'une requête en est absente");
+        long tempsRecherche;
+        const unsigned int tempsSurStation = reseau_rtc.itineraire(donnees_rtc, requeteSurStation, false, tempsRecherche);
+        if (cache.itineraire(surStation, paires[0].second, now1).tempsDuTrajet != tempsSurStation)
+            throw logic_error("main(): le cache diffère de la requête partant d'une station");
+        cout << "Point origine sur une station: premier départ dans " << attente << " secondes, trajet de "
+             << tempsSurStation << " secondes, identique au cache" << endl;
+    }
+
+    //une mémoire pour environ 10 entrées: les moins récemment utilisées sont évincées
+    CacheItineraires petitCache(donnees_rtc, reseau_rtc, 10 * 160);
+    for (const auto &requete : requetesCache)
+        petitCache.itineraire(paires[requete.first].first, paires[requete.first].second, requete.second);
+    cout << "Cache limité à " << 10 * 160 << " octets: " << petitCache.getNbSucces() << " succès, "
+         << petitCache.getNbEchecs() << " échecs, " << petitCache.getNbEntrees() << " entrées ("
+         << petitCache.getTailleMemoire() << " octets)" << endl;
+
+    //le cache d'un réseau à fenêtre glissante est vidé à chaque avance
+    ReseauGTFS reseau_fenetre(donnees_rtc, now1, now1.add_secondes(3600));
+    const unsigned int pasFenetre = 300;
+    CacheItineraires cacheFenetre(donnees_rtc, reseau_fenetre, 1 << 20);
+    cacheFenetre.itineraire(paires[0].first, paires[0].second, reseau_fenetre.getDebutFenetre());
+    const size_t nbEntreesAvant = cacheFenetre.getNbEntrees();
+    reseau_fenetre.avancerFenetre(donnees_rtc, pasFenetre);
+    cacheFenetre.itineraire(paires[0].first, paires[0].second, reseau_fenetre.getDebutFenetre());
+    cacheFenetre.itineraire(paires[0].first, paires[0].second, reseau_fenetre.getDebutFenetre());
+    cout << "Fenêtre glissante: " << nbEntreesAvant << " entrée avant l'avance, " << cacheFenetre.getNbEntrees()
+         << " après (" << cacheFenetre.getNbEchecs() << " échecs, " << cacheFenetre.getNbSucces() << " succès)" << endl;
+}
+
+//! \brief les mêmes requêtes guidées par 4, 8 et 16 repères ALT
+static void comparerReperesALT(Simulation &p_simulation)
+{
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   repères ALT " << endl;
+    cout << "==========================================" << endl << endl;
+
+    const size_t nbPairesReperes = min<size_t>(200, paires.size());
+    vector<ReseauGTFS::Requete> requetesReperes;
+    vector<unsigned int> tempsSansReperes;
+    long tempsRechercheSansReperes = 0;
+    size_t nbSolutionnesSansReperes = 0;
+    for (size_t i = 0; i < nbPairesReperes; ++i)
+    {
+        long tempsRecherche;
+        requetesReperes.push_back(reseau_rtc.preparerRequete(paires[i].first, paires[i].second));
+        tempsSansReperes.push_back(reseau_rtc.itineraire(donnees_rtc, requetesReperes.back(), false, tempsRecherche));
+        tempsRechercheSansReperes += tempsRecherche;
+        nbSolutionnesSansReperes += reseau_rtc.getNbSommetsSolutionnes(requetesReperes.back());
+    }
+    cout << "Sans repères: " << double(tempsRechercheSansReperes) / nbPairesReperes << " microsecondes et "
+         << nbSolutionnesSansReperes / nbPairesReperes << " sommets solutionnés par requête" << endl;
+
+    for (size_t nbReperes : {4, 8, 16})
+    {
+        auto debutReperes = chrono::steady_clock::now();
+        reseau_rtc.construireReperes(donnees_rtc, nbReperes);
+        auto finReperes = chrono::steady_clock::now();
+        long tempsRechercheAvecReperes = 0;
+        size_t nbSolutionnesAvecReperes = 0;
+        unsigned int nbReperesIdentiques = 0;
+        for (size_t i = 0; i < nbPairesReperes; ++i)
+        {
+            long tempsRecherche;
+            if (reseau_rtc.itineraire(donnees_rtc, requetesReperes[i], false, tempsRecherche) == tempsSansReperes[i])
+                ++nbReperesIdentiques;
+            tempsRechercheAvecReperes += tempsRecherche;
+            nbSolutionnesAvecReperes += reseau_rtc.getNbSommetsSolutionnes(requetesReperes[i]);
+        }
+        cout << nbReperes << " repères: précalcul en " << chrono::duration<double, milli>(finReperes - debutReperes).count()
+             << " millisecondes, " << reseau_rtc.getTailleMemoireReperes() << " octets; "
+             << double(tempsRechercheAvecReperes) / nbPairesReperes << " microsecondes et "
+             << nbSolutionnesAvecReperes / nbPairesReperes << " sommets solutionnés par requête (réduction de "
+             << 100.0 * (1.0 - double(nbSolutionnesAvecReperes) / nbSolutionnesSansReperes) << " %), "
+             << nbReperesIdentiques << "/" << nbPairesReperes << " temps de trajet identiques" << endl;
+        exigerIdentiques(nbReperesIdentiques, nbPairesReperes, to_string(nbReperes) + " repères ALT contre Dijkstra");
+    }
+    reseau_rtc.abandonnerReperes();
+}
+
+//! \brief les stations à distance de marche trouvées de quatre façons
+static void comparerDistancesEnLot(Simulation &p_simulation)
+{
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const auto &stations = p_simulation.donnees.getStations();
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   distances en lot " << endl;
+    cout << "==========================================" << endl << endl;
+
+    //les stations à distance de marche de chaque point des paires, de quatre façons
+    vector<Coordonnees> pointsLot;
+    for (const auto &paire : paires)
+    {
+        pointsLot.push_back(paire.first);
+        pointsLot.push_back(paire.second);
+    }
+    const double rayonLot = reseau_rtc.getDistMaxMarche();
+    DistancesStations distancesStations(stations);
+    IndexStations indexLot(stations, rayonLot / 2);
+    size_t nbTrouvees = 0;
+
+    auto debutLot = chrono::steady_clock::now();
+    vector<vector<const DistancesStations::EntreeStation *> > parAcos(pointsLot.size());
+    for (size_t i = 0; i < pointsLot.size(); ++i)
+        for (const auto &station : stations)
+        {
+            double distance = pointsLot[i] - station.second.getCoords();
+            if (std::isnan(distance) || distance <= rayonLot) parAcos[i].push_back(&station);
+        }
+    auto finAcos = chrono::steady_clock::now();
+    for (const auto &point : pointsLot)
+        nbTrouvees += indexLot.dansRayon(point, rayonLot, true).size();
+    auto finGrille = chrono::steady_clock::now();
+    vector<vector<uint32_t> > parScalaire;
+    for (const auto &point : pointsLot)
+        parScalaire.push_back(distancesStations.dansRayonScalaire(point, rayonLot));
+    auto finScalaire = chrono::steady_clock::now();
+    vector<vector<uint32_t> > parLot;
+    for (const auto &point : pointsLot)
+        parLot.push_back(distancesStations.dansRayon(point, rayonLot));
+    auto finLot = chrono::steady_clock::now();
+
+    size_t nbDifferencesAcos = 0;
+    for (size_t i = 0; i < pointsLot.size(); ++i)
+    {
+        vector<const DistancesStations::EntreeStation *> trouvees;
+        for (uint32_t k : parLot[i]) trouvees.push_back(distancesStations.getStation(k));
+        if (trouvees != parAcos[i]) ++nbDifferencesAcos;
+    }
+    cout << pointsLot.size() << " points, " << distancesStations.getNbStations() << " stations, rayon de " << rayonLot
+         << " km (" << nbTrouvees / pointsLot.size() << " stations trouvées en moyenne), microsecondes par point:" << endl;
+    cout << "acos sur toutes les stations = "
+         << chrono::duration<double, micro>(finAcos - debutLot).count() / pointsLot.size()
+         << ", grille = " << chrono::duration<double, micro>(finGrille - finAcos).count() / pointsLot.size()
+         << ", produit scalaire = " << chrono::duration<double, micro>(finScalaire - finGrille).count() / pointsLot.size()
+         << ", produit scalaire en lot" << (DistancesStations::avx2Disponible() ? " (AVX2)" : " (sans AVX2)") << " = "
+         << chrono::duration<double, micro>(finLot - finScalaire).count() / pointsLot.size() << endl;
+    cout << "Résultats en lot identiques à la version scalaire: " << (parLot == parScalaire ? "oui" : "non")
+         << "; points dont les stations diffèrent de celles de acos: " << nbDifferencesAcos << "/" << pointsLot.size()
+         << endl;
+    if (parLot != parScalaire)
+        throw logic_error("main(): les distances en lot diffèrent de la version scalaire");
+    exigerIdentiques(pointsLot.size() - nbDifferencesAcos, pointsLot.size(), "distances en lot contre acos");
 }
 
+//! \brief le départ le plus tardif vérifié par des recherches vers l'avant
+static void comparerDepartLePlusTardif(Simulation &p_simulation)
+{
+    const Heure &now1 = p_simulation.depart;
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   départ le plus tardif " << endl;
+    cout << "==========================================" << endl << endl;
+
+    //arriver au plus tard une heure après now1: on vérifie avec des recherches avant partant à l'heure trouvée et
+    //une seconde plus tard
+    auto debutTranspose = chrono::steady_clock::now();
+    reseau_rtc.construireGrapheTranspose();
+    auto finTranspose = chrono::steady_clock::now();
+    const Heure arriveeLimite = now1.add_secondes(3600);
+    const size_t nbPairesTardif = min<size_t>(100, paires.size());
+    unsigned int nbAtteintATemps = 0;
+    unsigned int nbPlusTardImpossible = 0;
+    unsigned int nbDepartsTrouves = 0;
+    long tempsRebours = 0;
+    long tempsVersLAvant = 0;
+    for (size_t i = 0; i < nbPairesTardif; ++i)
+    {
+        long tempsRecherche;
+        Heure heureDepart;
+        unsigned int duree = reseau_rtc.departLePlusTardif(donnees_rtc, paires[i].first, paires[i].second, arriveeLimite,
+                                                           heureDepart, false, tempsRecherche);
+        tempsRebours += tempsRecherche;
+        if (duree == numeric_limits<unsigned int>::max()) continue;
+        ++nbDepartsTrouves;
+        if (i == 0)
+            cout << "Pour arriver à " << arriveeLimite << " de " << paires[0].first << " à " << paires[0].second
+                 << ", partir à " << heureDepart << " (trajet de " << duree << " secondes)" << endl;
+
+        ReseauGTFS::Requete requete = reseau_rtc.preparerRequete(paires[i].first, paires[i].second,
+                                                                 heureDepart);
+        unsigned int temps = reseau_rtc.itineraire(donnees_rtc, requete, false, tempsRecherche);
+        tempsVersLAvant += tempsRecherche;
+        if (temps != numeric_limits<unsigned int>::max() && heureDepart.add_secondes(temps) <= arriveeLimite)
+            ++nbAtteintATemps;
+        requete = reseau_rtc.preparerRequete(paires[i].first, paires[i].second, heureDepart.add_secondes(1));
+        temps = reseau_rtc.itineraire(donnees_rtc, requete, false, tempsRecherche);
+        if (temps == numeric_limits<unsigned int>::max() || heureDepart.add_secondes(1 + temps) > arriveeLimite)
+            ++nbPlusTardImpossible;
+    }
+    cout << "Graphe transposé construit en " << chrono::duration<double, milli>(finTranspose - debutTranspose).count()
+         << " millisecondes; " << nbDepartsTrouves << "/" << nbPairesTardif << " paires peuvent arriver à "
+         << arriveeLimite << endl;
+    cout << "Temps moyen par requête: à rebours = " << double(tempsRebours) / nbPairesTardif
+         << " microsecondes, vers l'avant (à l'heure trouvée) = " << double(tempsVersLAvant) / max(nbDepartsTrouves, 1u)
+         << " microsecondes" << endl;
+    cout << "En partant à l'heure trouvée: " << nbAtteintATemps << "/" << nbDepartsTrouves
+         << " à temps; une seconde plus tard: " << nbPlusTardImpossible << "/" << nbDepartsTrouves << " en retard" << endl;
+    exigerIdentiques(nbAtteintATemps, nbDepartsTrouves, "départ le plus tardif atteint à temps");
+    exigerIdentiques(nbPlusTardImpossible, nbDepartsTrouves, "départ une seconde plus tard en retard");
+}
+
+//! \brief les mêmes requêtes sur les graphes à indices sur 32 bits et à poids sur 16 et 64 bits
+static void comparerGrapheGenerique(Simulation &p_simulation)
+{
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   graphe générique " << endl;
+    cout << "==========================================" << endl << endl;
+
+    //le graphe de reseau_rtc copié avec des indices sur 32 bits et des arcs contigus, puis aussi avec des poids sur 16 bits
+    //et sur 64 bits;
+    //les mêmes requêtes doivent donner les mêmes temps de trajet (ajouterArc() refuse un poids non représentable)
+    const Graphe &grapheListes = reseau_rtc.getGraphe();
+    GrapheIndices32 graphe32(grapheListes.getNbSommets());
+    GrapheIndices32Poids16 graphe16(grapheListes.getNbSommets());
+    GrapheIndices32Poids64 graphe64(grapheListes.getNbSommets()); //en microsecondes: dépasse unsigned int après 71 minutes
+    const unsigned long long microsParSeconde = 1000000;
+    for (size_t i = 0; i < grapheListes.getNbSommets(); ++i)
+        for (const auto &arc : grapheListes.getArcs(i))
+        {
+            graphe32.ajouterArc(i, arc.first, arc.second);
+            graphe16.ajouterArc(i, arc.first, arc.second);
+            graphe64.ajouterArc(i, arc.first, arc.second * microsParSeconde);
+        }
+    const size_t nbPairesGenerique = min<size_t>(200, paires.size());
+    Graphe::EtatRecherche etatListes;
+    GrapheIndices32::EtatRecherche etat32;
+    GrapheIndices32Poids16::EtatRecherche etat16;
+    GrapheIndices32Poids64::EtatRecherche etat64;
+    vector<size_t> cheminListes;
+    vector<uint32_t> chemin32;
+    double tempsGrapheListes = 0, temps32 = 0, temps16 = 0, temps64 = 0;
+    unsigned int nbGeneriquesIdentiques = 0;
+    for (size_t i = 0; i < nbPairesGenerique; ++i)
+    {
+        ReseauGTFS::Requete requete = reseau_rtc.preparerRequete(paires[i].first, paires[i].second);
+        const GrapheIndices32::ArcsVirtuels arcs32(requete.arcs);
+        const GrapheIndices32Poids16::ArcsVirtuels arcs16(requete.arcs); //conversion vérifiée des poids
+        GrapheIndices32Poids64::ArcsVirtuels arcs64;
+        for (const auto &arc : requete.arcs.depuisOrigine)
+            arcs64.depuisOrigine.push_back({static_cast<uint32_t>(arc.first), arc.second * microsParSeconde});
+        for (const auto &arc : requete.arcs.versDestination)
+            arcs64.versDestination.push_back({static_cast<uint32_t>(arc.first), arc.second * microsParSeconde});
+
+        auto t0 = chrono::steady_clock::now();
+        unsigned int dureeListes = grapheListes.plusCourtChemin(requete.arcs, cheminListes, etatListes);
+        auto t1 = chrono::steady_clock::now();
+        unsigned int duree32 = graphe32.plusCourtChemin(arcs32, chemin32, etat32);
+        auto t2 = chrono::steady_clock::now();
+        uint16_t duree16 = graphe16.plusCourtChemin(arcs16, chemin32, etat16);
+        auto t3 = chrono::steady_clock::now();
+        uint64_t duree64 = graphe64.plusCourtChemin(arcs64, chemin32, etat64);
+        auto t4 = chrono::steady_clock::now();
+        tempsGrapheListes += chrono::duration<double, micro>(t1 - t0).count();
+        temps32 += chrono::duration<double, micro>(t2 - t1).count();
+        temps16 += chrono::duration<double, micro>(t3 - t2).count();
+        temps64 += chrono::duration<double, micro>(t4 - t3).count();
+        const bool inatteignable64 = duree64 == numeric_limits<uint64_t>::max();
+        if (inatteignable64 ? dureeListes != numeric_limits<unsigned int>::max() : duree64 != dureeListes * microsParSeconde)
+            throw logic_error("main(): le graphe à poids sur 64 bits diffère du graphe de listes");
+
+        const bool inatteignable16 = duree16 == numeric_limits<uint16_t>::max();
+        if (duree32 == dureeListes && (inatteignable16 ? dureeListes == numeric_limits<unsigned int>::max()
+                                                        : duree16 == dureeListes))
+            ++nbGeneriquesIdentiques;
+    }
+    cout << "Mémoire: listes (size_t, unsigned int) = " << grapheListes.getTailleMemoire()
+         << " octets, vecteurs (uint32_t, unsigned int) = " << graphe32.getTailleMemoire()
+         << " octets, vecteurs (uint32_t, uint16_t) = " << graphe16.getTailleMemoire()
+         << " octets, vecteurs (uint32_t, uint64_t) = " << graphe64.getTailleMemoire() << " octets" << endl;
+    cout << "Temps moyen par requête: listes = " << tempsGrapheListes / nbPairesGenerique << " microsecondes, indices 32 bits = "
+         << temps32 / nbPairesGenerique << " microsecondes, poids 16 bits = " << temps16 / nbPairesGenerique
+         << " microsecondes, poids 64 bits = " << temps64 / nbPairesGenerique << " microsecondes; " << nbGeneriquesIdentiques << "/" << nbPairesGenerique << " temps de trajet identiques" << endl;
+    exigerIdentiques(nbGeneriquesIdentiques, nbPairesGenerique, "graphes à indices sur 32 bits et à poids sur 16 bits");
+}
+
+//! \brief les mêmes requêtes avant et après la construction de la hiérarchie de contraction
+static void comparerHierarchieContraction(Simulation &p_simulation)
+{
+    DonneesGTFS &donnees_rtc = p_simulation.donnees;
+    ReseauGTFS &reseau_rtc = p_simulation.reseau;
+    const vector<pair<Coordonnees, Coordonnees> > &paires = p_simulation.paires;
+    clock_t begin, end;
+
+    cout << endl << "==========================================" << endl;
+    cout << "   hiérarchie de contraction " << endl;
+    cout << "==========================================" << endl << endl;
 
+    //en dernier: une fois la hiérarchie construite, reseau_rtc.itineraire() l'utilise
+    const size_t nbPairesHierarchie = min<size_t>(200, paires.size());
+    vector<ReseauGTFS::Requete> requetesHierarchie;
+    vector<unsigned int> tempsDijkstra;
+    long tempsAvant = 0;
+    for (size_t i = 0; i < nbPairesHierarchie; ++i)
+    {
+        long tempsRecherche;
+        requetesHierarchie.push_back(reseau_rtc.preparerRequete(paires[i].first, paires[i].second));
+        tempsDijkstra.push_back(reseau_rtc.itineraire(donnees_rtc, requetesHierarchie.back(), false, tempsRecherche));
+        tempsAvant += tempsRecherche;
+    }
+
+    begin = clock();
+    reseau_rtc.construireHierarchieContraction();
+    end = clock();
+    cout << "Hiérarchie construite en " << double(end - begin) / CLOCKS_PER_SEC << " secondes: "
+         << reseau_rtc.getNbRaccourcis() << " raccourcis pour " << reseau_rtc.getNbArcs() << " arcs, mémoire totale = "
+         << reseau_rtc.getTailleMemoire() << " octets" << endl;
+
+    unsigned int nbIdentiquesHierarchie = 0;
+    long tempsApres = 0;
+    for (size_t i = 0; i < nbPairesHierarchie; ++i)
+    {
+        long tempsRecherche;
+        if (reseau_rtc.itineraire(donnees_rtc, requetesHierarchie[i], false, tempsRecherche) == tempsDijkstra[i])
+            ++nbIdentiquesHierarchie;
+        tempsApres += tempsRecherche;
+    }
+    cout << nbPairesHierarchie << " requêtes: Dijkstra = " << double(tempsAvant) / nbPairesHierarchie
+         << " microsecondes, hiérarchie = " << double(tempsApres) / nbPairesHierarchie << " microsecondes (accélération "
+         << (tempsApres ? double(tempsAvant) / tempsApres : 0) << "), " << nbIdentiquesHierarchie << " temps de trajet identiques"
+         << endl;
+    exigerIdentiques(nbIdentiquesHierarchie, nbPairesHierarchie, "hiérarchie de contraction contre Dijkstra");
+}
+
+int main()
+{
+    const std::string chemin_dossier = "../RTC-1aout-25nov";
+    Date today(2022, 8, 3);
+    Heure now1(7, 30, 0);
+//  Date today; //Le constructeur par défaut initialise la date à aujourd'hui
+//  Heure now1; //Le constructeur par défaut initialise l'heure à maintenant
+    Heure now2 = now1.add_secondes(72000); //on désire obtenir tous les arrêts du reste de la journée
+
+    clock_t begin = clock();
+    DonneesGTFS donnees_rtc(today, now1, now2);
+    donnees_rtc.ajouterLignes(chemin_dossier + "/routes.txt");
+    cout << "Nombre de lignes = " << donnees_rtc.getNbLignes() << endl;
+    donnees_rtc.ajouterStations(chemin_dossier + "/stops.txt");
+    cout << "Nombre de stations initiales = " << donnees_rtc.getNbStations() << endl;
+    donnees_rtc.ajouterServices(chemin_dossier + "/calendar_dates.txt");
+    size_t nb_services = donnees_rtc.getNbServices();
+    cout << "Nombre de services = " << nb_services << endl;
+    if (nb_services == 0) throw logic_error("main(): On doit avoir nb_services > 0 pour continuer");
+    donnees_rtc.ajouterVoyagesDeLaDate(chemin_dossier + "/trips.txt");
+    donnees_rtc.ajouterArretsDesVoyagesDeLaDate(chemin_dossier + "/stop_times.txt");
+    donnees_rtc.ajouterTransferts(chemin_dossier + "/transfers.txt");
+    clock_t end = clock();
+    cout << "Chargement des données effectué en " << double(end - begin) / CLOCKS_PER_SEC << " secondes" << endl;
+    cout << "Nombre de stations ayant au moins 1 arrêt = " << donnees_rtc.getNbStations() << endl;
+    cout << "Nombre de transferts = " << donnees_rtc.getNbTransferts() << endl;
+    cout << "Nombres de voyages = " << donnees_rtc.getNbVoyages() << endl;
+    cout << "Nombre d'arrêts = " << donnees_rtc.getNbArrets() << endl;
+    begin = clock();
+    ReseauGTFS reseau_rtc(donnees_rtc);
+    end = clock();
+    cout << "Le nombre d'arcs (sans le point origine et destination) est = " << reseau_rtc.getNbArcs() << endl;
+    cout << "Graphe (sans le point source et destination) a été produit en " << double(end - begin) / CLOCKS_PER_SEC
+         << " secondes" << endl << endl;
+
+    Simulation simulation{chemin_dossier, today, now1, now2, donnees_rtc, reseau_rtc};
+    simulerRequetes(simulation);
+    comparerTraitementEnLot(simulation);
+    comparerMatrice(simulation);
+    calculerIsochrone(simulation);
+    comparerCSA(simulation);
+    comparerRAPTOR(simulation);
+    comparerProfil(simulation);
+    comparerHeureDeDepart(simulation);
+    comparerConstructionParallele(simulation);
+    comparerReseauProjete(simulation);
+    comparerRenumerotation(simulation);
+    comparerGrapheCompact(simulation);
+    comparerElagage(simulation);
+    comparerIndexStations(simulation);
+    comparerTransfertsAPied(simulation);
+    calculerItinerairesAlternatifs(simulation);
+    comparerMultiCriteres(simulation);
+    comparerFenetreGlissante(simulation);
+    comparerCache(simulation);
+    comparerReperesALT(simulation);
+    comparerDistancesEnLot(simulation);
+    comparerDepartLePlusTardif(simulation);
+    comparerGrapheGenerique(simulation);
+    comparerHierarchieContraction(simulation);
+
+    return 0;
+}
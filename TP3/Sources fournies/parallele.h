@@ -0,0 +1,76 @@
+//
+// Mesure du temps d'exécution et répartition de tâches entre plusieurs fils d'exécution
+//
+
+#ifndef TP2_PARALLELE_H
+#define TP2_PARALLELE_H
+
+#include "graphe.h"
+#include <sys/time.h>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <vector>
+#include <algorithm>
+
+long tempsExecution(const timeval &tv1, const timeval &tv2); //défini dans ReseauGTFS.cpp
+
+//! \brief exécute p_tache(i, etat) pour chaque i de [0, p_nbTaches) en répartissant les tâches entre p_nbFils fils d'exécution
+//! \brief chaque fil prend la prochaine tâche non traitée et possède son propre Etat, construit par défaut et réutilisé
+//! \brief d'une tâche à l'autre
+//! \param[in] p_nbFils: le nombre de fils d'exécution (0 pour utiliser thread::hardware_concurrency())
+//! \throws l'exception du premier fil fautif est relancée une fois tous les fils terminés
+template<typename Etat>
+void executerEnParalleleAvecEtat(size_t p_nbTaches, unsigned int p_nbFils,
+                                 const std::function<void(size_t, Etat &)> &p_tache)
+{
+    if (p_nbFils == 0) p_nbFils = std::thread::hardware_concurrency();
+    if (p_nbFils == 0) p_nbFils = 1;
+    if (p_nbFils > p_nbTaches) p_nbFils = static_cast<unsigned int>(std::max<size_t>(p_nbTaches, 1));
+
+    std::atomic<size_t> prochaineTache(0);
+    std::atomic<bool> erreurSurvenue(false);
+    std::exception_ptr erreur;
+
+    auto travailleur = [&]()
+    {
+        Etat etat;
+        try
+        {
+            for (size_t i = prochaineTache++; i < p_nbTaches && !erreurSurvenue; i = prochaineTache++)
+                p_tache(i, etat);
+        }
+        catch (...)
+        {
+            if (!erreurSurvenue.exchange(true)) erreur = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> fils;
+    for (unsigned int f = 1; f < p_nbFils; ++f)
+        fils.emplace_back(travailleur);
+    travailleur(); //le fil appelant participe aussi
+    for (auto &f : fils)
+        f.join();
+
+    if (erreur) std::rethrow_exception(erreur);
+}
+
+//! \brief executerEnParalleleAvecEtat() avec un état de recherche de Graphe par fil, pour les boucles de recherches
+inline void executerEnParallele(size_t p_nbTaches, unsigned int p_nbFils,
+                                const std::function<void(size_t, Graphe::EtatRecherche &)> &p_tache)
+{
+    executerEnParalleleAvecEtat<Graphe::EtatRecherche>(p_nbTaches, p_nbFils, p_tache);
+}
+
+//! \brief executerEnParallele() pour des tâches sans recherche (construction, préparation): aucun état par fil
+inline void executerEnParallele(size_t p_nbTaches, unsigned int p_nbFils, const std::function<void(size_t)> &p_tache)
+{
+    struct SansEtat
+    {
+    };
+    executerEnParalleleAvecEtat<SansEtat>(p_nbTaches, p_nbFils, [&](size_t i, SansEtat &) { p_tache(i); });
+}
+
+#endif //TP2_PARALLELE_H
@@ -0,0 +1,282 @@
+//
+//  reperesALT.cpp
+//  Repères (landmarks) ALT: bornes inférieures par l'inégalité du triangle, pour guider (A*) les recherches d'un Graphe
+//
+
+#include "reperesALT.h"
+#include "parallele.h"
+#include <stdexcept>
+
+using namespace std;
+
+const uint32_t ReperesALT::aucune;
+const unsigned int ReperesALT::infini;
+
+//! \brief précalcule les distances du graphe quotient vers et depuis chaque repère
+//! \param[in] p_graphe: le graphe; il ne doit plus changer tant que les repères servent
+//! \param[in] p_classeDuSommet: la classe de chaque sommet, dans [0, nombre de classes), ou ReperesALT::aucune
+//! \param[in] p_reperes: les classes choisies comme repères
+//! \param[in] p_nbFils: le nombre de fils d'exécution (0 pour utiliser thread::hardware_concurrency()); chacun calcule
+//! \param[in] les distances vers ou depuis un repère à la fois
+//! \throws logic_error si p_classeDuSommet n'a pas un élément par sommet ou si un repère n'est pas une classe
+ReperesALT::ReperesALT(const Graphe &p_graphe, const vector<uint32_t> &p_classeDuSommet, const vector<uint32_t> &p_reperes,
+                       unsigned int p_nbFils)
+        : m_nbSommets(p_graphe.getNbSommets()), m_nbClasses(0), m_nbReperes(p_reperes.size()),
+          m_classeDuSommet(p_classeDuSommet)
+{
+    if (m_classeDuSommet.size() != m_nbSommets)
+        throw logic_error("ReperesALT: il faut une classe par sommet du graphe");
+    for (uint32_t c : m_classeDuSommet)
+        if (c != aucune) m_nbClasses = max<size_t>(m_nbClasses, c + 1);
+    for (uint32_t r : p_reperes)
+        if (r >= m_nbClasses) throw logic_error("ReperesALT: un repère n'est la classe d'aucun sommet");
+
+    //arcs du graphe quotient, en gardant le plus petit poids de chaque paire de classes
+    vector<pair<pair<uint32_t, uint32_t>, unsigned int> > arcs;
+    for (size_t u = 0; u < m_nbSommets; ++u)
+    {
+        const uint32_t a = m_classeDuSommet[u];
+        if (a == aucune) continue;
+        for (const auto &arc : p_graphe.m_listesAdj[u])
+        {
+            const uint32_t b = m_classeDuSommet[arc.destination];
+            if (b != aucune && b != a) arcs.push_back({{a, b}, arc.poids});
+        }
+    }
+    sort(arcs.begin(), arcs.end());
+    arcs.erase(unique(arcs.begin(), arcs.end(),
+                      [](const pair<pair<uint32_t, uint32_t>, unsigned int> &x,
+                         const pair<pair<uint32_t, uint32_t>, unsigned int> &y)
+                      {
+                          return x.first == y.first;
+                      }), arcs.end());
+
+    //listes d'adjacence (format CSR) du graphe quotient et de son transposé
+    vector<uint32_t> debutAvant(m_nbClasses + 1, 0);
+    vector<uint32_t> debutArriere(m_nbClasses + 1, 0);
+    for (const auto &arc : arcs)
+    {
+        ++debutAvant[arc.first.first + 1];
+        ++debutArriere[arc.first.second + 1];
+    }
+    for (size_t c = 0; c < m_nbClasses; ++c)
+    {
+        debutAvant[c + 1] += debutAvant[c];
+        debutArriere[c + 1] += debutArriere[c];
+    }
+    vector<pair<uint32_t, unsigned int> > arcsAvant(arcs.size());
+    vector<pair<uint32_t, unsigned int> > arcsArriere(arcs.size());
+    {
+        vector<uint32_t> prochainAvant(debutAvant.begin(), debutAvant.end() - 1);
+        vector<uint32_t> prochainArriere(debutArriere.begin(), debutArriere.end() - 1);
+        for (const auto &arc : arcs)
+        {
+            arcsAvant[prochainAvant[arc.first.first]++] = {arc.first.second, arc.second};
+            arcsArriere[prochainArriere[arc.first.second]++] = {arc.first.first, arc.second};
+        }
+    }
+
+    //tâche 2r: distances depuis le repère r (graphe quotient); tâche 2r + 1: distances vers r (graphe transposé)
+    m_versRepere.assign(m_nbClasses * m_nbReperes, infini);
+    m_depuisRepere.assign(m_nbClasses * m_nbReperes, infini);
+    executerEnParallele(2 * m_nbReperes, p_nbFils, [&](size_t t)
+    {
+        if (t % 2 == 0)
+            dijkstraQuotient(debutAvant, arcsAvant, p_reperes[t / 2], t / 2, m_nbReperes, m_depuisRepere);
+        else
+            dijkstraQuotient(debutArriere, arcsArriere, p_reperes[t / 2], t / 2, m_nbReperes, m_versRepere);
+    });
+}
+
+//! \brief distances de p_source à chaque classe, écrites dans la colonne p_colonne de p_distances
+void ReperesALT::dijkstraQuotient(const vector<uint32_t> &p_debut, const vector<pair<uint32_t, unsigned int> > &p_arcs,
+                                  uint32_t p_source, size_t p_colonne, size_t p_nbColonnes, vector<unsigned int> &p_distances)
+{
+    typedef pair<unsigned int, uint32_t> Entree; //(distance, classe)
+    priority_queue<Entree, vector<Entree>, greater<Entree> > q;
+    p_distances[p_source * p_nbColonnes + p_colonne] = 0;
+    q.push(Entree(0, p_source));
+    while (!q.empty())
+    {
+        Entree e = q.top();
+        q.pop();
+        if (e.first > p_distances[e.second * p_nbColonnes + p_colonne]) continue;
+        for (uint32_t k = p_debut[e.second]; k < p_debut[e.second + 1]; ++k)
+        {
+            unsigned int &d = p_distances[p_arcs[k].first * p_nbColonnes + p_colonne];
+            if (e.first + p_arcs[k].second < d)
+            {
+                d = e.first + p_arcs[k].second;
+                q.push(Entree(d, p_arcs[k].first));
+            }
+        }
+    }
+}
+
+unsigned int ReperesALT::plusCourtChemin(const Graphe &p_graphe, const Graphe::ArcsVirtuels &p_arcs,
+                                         vector<size_t> &p_chemin) const
+{
+    EtatRecherche etat;
+    return plusCourtChemin(p_graphe, p_arcs, p_chemin, etat);
+}
+
+//! \brief Trouve le plus court chemin de l'origine virtuelle à la destination virtuelle par A*, guidé par les repères
+//! \brief La borne d'un sommet vers la destination est le maximum, sur les repères r, de d(c, r) - d(cible, r) et de
+//! \brief d(r, cible) - d(r, c), où c est la classe du sommet et cible regroupe les arcs vers la destination virtuelle
+//! \param[in] p_graphe: le graphe ayant servi à construire les repères
+//! \param[in,out] p_etat: l'état de recherche du fil d'exécution appelant; il ne doit pas être partagé entre fils d'exécution
+//! \return la même distance que Graphe::plusCourtChemin(p_arcs, p_chemin)
+//! \throws logic_error si le graphe a changé de taille depuis la construction des repères, ou si un arc virtuel est invalide
+unsigned int ReperesALT::plusCourtChemin(const Graphe &p_graphe, const Graphe::ArcsVirtuels &p_arcs,
+                                         vector<size_t> &p_chemin, EtatRecherche &p_etat) const
+{
+    if (p_graphe.getNbSommets() != m_nbSommets)
+        throw logic_error("ReperesALT::plusCourtChemin(): le graphe a changé depuis la construction des repères");
+    const size_t origine = m_nbSommets;
+    const size_t destination = m_nbSommets + 1;
+
+    //remettre à zéro uniquement ce que la requête précédente a touché
+    if (p_etat.distance.size() != m_nbSommets + 2 || p_etat.borne.size() != m_nbClasses)
+    {
+        p_etat.distance.assign(m_nbSommets + 2, infini);
+        p_etat.predecesseur.assign(m_nbSommets + 2, numeric_limits<size_t>::max());
+        p_etat.poidsVersDestination.assign(m_nbSommets, infini);
+        p_etat.borne.assign(m_nbClasses, infini);
+    }
+    else
+    {
+        for (size_t s : p_etat.sommetsModifies)
+        {
+            p_etat.distance[s] = infini;
+            p_etat.predecesseur[s] = numeric_limits<size_t>::max();
+        }
+        for (size_t s : p_etat.sommetsVersDestination)
+            p_etat.poidsVersDestination[s] = infini;
+        for (uint32_t c : p_etat.classesBornees)
+            p_etat.borne[c] = infini;
+    }
+    p_etat.sommetsModifies.clear();
+    p_etat.sommetsVersDestination.clear();
+    p_etat.classesBornees.clear();
+    p_etat.nbSommetsSolutionnes = 0;
+    p_chemin.clear();
+
+    vector<unsigned int> &distance = p_etat.distance;
+    vector<size_t> &predecesseur = p_etat.predecesseur;
+    vector<unsigned int> &poidsVersDestination = p_etat.poidsVersDestination;
+
+    //par repère: max sur les cibles de d(cible, r) - poids, et min sur les cibles de d(r, cible) + poids
+    //une cible sans classe, ou qui n'atteint pas r, rend la borne correspondante inutilisable
+    vector<long long> versCible(m_nbReperes, numeric_limits<long long>::min());
+    vector<long long> depuisCible(m_nbReperes, numeric_limits<long long>::max());
+    vector<bool> versCibleValide(m_nbReperes, true);
+    bool cibleSansClasse = false;
+    for (const auto &arc : p_arcs.versDestination)
+    {
+        if (arc.first >= m_nbSommets)
+            throw logic_error("ReperesALT::plusCourtChemin(): un arc vers la destination part d'un sommet inexistant");
+        if (poidsVersDestination[arc.first] == infini) p_etat.sommetsVersDestination.push_back(arc.first);
+        poidsVersDestination[arc.first] = min(poidsVersDestination[arc.first], arc.second);
+
+        const uint32_t c = m_classeDuSommet[arc.first];
+        if (c == aucune)
+        {
+            cibleSansClasse = true;
+            continue;
+        }
+        for (size_t r = 0; r < m_nbReperes; ++r)
+        {
+            const unsigned int vers = m_versRepere[c * m_nbReperes + r];
+            if (vers == infini) versCibleValide[r] = false;
+            else versCible[r] = max(versCible[r], (long long) vers - arc.second);
+            const unsigned int depuis = m_depuisRepere[c * m_nbReperes + r];
+            if (depuis != infini) depuisCible[r] = min(depuisCible[r], (long long) depuis + arc.second);
+        }
+    }
+
+    auto borne = [&](size_t v) -> unsigned int
+    {
+        if (v >= m_nbSommets || cibleSansClasse) return 0;
+        const uint32_t c = m_classeDuSommet[v];
+        if (c == aucune) return 0;
+        if (p_etat.borne[c] != infini) return p_etat.borne[c];
+        long long h = 0;
+        for (size_t r = 0; r < m_nbReperes; ++r)
+        {
+            const unsigned int vers = m_versRepere[c * m_nbReperes + r];
+            if (versCibleValide[r] && vers != infini) h = max(h, (long long) vers - versCible[r]);
+            const unsigned int depuis = m_depuisRepere[c * m_nbReperes + r];
+            if (depuisCible[r] != numeric_limits<long long>::max() && depuis != infini)
+                h = max(h, depuisCible[r] - depuis);
+        }
+        p_etat.borne[c] = static_cast<unsigned int>(min<long long>(h, infini - 1));
+        p_etat.classesBornees.push_back(c);
+        return p_etat.borne[c];
+    };
+
+    typedef pair<unsigned long long, size_t> Entree; //(distance + borne, sommet)
+    priority_queue<Entree, vector<Entree>, greater<Entree> > q;
+
+    distance[origine] = 0;
+    p_etat.sommetsModifies.push_back(origine);
+    q.push(Entree(0, origine));
+
+    //relâche l'arc (u, v) de poids p; les bornes sont cohérentes, un sommet solutionné ne l'est donc qu'une fois
+    auto relacher = [&](size_t u, size_t v, unsigned int p)
+    {
+        if (relacherArc(p_etat, u, v, p)) q.push(Entree((unsigned long long) distance[v] + borne(v), v));
+    };
+
+    while (!q.empty())
+    {
+        Entree e = q.top();
+        q.pop();
+        size_t u = e.second;
+        if (e.first > (unsigned long long) distance[u] + borne(u)) continue; //entrée périmée
+        ++p_etat.nbSommetsSolutionnes;
+        if (u == destination) break;
+
+        if (u == origine)
+        {
+            for (const auto &arc : p_arcs.depuisOrigine)
+            {
+                if (arc.first >= m_nbSommets)
+                    throw logic_error("ReperesALT::plusCourtChemin(): un arc de l'origine mène à un sommet inexistant");
+                relacher(u, arc.first, arc.second);
+            }
+            continue;
+        }
+
+        for (const auto &arc : p_graphe.m_listesAdj[u])
+            relacher(u, arc.destination, arc.poids);
+        if (poidsVersDestination[u] != infini)
+            relacher(u, destination, poidsVersDestination[u]);
+    }
+
+    if (distance[destination] == infini)
+    {
+        p_chemin.push_back(destination);
+        return infini;
+    }
+    for (size_t numero = destination; numero != numeric_limits<size_t>::max(); numero = predecesseur[numero])
+        p_chemin.push_back(numero);
+    reverse(p_chemin.begin(), p_chemin.end());
+    return distance[destination];
+}
+
+size_t ReperesALT::getNbReperes() const
+{
+    return m_nbReperes;
+}
+
+size_t ReperesALT::getNbClasses() const
+{
+    return m_nbClasses;
+}
+
+//! \brief retourne le nombre d'octets des distances aux repères et des classes des sommets
+size_t ReperesALT::getTailleMemoire() const
+{
+    return (m_versRepere.capacity() + m_depuisRepere.capacity()) * sizeof(unsigned int)
+           + m_classeDuSommet.capacity() * sizeof(uint32_t);
+}
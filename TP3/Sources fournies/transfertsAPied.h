@@ -0,0 +1,20 @@
+//
+// Transferts à pied générés entre les stations proches, en complément des transferts de transfers.txt
+//
+
+#ifndef TP2_TRANSFERTSAPIED_H
+#define TP2_TRANSFERTSAPIED_H
+
+#include "DonneesGTFS.h"
+#include <string>
+#include <tuple>
+#include <vector>
+
+//! \brief transferts (station de départ, station d'arrivée, durée en secondes), au format de DonneesGTFS::getTransferts()
+typedef std::vector<std::tuple<std::string, std::string, unsigned int> > Transferts;
+
+Transferts genererTransfertsAPied(const DonneesGTFS &, double p_rayon, double p_vitesseDeMarche,
+                                  bool p_fermetureTransitive = false, unsigned int p_nbFils = 1,
+                                  double p_rayonFermeture = 0);
+
+#endif //TP2_TRANSFERTSAPIED_H